@@ -0,0 +1,812 @@
+/******************************************************************************/
+/* File Name:    Benchmark.cpp                                               */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Benchmark suite for the C11 Logger. Runs a matrix of        */
+/*               sync/async, producer thread count, message size, enabled/  */
+/*               disabled level and rotation-heavy settings, and reports    */
+/*               throughput plus p50/p99/p99.9/max per-call latency.        */
+/*----------------------------------------------------------------------------*/
+/* Usage:                                                                    */
+/*   logger_bench [--format json|csv] [--output FILE] [--dir DIR]            */
+/*                [--records N] [--max-threads N] [--filter TEXT]           */
+/*                [--clock system|coarse|tsc] [--quick] [--keep]            */
+/*----------------------------------------------------------------------------*/
+/* Note:                                                                     */
+/*   - allocs_per_call counts heap allocations on the producer threads      */
+/*     (global operator new hook); process_allocs_per_record counts them on */
+/*     all threads, including the writer thread, until the logger is gone. */
+/*   - rss_growth_kb is the resident set growth over a case (Linux and      */
+/*     Windows, 0 elsewhere); *_sustained cases pace the producers to      */
+/*     1M records/s in total.                                               */
+/*   - *_live cases run one Logger::Subscription that polls every 100 us; */
+/*     live_received and live_lost are the lines it read and skipped.      */
+/*   - Output is machine-readable and stable so that results of two         */
+/*     versions can be diffed directly.                                      */
+/******************************************************************************/
+
+#include "Logger.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <windows.h>
+#include <psapi.h>
+#include <direct.h>
+#include <io.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/stat.h>
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+// 分配计数：替换全局 operator new，按线程统计，用于确认生产者每次调用的分配次数；另统计全进程的次数
+static thread_local uint64_t threadAllocations = 0;
+static std::atomic<uint64_t> processAllocations(0);
+
+void* operator new(size_t size) {
+	++threadAllocations;
+	processAllocations.fetch_add(1, std::memory_order_relaxed);
+	void* p = std::malloc(size != 0 ? size : 1);
+	if (p == nullptr) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+namespace {
+
+// 测试用例
+struct BenchCase {
+	std::string name;      // 用例名称，唯一
+	bool async;            // 是否异步
+	int threads;           // 生产者线程数
+	size_t msgSize;        // 单条消息长度
+	bool enabled;          // 日志等级是否开启
+	bool rotation;         // 是否频繁切换文件
+	bool priority;         // 另有一个线程每毫秒写一条 ERROR，统计其写入文件的延迟
+	bool durable;          // 每条日志落盘（Durability::SYNC，组提交）
+	uint64_t rate;         // 所有生产者合计每秒日志条数，0 表示不限速
+	bool context;          // 输出线程 ID、线程名和两个上下文字段
+	bool timer;            // 不写日志，每次调用用 ScopedTimer 记录一个延迟样本
+	bool span;             // 不写日志，每次调用记录一个追踪区间（Span）
+	bool sharded;          // 每个线程写自己的分片文件（setSharded）
+	int args;              // 消息参数：0 原样消息；1 snprintf 格式化；2 {} 格式化；3 kv 结构化字段（均为相同的三个值）
+	bool json;             // JSON Lines 布局
+	size_t batch;          // 每个 LogBatch 的条数，0 表示逐条调用
+	bool live;             // 另有一个线程通过 Subscription 实时读取，统计收到和丢失的条数
+	uint64_t records;      // 总日志条数
+};
+
+// 测试结果
+struct BenchResult {
+	BenchCase benchCase;
+	double seconds;        // 生产者耗时
+	double drainSeconds;   // 析构（写完剩余日志）耗时
+	double throughput;     // 每秒日志条数（生产者视角）
+	double bytesPerSecond; // 每秒消息字节数（含写完剩余日志）
+	uint64_t p50;          // 单次调用延迟，单位ns
+	uint64_t p99;
+	uint64_t p999;
+	uint64_t max;
+	double allocsPerCall;  // 生产者每次调用的堆分配次数
+	double processAllocsPerRecord;// 全进程（含写日志线程）每条日志的堆分配次数
+	int64_t rssGrowthKB;   // 用例前后常驻内存增长，单位KB
+	uint64_t priorityP99;  // ERROR 从产生到写入文件的延迟，单位ns，仅 priority 用例
+	uint64_t priorityMax;
+	uint64_t liveReceived; // 订阅线程收到的条数，仅 live 用例
+	uint64_t liveLost;     // 订阅线程因读取过慢丢失的条数
+};
+
+// 命令行参数
+struct BenchOptions {
+	std::string format = "json";
+	std::string output;
+	std::string dir = "bench_logs";
+	std::string filter;
+	uint64_t records = 200000;
+	uint64_t byteBudget = 128ull * 1024 * 1024;
+	int maxThreads = 0;
+	LogClockType clock = LogClockType::SYSTEM;
+	bool keep = false;
+};
+
+uint64_t nowNanos() {
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+bool makeDir(const std::string& path) {
+#ifdef _MSC_VER
+	return _mkdir(path.c_str()) == 0 || errno == EEXIST;
+#else
+	return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+}
+
+// 删除目录下的所有文件（不递归）
+void clearDir(const std::string& path) {
+#ifdef _MSC_VER
+	struct _finddata_t fileInfo;
+	intptr_t handle = _findfirst((path + "\\*").c_str(), &fileInfo);
+	if (handle == -1) {
+		return;
+	}
+	do {
+		if (!(fileInfo.attrib & _A_SUBDIR)) {
+			remove((path + "\\" + fileInfo.name).c_str());
+		}
+	} while (_findnext(handle, &fileInfo) == 0);
+	_findclose(handle);
+#else
+	DIR* dir = opendir(path.c_str());
+	if (dir == nullptr) {
+		return;
+	}
+	struct dirent* entry;
+	while ((entry = readdir(dir)) != nullptr) {
+		std::string fileName = entry->d_name;
+		if (fileName != "." && fileName != "..") {
+			remove((path + "/" + fileName).c_str());
+		}
+	}
+	closedir(dir);
+#endif
+}
+
+void removeDir(const std::string& path) {
+	clearDir(path);
+#ifdef _MSC_VER
+	_rmdir(path.c_str());
+#else
+	rmdir(path.c_str());
+#endif
+}
+
+const char* clockName(LogClockType clock) {
+	switch (clock) {
+	case LogClockType::COARSE:
+		return "coarse";
+	case LogClockType::TSC:
+		return "tsc";
+	default:
+		return "system";
+	}
+}
+
+std::string caseName(const char* mode, int threads, const char* suffix) {
+	char buffer[64];
+	snprintf(buffer, sizeof(buffer), "%s_t%d_%s", mode, threads, suffix);
+	return buffer;
+}
+
+// 当前常驻内存，单位KB，不支持的平台返回 0
+int64_t residentKB() {
+#if defined(_MSC_VER)
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return static_cast<int64_t>(counters.WorkingSetSize / 1024);
+	}
+	return 0;
+#elif defined(__linux__)
+	FILE* file = fopen("/proc/self/statm", "r");
+	if (file == nullptr) {
+		return 0;
+	}
+	long long pages = 0, resident = 0;
+	if (fscanf(file, "%lld %lld", &pages, &resident) != 2) {
+		resident = 0;
+	}
+	fclose(file);
+	return resident * (sysconf(_SC_PAGESIZE) / 1024);
+#else
+	return 0;
+#endif
+}
+
+uint64_t percentile(const std::vector<uint64_t>& sorted, double p) {
+	if (sorted.empty()) {
+		return 0;
+	}
+	size_t index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+	return sorted[std::min(index, sorted.size() - 1)];
+}
+
+// 所有生产者线程就绪后同时开始
+class StartGate {
+public:
+	explicit StartGate(int count) : waiting_(count), open_(false) {}
+
+	void arriveAndWait() {
+		std::unique_lock<std::mutex> lock(mutex_);
+		if (--waiting_ == 0) {
+			open_ = true;
+			cond_.notify_all();
+			return;
+		}
+		cond_.wait(lock, [this] { return open_; });
+	}
+
+private:
+	std::mutex mutex_;
+	std::condition_variable cond_;
+	int waiting_;
+	bool open_;
+};
+
+BenchResult runCase(const BenchCase& benchCase, const BenchOptions& options) {
+	std::string folder = options.dir + "/" + benchCase.name;
+	makeDir(folder);
+	clearDir(folder);
+
+	std::string message(benchCase.msgSize, 'x');
+	Logger::LogLevel level = benchCase.enabled ? Logger::LogLevel::LOG_INFO : Logger::LogLevel::LOG_ERROR;
+	size_t maxSize = benchCase.rotation ? 64 * 1024 : 1024 * 1024 * 1024;
+	Logger* logger = new Logger(folder, level, false, benchCase.async, 1, 30, maxSize, options.clock);
+	if (benchCase.durable) {
+		logger->setDurability(Logger::LogLevel::LOG_INFO, Logger::Durability::SYNC);
+	}
+	if (benchCase.context) {
+		logger->setThreadInfo(true);
+	}
+	if (benchCase.span) {
+		logger->setTracing(true);
+	}
+	if (benchCase.sharded) {
+		logger->setSharded(true);
+	}
+	if (benchCase.priority) {
+		logger->setPriorityLane(true);
+	}
+	if (benchCase.json) {
+		logger->setLayout(Logger::Layout::JSON_LINES);
+	}
+
+	int64_t rssStart = residentKB();
+	uint64_t processAllocStart = processAllocations.load();
+	Logger::LatencyMetric& metric = logger->latency("bench.timer");
+	uint64_t perThread = benchCase.records / benchCase.threads;
+	// 限速时每个线程每写 pace 条检查一次进度，超前则等待
+	const uint64_t pace = 1000;
+	double nanosPerRecord = benchCase.rate > 0 ? 1e9 * benchCase.threads / static_cast<double>(benchCase.rate) : 0;
+	std::vector<std::vector<uint64_t> > latencies(benchCase.threads);
+	std::vector<uint64_t> allocations(benchCase.threads, 0);
+	StartGate gate(benchCase.threads + 1);
+	std::vector<std::thread> producers;
+	for (int t = 0; t < benchCase.threads; ++t) {
+		producers.push_back(std::thread([&, t]() {
+			std::vector<uint64_t>& samples = latencies[t];
+			std::unique_ptr<Logger::LogBatch> batch(benchCase.batch > 0 ? new Logger::LogBatch(*logger) : nullptr);
+			samples.reserve(static_cast<size_t>(perThread));
+			if (benchCase.context) {
+				Logger::setThreadName("producer-" + std::to_string(t));
+				Logger::pushContext("request", "3f2a9c01-7d4e");
+				Logger::pushContext("tenant", "acme");
+			}
+			gate.arriveAndWait();
+			uint64_t allocStart = threadAllocations;
+			uint64_t threadStart = nowNanos();
+			for (uint64_t i = 0; i < perThread; ++i) {
+				if (nanosPerRecord > 0 && i % pace == 0) {
+					uint64_t due = threadStart + static_cast<uint64_t>(nanosPerRecord * static_cast<double>(i));
+					uint64_t current = nowNanos();
+					if (due > current) {
+						std::this_thread::sleep_for(std::chrono::nanoseconds(due - current));
+					}
+				}
+				uint64_t begin = nowNanos();
+				if (benchCase.timer) {
+					Logger::ScopedTimer scope(metric);
+				}
+				else if (benchCase.span) {
+					Logger::Span scope(*logger, "bench.span");
+				}
+				else if (batch) {
+					batch->add(Logger::LogLevel::LOG_INFO, message);
+					if (batch->size() >= benchCase.batch) {
+						batch->commit();
+					}
+				}
+				else if (benchCase.args == 1) {
+					char text[128];
+					snprintf(text, sizeof(text), "request done user=%s latency_us=%llu ok=%d", "u-1042",
+						static_cast<unsigned long long>(i), 1);
+					logger->info(static_cast<const char*>(text));
+				}
+				else if (benchCase.args == 2) {
+					logger->info("request done user={} latency_us={} ok={}", "u-1042", i, true);
+				}
+				else if (benchCase.args == 3) {
+					logger->info("request done", kv("user", "u-1042"), kv("latency_us", i), kv("ok", true));
+				}
+				else {
+					logger->info(message);
+				}
+				samples.push_back(nowNanos() - begin);
+			}
+			batch.reset();
+			allocations[t] = threadAllocations - allocStart;
+			if (benchCase.context) {
+				Logger::popContext();
+				Logger::popContext();
+			}
+		}));
+	}
+
+	std::atomic<bool> producing(true);
+	// 订阅线程：有新日志时立即读取，没有时每 100us 轮询一次；订阅在生产者开始前创建
+	std::unique_ptr<Logger::Subscription> subscription(benchCase.live ? new Logger::Subscription(*logger) : nullptr);
+	std::atomic<bool> subscribing(true);
+	uint64_t liveReceived = 0;
+	std::thread subscriber;
+	if (subscription) {
+		subscriber = std::thread([&]() {
+			std::string line;
+			while (true) {
+				if (subscription->next(line)) {
+					++liveReceived;
+				}
+				else if (!subscribing) {
+					break;
+				}
+				else {
+					std::this_thread::sleep_for(std::chrono::microseconds(100));
+				}
+			}
+		});
+	}
+	std::thread errorProducer;
+	if (benchCase.priority) {
+		errorProducer = std::thread([&]() {
+			while (producing) {
+				logger->error("priority probe");
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		});
+	}
+
+	gate.arriveAndWait();
+	uint64_t startTime = nowNanos();
+	for (size_t t = 0; t < producers.size(); ++t) {
+		producers[t].join();
+	}
+	uint64_t produceTime = nowNanos();
+	producing = false;
+	if (errorProducer.joinable()) {
+		errorProducer.join();
+	}
+	// 写完后订阅线程取完剩余记录再结束，计入 drain_seconds 之前
+	if (subscriber.joinable()) {
+		logger->flush();
+		subscribing = false;
+		subscriber.join();
+	}
+	uint64_t liveLost = subscription ? subscription->lost() : 0;
+	subscription.reset();
+	Logger::Stats stats = logger->getStats();
+	int64_t rssProduced = residentKB();
+	delete logger;
+	uint64_t drainTime = nowNanos();
+	uint64_t processAllocs = processAllocations.load() - processAllocStart;
+
+	if (!options.keep) {
+		removeDir(folder);
+	}
+
+	std::vector<uint64_t> merged;
+	merged.reserve(static_cast<size_t>(perThread * benchCase.threads));
+	for (size_t t = 0; t < latencies.size(); ++t) {
+		merged.insert(merged.end(), latencies[t].begin(), latencies[t].end());
+	}
+	std::sort(merged.begin(), merged.end());
+
+	BenchResult result;
+	result.benchCase = benchCase;
+	result.benchCase.records = merged.size();
+	result.seconds = static_cast<double>(produceTime - startTime) / 1e9;
+	result.drainSeconds = static_cast<double>(drainTime - produceTime) / 1e9;
+	result.throughput = result.seconds > 0 ? static_cast<double>(merged.size()) / result.seconds : 0;
+	double totalSeconds = result.seconds + result.drainSeconds;
+	result.bytesPerSecond = totalSeconds > 0 ? static_cast<double>(merged.size() * benchCase.msgSize) / totalSeconds : 0;
+	result.p50 = percentile(merged, 0.50);
+	result.p99 = percentile(merged, 0.99);
+	result.p999 = percentile(merged, 0.999);
+	result.max = merged.empty() ? 0 : merged.back();
+	uint64_t totalAllocations = 0;
+	for (size_t t = 0; t < allocations.size(); ++t) {
+		totalAllocations += allocations[t];
+	}
+	result.allocsPerCall = merged.empty() ? 0 : static_cast<double>(totalAllocations) / static_cast<double>(merged.size());
+	result.processAllocsPerRecord = merged.empty() ? 0 : static_cast<double>(processAllocs) / static_cast<double>(merged.size());
+	result.rssGrowthKB = rssProduced - rssStart;
+	result.priorityP99 = benchCase.priority ? stats.priorityLatency.percentile(0.99) : 0;
+	result.priorityMax = benchCase.priority ? stats.priorityLatency.maxValue() : 0;
+	result.liveReceived = liveReceived;
+	result.liveLost = liveLost;
+	return result;
+}
+
+std::vector<BenchCase> buildCases(const BenchOptions& options) {
+	std::vector<int> threadCounts;
+	for (int t = 1; t < options.maxThreads; t *= 2) {
+		threadCounts.push_back(t);
+	}
+	threadCounts.push_back(options.maxThreads);
+
+	static const size_t sizes[] = { 16, 256, 4096, 64 * 1024 };
+	std::vector<BenchCase> cases;
+	for (int mode = 0; mode < 2; ++mode) {
+		bool async = mode == 1;
+		const char* modeName = async ? "async" : "sync";
+		for (size_t t = 0; t < threadCounts.size(); ++t) {
+			int threads = threadCounts[t];
+			// 不同消息长度
+			for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+				BenchCase c;
+				c.async = async;
+				c.threads = threads;
+				c.msgSize = sizes[s];
+				c.enabled = true;
+				c.rotation = false;
+				c.priority = false;
+				c.durable = false;
+				c.context = false;
+				c.timer = false;
+				c.span = false;
+				c.sharded = false;
+				c.args = 0;
+				c.json = false;
+				c.batch = 0;
+				c.live = false;
+				c.rate = 0;
+				c.records = std::min(options.records, options.byteBudget / sizes[s]);
+				c.name = caseName(modeName, threads, ("m" + std::to_string(sizes[s])).c_str());
+				cases.push_back(c);
+			}
+			// 日志等级关闭
+			BenchCase disabled;
+			disabled.async = async;
+			disabled.threads = threads;
+			disabled.msgSize = 16;
+			disabled.enabled = false;
+			disabled.rotation = false;
+			disabled.priority = false;
+			disabled.durable = false;
+			disabled.context = false;
+			disabled.timer = false;
+			disabled.span = false;
+			disabled.sharded = false;
+			disabled.args = 0;
+			disabled.json = false;
+			disabled.batch = 0;
+			disabled.live = false;
+			disabled.rate = 0;
+			disabled.records = options.records;
+			disabled.name = caseName(modeName, threads, "disabled");
+			cases.push_back(disabled);
+			// 线程 ID 与上下文字段（预先生成的前缀）
+			BenchCase context;
+			context.async = async;
+			context.threads = threads;
+			context.msgSize = 64;
+			context.enabled = true;
+			context.rotation = false;
+			context.priority = false;
+			context.durable = false;
+			context.context = true;
+			context.timer = false;
+			context.span = false;
+			context.sharded = false;
+			context.args = 0;
+			context.json = false;
+			context.batch = 0;
+			context.live = false;
+			context.rate = 0;
+			context.records = std::min(options.records, options.byteBudget / 128);
+			context.name = caseName(modeName, threads, "context");
+			cases.push_back(context);
+			// 延迟采样（按线程直方图）的开销
+			BenchCase timer = context;
+			timer.context = false;
+			timer.timer = true;
+			timer.records = options.records;
+			timer.name = caseName(modeName, threads, "timer");
+			cases.push_back(timer);
+			// 追踪区间的开销（含写入 .trace.json）
+			BenchCase span = timer;
+			span.timer = false;
+			span.span = true;
+			span.name = caseName(modeName, threads, "span");
+			cases.push_back(span);
+			// 三个参数：snprintf、{} 格式化与结构化字段（文本和 JSON 布局）
+			static const char* const argNames[] = { "printf", "format", "kv", "kv_json" };
+			for (int a = 0; a < 4; ++a) {
+				BenchCase args = context;
+				args.context = false;
+				args.args = a < 3 ? a + 1 : 3;
+				args.json = a == 3;
+				args.name = caseName(modeName, threads, argNames[a]);
+				cases.push_back(args);
+			}
+			// 每 1000 条一个 LogBatch 整批提交
+			BenchCase batch = context;
+			batch.context = false;
+			batch.batch = 1000;
+			batch.name = caseName(modeName, threads, "batch");
+			cases.push_back(batch);
+			// 一个订阅线程实时读取（与 m256 对比写入开销）
+			BenchCase live = context;
+			live.context = false;
+			live.msgSize = 256;
+			live.live = true;
+			live.records = std::min(options.records, options.byteBudget / 256);
+			live.name = caseName(modeName, threads, "live");
+			cases.push_back(live);
+			// 频繁切换文件
+			BenchCase rotation;
+			rotation.async = async;
+			rotation.threads = threads;
+			rotation.msgSize = 256;
+			rotation.enabled = true;
+			rotation.rotation = true;
+			rotation.priority = false;
+			rotation.durable = false;
+			rotation.context = false;
+			rotation.timer = false;
+			rotation.span = false;
+			rotation.sharded = false;
+			rotation.args = 0;
+			rotation.json = false;
+			rotation.batch = 0;
+			rotation.live = false;
+			rotation.rate = 0;
+			rotation.records = std::min(options.records, options.byteBudget / 256);
+			rotation.name = caseName(modeName, threads, "rotation");
+			cases.push_back(rotation);
+			// 普通日志大量写入时 ERROR 的写入延迟（高优先级通道）
+			if (async) {
+				BenchCase priority;
+				priority.async = true;
+				priority.threads = threads;
+				priority.msgSize = 256;
+				priority.enabled = true;
+				priority.rotation = false;
+				priority.priority = true;
+				priority.durable = false;
+				priority.context = false;
+				priority.timer = false;
+				priority.span = false;
+				priority.sharded = false;
+				priority.args = 0;
+				priority.json = false;
+				priority.batch = 0;
+				priority.live = false;
+				priority.rate = 0;
+				priority.records = std::min(options.records, options.byteBudget / 256);
+				priority.name = caseName(modeName, threads, "priority");
+				cases.push_back(priority);
+				// 持续 1M 条/秒，观察记录池下的分配次数和常驻内存
+				BenchCase sustained;
+				sustained.async = true;
+				sustained.threads = threads;
+				sustained.msgSize = 128;
+				sustained.enabled = true;
+				sustained.rotation = false;
+				sustained.priority = false;
+				sustained.durable = false;
+				sustained.context = false;
+				sustained.timer = false;
+				sustained.span = false;
+				sustained.sharded = false;
+				sustained.args = 0;
+				sustained.json = false;
+				sustained.batch = 0;
+				sustained.live = false;
+				sustained.rate = 1000000;
+				sustained.records = std::min(options.records * 5, options.byteBudget / 128);
+				sustained.name = caseName(modeName, threads, "sustained");
+				cases.push_back(sustained);
+			}
+			// 每条日志落盘，并发调用合并为一次 fdatasync
+			if (!async) {
+				BenchCase durable;
+				durable.async = false;
+				durable.threads = threads;
+				durable.msgSize = 256;
+				durable.enabled = true;
+				durable.rotation = false;
+				durable.priority = false;
+				durable.durable = true;
+				durable.context = false;
+				durable.timer = false;
+				durable.span = false;
+				durable.sharded = false;
+				durable.args = 0;
+				durable.json = false;
+				durable.batch = 0;
+				durable.live = false;
+				durable.rate = 0;
+				durable.records = std::min<uint64_t>(options.records, 20000);
+				durable.name = caseName(modeName, threads, "durable");
+				cases.push_back(durable);
+				// 每个线程写自己的分片文件，写入路径上没有共享锁
+				BenchCase sharded = rotation;
+				sharded.rotation = false;
+				sharded.sharded = true;
+				sharded.name = caseName(modeName, threads, "sharded");
+				cases.push_back(sharded);
+			}
+		}
+	}
+
+	std::vector<BenchCase> filtered;
+	for (size_t i = 0; i < cases.size(); ++i) {
+		if (options.filter.empty() || cases[i].name.find(options.filter) != std::string::npos) {
+			filtered.push_back(cases[i]);
+		}
+	}
+	return filtered;
+}
+
+void writeJson(FILE* out, const std::vector<BenchResult>& results, const BenchOptions& options) {
+	fprintf(out, "{\n  \"benchmark\": \"logger\",\n  \"version\": 1,\n");
+	fprintf(out, "  \"hardware_threads\": %u,\n", std::thread::hardware_concurrency());
+	fprintf(out, "  \"records\": %llu,\n", static_cast<unsigned long long>(options.records));
+	fprintf(out, "  \"clock\": \"%s\",\n", clockName(options.clock));
+	fprintf(out, "  \"results\": [\n");
+	for (size_t i = 0; i < results.size(); ++i) {
+		const BenchResult& r = results[i];
+		fprintf(out, "    {\"name\": \"%s\", \"mode\": \"%s\", \"threads\": %d, \"msg_size\": %zu, "
+			"\"level_enabled\": %s, \"rotation\": %s, \"records\": %llu, \"seconds\": %.6f, "
+			"\"drain_seconds\": %.6f, \"throughput\": %.1f, \"bytes_per_second\": %.1f, "
+			"\"p50_ns\": %llu, \"p99_ns\": %llu, \"p999_ns\": %llu, \"max_ns\": %llu, "
+			"\"allocs_per_call\": %.3f, \"process_allocs_per_record\": %.3f, \"rss_growth_kb\": %lld, "
+			"\"priority_p99_ns\": %llu, \"priority_max_ns\": %llu, \"live_received\": %llu, \"live_lost\": %llu}%s\n",
+			r.benchCase.name.c_str(), r.benchCase.async ? "async" : "sync", r.benchCase.threads, r.benchCase.msgSize,
+			r.benchCase.enabled ? "true" : "false", r.benchCase.rotation ? "true" : "false",
+			static_cast<unsigned long long>(r.benchCase.records), r.seconds, r.drainSeconds, r.throughput, r.bytesPerSecond,
+			static_cast<unsigned long long>(r.p50), static_cast<unsigned long long>(r.p99),
+			static_cast<unsigned long long>(r.p999), static_cast<unsigned long long>(r.max), r.allocsPerCall,
+			r.processAllocsPerRecord, static_cast<long long>(r.rssGrowthKB),
+			static_cast<unsigned long long>(r.priorityP99), static_cast<unsigned long long>(r.priorityMax),
+			static_cast<unsigned long long>(r.liveReceived), static_cast<unsigned long long>(r.liveLost),
+			i + 1 < results.size() ? "," : "");
+	}
+	fprintf(out, "  ]\n}\n");
+}
+
+void writeCsv(FILE* out, const std::vector<BenchResult>& results) {
+	fprintf(out, "name,mode,threads,msg_size,level_enabled,rotation,records,seconds,drain_seconds,"
+		"throughput,bytes_per_second,p50_ns,p99_ns,p999_ns,max_ns,allocs_per_call,process_allocs_per_record,rss_growth_kb,priority_p99_ns,priority_max_ns,"
+		"live_received,live_lost\n");
+	for (size_t i = 0; i < results.size(); ++i) {
+		const BenchResult& r = results[i];
+		fprintf(out, "%s,%s,%d,%zu,%d,%d,%llu,%.6f,%.6f,%.1f,%.1f,%llu,%llu,%llu,%llu,%.3f,%.3f,%lld,%llu,%llu,%llu,%llu\n",
+			r.benchCase.name.c_str(), r.benchCase.async ? "async" : "sync", r.benchCase.threads, r.benchCase.msgSize,
+			r.benchCase.enabled ? 1 : 0, r.benchCase.rotation ? 1 : 0,
+			static_cast<unsigned long long>(r.benchCase.records), r.seconds, r.drainSeconds, r.throughput, r.bytesPerSecond,
+			static_cast<unsigned long long>(r.p50), static_cast<unsigned long long>(r.p99),
+			static_cast<unsigned long long>(r.p999), static_cast<unsigned long long>(r.max), r.allocsPerCall,
+			r.processAllocsPerRecord, static_cast<long long>(r.rssGrowthKB),
+			static_cast<unsigned long long>(r.priorityP99), static_cast<unsigned long long>(r.priorityMax),
+			static_cast<unsigned long long>(r.liveReceived), static_cast<unsigned long long>(r.liveLost));
+	}
+}
+
+void printUsage() {
+	fprintf(stderr, "Usage: logger_bench [--format json|csv] [--output FILE] [--dir DIR]\n"
+		"                    [--records N] [--max-threads N] [--filter TEXT]\n"
+		"                    [--clock system|coarse|tsc] [--quick] [--keep]\n");
+}
+
+bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--format" && hasValue) {
+			options.format = argv[++i];
+		}
+		else if (arg == "--output" && hasValue) {
+			options.output = argv[++i];
+		}
+		else if (arg == "--dir" && hasValue) {
+			options.dir = argv[++i];
+		}
+		else if (arg == "--records" && hasValue) {
+			options.records = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (arg == "--max-threads" && hasValue) {
+			options.maxThreads = std::atoi(argv[++i]);
+		}
+		else if (arg == "--filter" && hasValue) {
+			options.filter = argv[++i];
+		}
+		else if (arg == "--clock" && hasValue) {
+			std::string clock = argv[++i];
+			if (clock == "coarse") {
+				options.clock = LogClockType::COARSE;
+			}
+			else if (clock == "tsc") {
+				options.clock = LogClockType::TSC;
+			}
+			else if (clock != "system") {
+				return false;
+			}
+		}
+		else if (arg == "--quick") {
+			options.records = 20000;
+			options.byteBudget = 16ull * 1024 * 1024;
+		}
+		else if (arg == "--keep") {
+			options.keep = true;
+		}
+		else {
+			return false;
+		}
+	}
+	if (options.format != "json" && options.format != "csv") {
+		return false;
+	}
+	if (options.maxThreads <= 0) {
+		options.maxThreads = std::max(4, static_cast<int>(std::thread::hardware_concurrency()));
+	}
+	return options.records > 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	BenchOptions options;
+	if (!parseOptions(argc, argv, options)) {
+		printUsage();
+		return 1;
+	}
+	if (!makeDir(options.dir)) {
+		fprintf(stderr, "Failed to create directory: %s\n", options.dir.c_str());
+		return 1;
+	}
+
+	std::vector<BenchCase> cases = buildCases(options);
+	std::vector<BenchResult> results;
+	for (size_t i = 0; i < cases.size(); ++i) {
+		fprintf(stderr, "[%zu/%zu] %s\n", i + 1, cases.size(), cases[i].name.c_str());
+		results.push_back(runCase(cases[i], options));
+	}
+	if (!options.keep) {
+		removeDir(options.dir);
+	}
+
+	FILE* out = stdout;
+	if (!options.output.empty()) {
+		out = fopen(options.output.c_str(), "w");
+		if (out == nullptr) {
+			fprintf(stderr, "Failed to open output file: %s\n", options.output.c_str());
+			return 1;
+		}
+	}
+	if (options.format == "csv") {
+		writeCsv(out, results);
+	}
+	else {
+		writeJson(out, results, options);
+	}
+	if (out != stdout) {
+		fclose(out);
+	}
+	return 0;
+}
@@ -0,0 +1,241 @@
+/******************************************************************************/
+/* File Name:    CacheBench.cpp                                              */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Page cache taken by the log files under each LogCacheMode */
+/*               and what is left of the application's own hot file: its   */
+/*               resident share (the hit rate of its next read), measured  */
+/*               with mincore, and the time to read it again.               */
+/*----------------------------------------------------------------------------*/
+/* Usage:                                                                    */
+/*   logger_cache_bench [--format table|csv] [--app-mb N] [--log-mb N]       */
+/*                      [--dir DIR]                                          */
+/*----------------------------------------------------------------------------*/
+/* Note:                                                                     */
+/*   - Every case first reads DIR/app.dat (--app-mb, default 256) so that  */
+/*     it is cached, then writes --log-mb (default 512) of log lines       */
+/*     through the logger (50 MB rotation), then measures. The log files  */
+/*     are deleted after each case, which also frees their pages.          */
+/*   - Without memory pressure nothing is evicted and only log_cached_mb  */
+/*     differs. To see the application's hit rate drop, run it in a        */
+/*     memory-limited cgroup smaller than app + log, e.g.                  */
+/*       systemd-run --scope -p MemoryMax=384M ./logger_cache_bench        */
+/*   - active is the mode the log file actually used (DIRECT falls back to */
+/*     DONTNEED on file systems without O_DIRECT). POSIX only.             */
+/******************************************************************************/
+
+#include "Logger.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// 单个用例的结果
+struct CacheResult {
+	std::string name;        // 用例名
+	std::string active;      // 实际生效的方式
+	double seconds;          // 写入日志的耗时（含最后的 flush）
+	double appResident;      // 写入后应用文件仍在页缓存中的比例，即下次读取的命中率
+	double logCachedMb;      // 写入后日志文件在页缓存中的大小
+	double appRereadMillis;  // 重新读取应用文件的耗时
+};
+
+uint64_t nowNanos() {
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// 文件在页缓存中的页数和总页数
+void residency(const std::string& path, uint64_t& resident, uint64_t& total) {
+	int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		return;
+	}
+	struct stat st;
+	if (fstat(fd, &st) == 0 && st.st_size > 0) {
+		size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+		size_t length = static_cast<size_t>(st.st_size);
+		void* map = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+		if (map != MAP_FAILED) {
+			std::vector<unsigned char> pages((length + page - 1) / page);
+			if (mincore(map, length, pages.data()) == 0) {
+				for (size_t i = 0; i < pages.size(); ++i) {
+					resident += pages[i] & 1;
+				}
+				total += pages.size();
+			}
+			munmap(map, length);
+		}
+	}
+	close(fd);
+}
+
+// 遍历文件夹中的日志文件（.log 和 .idx）
+template <typename Visit>
+void forEachLogFile(const std::string& folder, Visit visit) {
+	DIR* handle = opendir(folder.c_str());
+	if (handle == nullptr) {
+		return;
+	}
+	while (dirent* entry = readdir(handle)) {
+		std::string name = entry->d_name;
+		if (name.size() > 4 && (name.compare(name.size() - 4, 4, ".log") == 0 || name.compare(name.size() - 4, 4, ".idx") == 0)) {
+			visit(folder + "/" + name);
+		}
+	}
+	closedir(handle);
+}
+
+// 顺序读取整个文件，返回耗时（毫秒）
+double readAll(const std::string& path) {
+	int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		return 0;
+	}
+	std::vector<char> buffer(1 << 20);
+	uint64_t start = nowNanos();
+	while (read(fd, buffer.data(), buffer.size()) > 0) {
+	}
+	double millis = static_cast<double>(nowNanos() - start) / 1e6;
+	close(fd);
+	return millis;
+}
+
+// 创建应用文件，已存在且长度相同时沿用
+bool prepareApp(const std::string& path, uint64_t bytes) {
+	struct stat st;
+	if (stat(path.c_str(), &st) == 0 && static_cast<uint64_t>(st.st_size) == bytes) {
+		return true;
+	}
+	int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0) {
+		return false;
+	}
+	std::vector<char> block(1 << 20);
+	for (size_t i = 0; i < block.size(); ++i) {
+		block[i] = static_cast<char>('a' + i % 26);
+	}
+	bool ok = true;
+	for (uint64_t written = 0; ok && written < bytes; written += block.size()) {
+		size_t n = bytes - written < block.size() ? static_cast<size_t>(bytes - written) : block.size();
+		ok = write(fd, block.data(), n) == static_cast<ssize_t>(n);
+	}
+	ok = fsync(fd) == 0 && ok;
+	close(fd);
+	return ok;
+}
+
+const char* modeName(LogCacheMode mode) {
+	switch (mode) {
+	case LogCacheMode::DIRECT: return "direct";
+	case LogCacheMode::DONTNEED: return "dontneed";
+	default: return "normal";
+	}
+}
+
+CacheResult measure(const std::string& dir, const std::string& appPath, LogCacheMode mode, bool async, uint64_t logBytes) {
+	std::string name = std::string(async ? "async_" : "sync_") + modeName(mode);
+	std::string folder = dir + "/" + name;
+	mkdir(folder.c_str(), 0755);
+	forEachLogFile(folder, [](const std::string& path) { unlink(path.c_str()); });
+	readAll(appPath);
+
+	CacheResult result = { name, "", 0, 0, 0, 0 };
+	{
+		Logger logger(folder, Logger::LogLevel::LOG_INFO, false, async, 1);
+		result.active = modeName(logger.setCacheMode(mode));
+		std::string message = "request done user=u-1042 status=200 bytes=5120 path=/api/v1/items";
+		message.resize(200, '.');
+		uint64_t records = logBytes / (message.size() + 32);
+		uint64_t start = nowNanos();
+		for (uint64_t i = 0; i < records; ++i) {
+			logger.info(message);
+		}
+		logger.flush();
+		result.seconds = static_cast<double>(nowNanos() - start) / 1e9;
+	}
+
+	uint64_t resident = 0;
+	uint64_t total = 0;
+	residency(appPath, resident, total);
+	result.appResident = total > 0 ? static_cast<double>(resident) / static_cast<double>(total) : 0;
+	uint64_t logResident = 0;
+	uint64_t logTotal = 0;
+	forEachLogFile(folder, [&](const std::string& path) { residency(path, logResident, logTotal); });
+	result.logCachedMb = static_cast<double>(logResident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE))) / (1024.0 * 1024.0);
+	result.appRereadMillis = readAll(appPath);
+	forEachLogFile(folder, [](const std::string& path) { unlink(path.c_str()); });
+	return result;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+	std::string format = "table";
+	std::string dir = "cache_bench_logs";
+	uint64_t appMb = 256;
+	uint64_t logMb = 512;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--format" && hasValue) {
+			format = argv[++i];
+		}
+		else if (arg == "--app-mb" && hasValue) {
+			appMb = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (arg == "--log-mb" && hasValue) {
+			logMb = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (arg == "--dir" && hasValue) {
+			dir = argv[++i];
+		}
+		else {
+			fprintf(stderr, "Usage: logger_cache_bench [--format table|csv] [--app-mb N] [--log-mb N] [--dir DIR]\n");
+			return 1;
+		}
+	}
+
+	mkdir(dir.c_str(), 0755);
+	std::string appPath = dir + "/app.dat";
+	if (!prepareApp(appPath, appMb * 1024 * 1024)) {
+		fprintf(stderr, "cannot create %s\n", appPath.c_str());
+		return 1;
+	}
+	std::vector<CacheResult> results;
+	static const LogCacheMode modes[] = { LogCacheMode::NORMAL, LogCacheMode::DIRECT, LogCacheMode::DONTNEED };
+	for (int async = 0; async < 2; ++async) {
+		for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m) {
+			results.push_back(measure(dir, appPath, modes[m], async != 0, logMb * 1024 * 1024));
+		}
+	}
+
+	if (format == "csv") {
+		printf("name,active,log_mb,seconds,mb_per_second,app_resident_pct,log_cached_mb,app_reread_ms\n");
+		for (size_t i = 0; i < results.size(); ++i) {
+			const CacheResult& r = results[i];
+			printf("%s,%s,%llu,%.3f,%.1f,%.1f,%.1f,%.1f\n", r.name.c_str(), r.active.c_str(),
+				static_cast<unsigned long long>(logMb), r.seconds, static_cast<double>(logMb) / r.seconds,
+				r.appResident * 100, r.logCachedMb, r.appRereadMillis);
+		}
+	}
+	else {
+		printf("%-16s %-9s %8s %8s %8s %10s %12s\n", "name", "active", "seconds", "MB/s", "app_hit%", "log_cached", "app_reread_ms");
+		for (size_t i = 0; i < results.size(); ++i) {
+			const CacheResult& r = results[i];
+			printf("%-16s %-9s %8.3f %8.1f %8.1f %10.1f %12.1f\n", r.name.c_str(), r.active.c_str(), r.seconds,
+				static_cast<double>(logMb) / r.seconds, r.appResident * 100, r.logCachedMb, r.appRereadMillis);
+		}
+	}
+	return 0;
+}
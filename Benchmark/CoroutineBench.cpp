@@ -0,0 +1,267 @@
+/******************************************************************************/
+/* File Name:    CoroutineBench.cpp                                          */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Runs coroutines on a single-threaded executor that log     */
+/*               faster than the async writer drains, once with            */
+/*               co_await logEnqueue (LogCoroutine.h) and once with the    */
+/*               blocking info(), and reports how long the executor thread */
+/*               was stalled.                                                */
+/*----------------------------------------------------------------------------*/
+/* Usage:                                                                    */
+/*   logger_coro_bench [--format table|csv] [--records N] [--tasks N]        */
+/*                     [--dir DIR]                                           */
+/*----------------------------------------------------------------------------*/
+/* Note:                                                                     */
+/*   - C++20 only; built when the compiler supports coroutines.             */
+/*   - Producers yield to the executor every 1000 records. max_step_us is */
+/*     the longest uninterrupted run of the executor thread (one coroutine */
+/*     step): blocking calls sleep in it while the queue is full, awaiting */
+/*     coroutines suspend and let the others run.                          */
+/*   - suspensions counts the times a logEnqueue/logFlush suspended and    */
+/*     the writer thread handed the coroutine back.                        */
+/******************************************************************************/
+
+#include "Logger.h"
+#include "LogCoroutine.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+uint64_t nowNanos() {
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void makeDir(const std::string& path) {
+#ifdef _MSC_VER
+	_mkdir(path.c_str());
+#else
+	mkdir(path.c_str(), 0755);
+#endif
+}
+
+// 单线程执行器：其他线程投递的协程在 run() 的线程中恢复
+class Executor {
+public:
+	Executor() : live_(0), wakeups_(0), maxStep_(0) {}
+
+	void post(std::coroutine_handle<> handle) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		ready_.push_back(handle);
+		cond_.notify_one();
+	}
+
+	// 日志器在写日志线程中交回挂起的协程
+	void wake(std::coroutine_handle<> handle) {
+		++wakeups_;
+		post(handle);
+	}
+
+	// 启动一个协程，计入其首次运行的耗时
+	template <typename Start>
+	void spawn(Start start) {
+		++live_;
+		uint64_t begin = nowNanos();
+		start();
+		step(nowNanos() - begin);
+	}
+
+	void finished() {
+		--live_;
+	}
+
+	// 恢复投递来的协程，直到所有协程结束
+	void run() {
+		while (live_ > 0) {
+			std::coroutine_handle<> handle;
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				cond_.wait(lock, [this]() { return !ready_.empty(); });
+				handle = ready_.front();
+				ready_.pop_front();
+			}
+			uint64_t begin = nowNanos();
+			handle.resume();
+			step(nowNanos() - begin);
+		}
+	}
+
+	uint64_t wakeups() const {
+		return wakeups_.load();
+	}
+
+	uint64_t maxStep() const {
+		return maxStep_;
+	}
+
+private:
+	void step(uint64_t nanos) {
+		maxStep_ = nanos > maxStep_ ? nanos : maxStep_;
+	}
+
+	std::mutex mutex_;
+	std::condition_variable cond_;
+	std::deque<std::coroutine_handle<> > ready_; // 待恢复的协程
+	int live_;                                   // 未结束的协程数
+	std::atomic<uint64_t> wakeups_;              // 日志器交回协程的次数
+	uint64_t maxStep_;                           // 单次连续运行的最长耗时，单位ns
+};
+
+// 立即开始、结束时自动销毁的协程
+struct Task {
+	struct promise_type {
+		Task get_return_object() { return Task(); }
+		std::suspend_never initial_suspend() noexcept { return std::suspend_never(); }
+		std::suspend_never final_suspend() noexcept { return std::suspend_never(); }
+		void return_void() {}
+		void unhandled_exception() { std::terminate(); }
+	};
+};
+
+// co_await 后协程重新排到执行器队尾
+struct Yield {
+	Executor& executor;
+
+	bool await_ready() const { return false; }
+	void await_suspend(std::coroutine_handle<> handle) { executor.post(handle); }
+	void await_resume() const {}
+};
+
+// 每写这么多条让出一次执行器
+const uint64_t yieldEvery = 1000;
+
+Task awaitingProducer(Executor& executor, Logger& logger, const std::string& message, uint64_t records) {
+	LogResumer post = [&executor](std::coroutine_handle<> handle) { executor.wake(handle); };
+	for (uint64_t i = 0; i < records; ++i) {
+		co_await logEnqueue(logger, Logger::LogLevel::LOG_INFO, message, post);
+		if ((i + 1) % yieldEvery == 0) {
+			co_await Yield{ executor };
+		}
+	}
+	co_await logFlush(logger, post);
+	executor.finished();
+}
+
+// 阻塞版本：队列满时 info() 在执行器线程中等待
+Task blockingProducer(Executor& executor, Logger& logger, const std::string& message, uint64_t records) {
+	for (uint64_t i = 0; i < records; ++i) {
+		logger.info(message);
+		if ((i + 1) % yieldEvery == 0) {
+			co_await Yield{ executor };
+		}
+	}
+	logger.flush();
+	executor.finished();
+}
+
+// 单个用例的结果
+struct CoroResult {
+	std::string name;      // 用例名称
+	uint64_t records;      // 总日志条数
+	double seconds;        // 总耗时（含写完）
+	uint64_t suspensions;  // 协程挂起次数
+	uint64_t sleeps;       // 生产者因队列满而等待的次数
+	double maxStepUs;      // 执行器线程单次连续运行的最长耗时
+};
+
+template <typename Producer>
+CoroResult measure(const std::string& name, const std::string& dir, int tasks, uint64_t records, Producer producer) {
+	std::string folder = dir + "/" + name;
+	makeDir(folder);
+	Logger logger(folder, Logger::LogLevel::LOG_INFO, false, true, 1);
+	const std::string message = "request done user=u-1042 status=200 bytes=5120";
+	Executor executor;
+	uint64_t start = nowNanos();
+	for (int t = 0; t < tasks; ++t) {
+		executor.spawn([&]() { producer(executor, logger, message, records / tasks); });
+	}
+	executor.run();
+	uint64_t end = nowNanos();
+	Logger::Stats stats = logger.getStats();
+	CoroResult result = { name, records / tasks * tasks, static_cast<double>(end - start) / 1e9, executor.wakeups(),
+		stats.backpressureWait.count, static_cast<double>(executor.maxStep()) / 1e3 };
+	fprintf(stderr, "%-10s %8.3f s max_step %10.1f us\n", name.c_str(), result.seconds, result.maxStepUs);
+	return result;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+	std::string format = "table";
+	std::string dir = "coro_bench_logs";
+	uint64_t records = 1000000;
+	int tasks = 8;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--format" && hasValue) {
+			format = argv[++i];
+		}
+		else if (arg == "--records" && hasValue) {
+			records = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (arg == "--tasks" && hasValue) {
+			tasks = std::atoi(argv[++i]);
+		}
+		else if (arg == "--dir" && hasValue) {
+			dir = argv[++i];
+		}
+		else {
+			fprintf(stderr, "Usage: logger_coro_bench [--format table|csv] [--records N] [--tasks N] [--dir DIR]\n");
+			return 1;
+		}
+	}
+	if (tasks <= 0) {
+		tasks = 1;
+	}
+	if (records < static_cast<uint64_t>(tasks)) {
+		records = static_cast<uint64_t>(tasks);
+	}
+	makeDir(dir);
+
+	std::vector<CoroResult> results;
+	results.push_back(measure("blocking", dir, tasks, records,
+		[](Executor& executor, Logger& logger, const std::string& message, uint64_t count) {
+			blockingProducer(executor, logger, message, count);
+		}));
+	results.push_back(measure("awaiting", dir, tasks, records,
+		[](Executor& executor, Logger& logger, const std::string& message, uint64_t count) {
+			awaitingProducer(executor, logger, message, count);
+		}));
+
+	if (format == "csv") {
+		printf("name,records,seconds,suspensions,sleeps,max_step_us\n");
+		for (size_t i = 0; i < results.size(); ++i) {
+			printf("%s,%llu,%.3f,%llu,%llu,%.1f\n", results[i].name.c_str(), static_cast<unsigned long long>(results[i].records),
+				results[i].seconds, static_cast<unsigned long long>(results[i].suspensions),
+				static_cast<unsigned long long>(results[i].sleeps), results[i].maxStepUs);
+		}
+	}
+	else {
+		printf("%-10s %12s %10s %12s %10s %12s\n", "name", "records", "seconds", "suspensions", "sleeps", "max_step_us");
+		for (size_t i = 0; i < results.size(); ++i) {
+			printf("%-10s %12llu %10.3f %12llu %10llu %12.1f\n", results[i].name.c_str(),
+				static_cast<unsigned long long>(results[i].records), results[i].seconds,
+				static_cast<unsigned long long>(results[i].suspensions), static_cast<unsigned long long>(results[i].sleeps),
+				results[i].maxStepUs);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,471 @@
+/******************************************************************************/
+/* File Name:    NetBench.cpp                                                */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Network sink (LogNetSink.h) next to the file sink, with a */
+/*               small stand-in collector that receives and counts the     */
+/*               records over a Unix domain socket, TCP or UDP.            */
+/*----------------------------------------------------------------------------*/
+/* Usage:                                                                    */
+/*   logger_net_bench [--format table|csv] [--records N] [--dir DIR]        */
+/*   logger_net_bench --listen ENDPOINT [--framing prefixed|lines]          */
+/*                    [--output FILE]                                        */
+/*----------------------------------------------------------------------------*/
+/* Note:                                                                     */
+/*   - Without --listen every case starts the collector in-process on a     */
+/*     fresh endpoint (unix:DIR/collector.sock, tcp/udp on 127.0.0.1 with  */
+/*     a free port), writes N records, then waits (up to 6 s) until the    */
+/*     sink has sent everything and the collector has read it. seconds     */
+/*     covers the records and the final flush().                            */
+/*   - outage_* cases stop the collector after a third of the records and */
+/*     restart it after another third: records buffered meanwhile arrive   */
+/*     after the reconnect, overflow goes to the log file (spilled), and   */
+/*     lost is what neither the collector nor the file received (bytes the */
+/*     kernel had accepted when the collector stopped).                    */
+/*   - --listen runs only the collector: it prints the counts every second */
+/*     and writes the records as lines to FILE when given. POSIX only.     */
+/******************************************************************************/
+
+#include "Logger.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+uint64_t nowNanos() {
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// 本机收集器：接收网络输出的记录并计数，连接关闭时丢弃末尾不完整的记录
+class Collector {
+public:
+	Collector() : listen_(-1), udp_(false), framing_(LogNetFraming::LENGTH_PREFIXED), output_(nullptr), stop_(false),
+		records_(0), bytes_(0) {}
+
+	~Collector() {
+		stop();
+	}
+
+	// 在 endpoint 上监听并开始接收，tcp/udp 的端口为 0 时由系统分配；返回实际端点，失败时返回空串
+	std::string start(const std::string& endpoint, LogNetFraming framing, FILE* output = nullptr) {
+		framing_ = framing;
+		output_ = output;
+		std::string actual = bind(endpoint);
+		if (actual.empty()) {
+			return actual;
+		}
+		stop_ = false;
+		thread_ = std::thread(&Collector::run, this);
+		return actual;
+	}
+
+	// 停止接收并关闭所有连接，未读取的数据随之丢弃
+	void stop() {
+		stop_ = true;
+		if (thread_.joinable()) {
+			thread_.join();
+		}
+		if (listen_ >= 0) {
+			close(listen_);
+			listen_ = -1;
+		}
+		if (!path_.empty()) {
+			unlink(path_.c_str());
+			path_.clear();
+		}
+	}
+
+	uint64_t records() const {
+		return records_.load();
+	}
+
+	uint64_t bytes() const {
+		return bytes_.load();
+	}
+
+private:
+	// 一个连接（UDP 时为监听套接字本身）及其未凑成整条的数据
+	struct Peer {
+		int fd;
+		std::string pending;
+	};
+
+	std::string bind(const std::string& endpoint) {
+		size_t colon = endpoint.find(':');
+		std::string scheme = colon == std::string::npos ? "" : endpoint.substr(0, colon);
+		std::string rest = colon == std::string::npos ? "" : endpoint.substr(colon + 1);
+		if (scheme == "unix") {
+			sockaddr_un address;
+			memset(&address, 0, sizeof(address));
+			if (rest.empty() || rest.size() >= sizeof(address.sun_path)) {
+				return "";
+			}
+			address.sun_family = AF_UNIX;
+			memcpy(address.sun_path, rest.data(), rest.size());
+			unlink(rest.c_str());
+			listen_ = socket(AF_UNIX, SOCK_STREAM, 0);
+			if (listen_ < 0 || ::bind(listen_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+				|| listen(listen_, 16) != 0) {
+				return "";
+			}
+			path_ = rest;
+			udp_ = false;
+			return endpoint;
+		}
+		size_t portColon = rest.rfind(':');
+		if ((scheme != "tcp" && scheme != "udp") || portColon == std::string::npos) {
+			return "";
+		}
+		std::string host = rest.substr(0, portColon);
+		udp_ = scheme == "udp";
+		addrinfo hints;
+		memset(&hints, 0, sizeof(hints));
+		hints.ai_family = AF_UNSPEC;
+		hints.ai_socktype = udp_ ? SOCK_DGRAM : SOCK_STREAM;
+		hints.ai_flags = AI_PASSIVE;
+		addrinfo* result = nullptr;
+		if (getaddrinfo(host.empty() ? nullptr : host.c_str(), rest.substr(portColon + 1).c_str(), &hints, &result) != 0) {
+			return "";
+		}
+		listen_ = socket(result->ai_family, result->ai_socktype, 0);
+		int one = 1;
+		setsockopt(listen_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+		bool bound = listen_ >= 0 && ::bind(listen_, result->ai_addr, result->ai_addrlen) == 0
+			&& (udp_ || listen(listen_, 16) == 0);
+		freeaddrinfo(result);
+		if (!bound) {
+			return "";
+		}
+		if (udp_) {
+			// 报文在收集器忙时堆积在接收缓冲区，尽量调大以减少丢失
+			int size = 8 * 1024 * 1024;
+			setsockopt(listen_, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+		}
+		sockaddr_storage local;
+		socklen_t localLen = sizeof(local);
+		getsockname(listen_, reinterpret_cast<sockaddr*>(&local), &localLen);
+		char port[16];
+		getnameinfo(reinterpret_cast<sockaddr*>(&local), localLen, nullptr, 0, port, sizeof(port), NI_NUMERICSERV);
+		return scheme + ":" + host + ":" + port;
+	}
+
+	void run() {
+		std::vector<Peer> peers;
+		std::vector<char> buffer(256 * 1024);
+		while (!stop_) {
+			std::vector<pollfd> items;
+			pollfd listenItem = { listen_, POLLIN, 0 };
+			items.push_back(listenItem);
+			for (size_t i = 0; i < peers.size(); ++i) {
+				pollfd item = { peers[i].fd, POLLIN, 0 };
+				items.push_back(item);
+			}
+			if (poll(items.data(), items.size(), 50) <= 0) {
+				continue;
+			}
+			for (size_t i = 0; i < peers.size(); ) {
+				if (!(items[i + 1].revents & (POLLIN | POLLHUP | POLLERR))) {
+					++i;
+					continue;
+				}
+				ssize_t n = recv(peers[i].fd, buffer.data(), buffer.size(), 0);
+				if (n > 0) {
+					consume(peers[i].pending, buffer.data(), static_cast<size_t>(n));
+					++i;
+					continue;
+				}
+				close(peers[i].fd);
+				peers.erase(peers.begin() + static_cast<std::ptrdiff_t>(i));
+				items.erase(items.begin() + static_cast<std::ptrdiff_t>(i) + 1);
+			}
+			if (items[0].revents & POLLIN) {
+				if (udp_) {
+					ssize_t n = recv(listen_, buffer.data(), buffer.size(), 0);
+					if (n > 0) {
+						// 每个报文只含整条记录
+						std::string datagram;
+						consume(datagram, buffer.data(), static_cast<size_t>(n));
+					}
+				}
+				else {
+					int fd = accept(listen_, nullptr, nullptr);
+					if (fd >= 0) {
+						Peer peer = { fd, std::string() };
+						peers.push_back(peer);
+					}
+				}
+			}
+		}
+		for (size_t i = 0; i < peers.size(); ++i) {
+			close(peers[i].fd);
+		}
+	}
+
+	// 取出 pending 中的整条记录
+	void consume(std::string& pending, const char* data, size_t len) {
+		pending.append(data, len);
+		size_t pos = 0;
+		uint64_t records = 0;
+		uint64_t bytes = 0;
+		while (true) {
+			const char* record;
+			size_t recordLen;
+			if (framing_ == LogNetFraming::LENGTH_PREFIXED) {
+				if (pending.size() - pos < 4) {
+					break;
+				}
+				const unsigned char* prefix = reinterpret_cast<const unsigned char*>(pending.data() + pos);
+				recordLen = prefix[0] | (prefix[1] << 8) | (prefix[2] << 16) | (static_cast<size_t>(prefix[3]) << 24);
+				if (pending.size() - pos - 4 < recordLen) {
+					break;
+				}
+				record = pending.data() + pos + 4;
+				pos += 4 + recordLen;
+			}
+			else {
+				size_t end = pending.find('\n', pos);
+				if (end == std::string::npos) {
+					break;
+				}
+				record = pending.data() + pos;
+				recordLen = end - pos;
+				pos = end + 1;
+			}
+			if (output_ != nullptr) {
+				fwrite(record, 1, recordLen, output_);
+				fputc('\n', output_);
+			}
+			++records;
+			bytes += recordLen;
+		}
+		pending.erase(0, pos);
+		records_ += records;
+		bytes_ += bytes;
+	}
+
+	int listen_;                     // 监听套接字（UDP 时直接接收）
+	bool udp_;                       // 是否为 UDP
+	std::string path_;               // Unix 域套接字的路径，停止时删除
+	LogNetFraming framing_;          // 记录格式
+	FILE* output_;                   // 收到的记录写入的文件，可为空
+	std::thread thread_;             // 接收线程
+	std::atomic<bool> stop_;         // 是否停止接收
+	std::atomic<uint64_t> records_;  // 收到的记录数
+	std::atomic<uint64_t> bytes_;    // 收到的记录字节数（不含长度和换行符）
+};
+
+// 单个用例的结果
+struct NetResult {
+	std::string name;      // 用例名称
+	uint64_t records;      // 写入条数
+	double seconds;        // 写入并 flush() 的耗时
+	uint64_t received;     // 收集器收到的条数
+	uint64_t spilled;      // 改写入文件的条数
+	uint64_t lost;         // 未到达收集器也未写入文件的条数
+	uint64_t reconnects;   // 重新连接次数
+};
+
+std::string transportEndpoint(const std::string& transport, const std::string& dir) {
+	if (transport == "unix") {
+		return "unix:" + dir + "/collector.sock";
+	}
+	return transport + ":127.0.0.1:0";
+}
+
+// 统计文件夹中日志文件的行数
+uint64_t countLines(const std::string& folder) {
+	uint64_t lines = 0;
+	DIR* handle = opendir(folder.c_str());
+	if (handle == nullptr) {
+		return 0;
+	}
+	std::vector<char> buffer(1 << 16);
+	while (dirent* entry = readdir(handle)) {
+		std::string name = entry->d_name;
+		if (name.size() < 4 || name.compare(name.size() - 4, 4, ".log") != 0) {
+			continue;
+		}
+		FILE* file = fopen((folder + "/" + name).c_str(), "rb");
+		if (file == nullptr) {
+			continue;
+		}
+		size_t n;
+		while ((n = fread(buffer.data(), 1, buffer.size(), file)) > 0) {
+			for (size_t i = 0; i < n; ++i) {
+				lines += buffer[i] == '\n';
+			}
+		}
+		fclose(file);
+	}
+	closedir(handle);
+	return lines;
+}
+
+// transport 为空时写文件；outage 为 true 时在写入期间停止并重启收集器
+NetResult measure(const std::string& name, const std::string& dir, const std::string& transport, bool async, bool outage,
+	uint64_t records) {
+	std::string folder = dir + "/" + name;
+	mkdir(folder.c_str(), 0755);
+	Collector collector;
+	std::string endpoint;
+	if (!transport.empty()) {
+		endpoint = collector.start(transportEndpoint(transport, dir), LogNetFraming::LENGTH_PREFIXED);
+		if (endpoint.empty()) {
+			fprintf(stderr, "%s: cannot listen on %s\n", name.c_str(), transportEndpoint(transport, dir).c_str());
+		}
+	}
+	NetResult result = { name, records, 0, 0, 0, 0, 0 };
+	uint64_t linesBefore = countLines(folder);
+	{
+		Logger logger(folder, Logger::LogLevel::LOG_INFO, false, async, 1);
+		if (!endpoint.empty()) {
+			logger.setNetworkSink(endpoint, LogNetFraming::LENGTH_PREFIXED, 1024 * 1024);
+		}
+		const std::string message = "request done user=u-1042 status=200 bytes=5120 path=/api/v1/items";
+		uint64_t start = nowNanos();
+		for (uint64_t i = 0; i < records; ++i) {
+			if (outage && i == records / 3) {
+				logger.flush();
+				collector.stop();
+			}
+			else if (outage && i == records * 2 / 3) {
+				collector.start(endpoint, LogNetFraming::LENGTH_PREFIXED);
+			}
+			logger.info(message);
+		}
+		logger.flush();
+		result.seconds = static_cast<double>(nowNanos() - start) / 1e9;
+		if (!endpoint.empty()) {
+			// 断开后的记录由检测线程在重新连接后发出，最多等待一个退避周期
+			uint64_t deadline = nowNanos() + 6000000000ull;
+			while (logger.getStats().netPending > 0 && nowNanos() < deadline) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			}
+			// 等收集器读完内核中的数据
+			uint64_t received;
+			do {
+				received = collector.records();
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			} while (collector.records() != received);
+		}
+		result.reconnects = logger.getStats().netReconnects;
+	}
+	// 析构时未发出的记录也写入文件，网络输出开启时文件中只有改写入的记录
+	result.spilled = endpoint.empty() ? 0 : countLines(folder) - linesBefore;
+	result.received = collector.records();
+	collector.stop();
+	if (!endpoint.empty() && result.received + result.spilled < records) {
+		result.lost = records - result.received - result.spilled;
+	}
+	return result;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+	std::string format = "table";
+	std::string dir = "net_bench_logs";
+	std::string listenEndpoint;
+	std::string output;
+	LogNetFraming framing = LogNetFraming::LENGTH_PREFIXED;
+	uint64_t records = 200000;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--format" && hasValue) {
+			format = argv[++i];
+		}
+		else if (arg == "--records" && hasValue) {
+			records = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (arg == "--dir" && hasValue) {
+			dir = argv[++i];
+		}
+		else if (arg == "--listen" && hasValue) {
+			listenEndpoint = argv[++i];
+		}
+		else if (arg == "--framing" && hasValue) {
+			framing = std::string(argv[++i]) == "lines" ? LogNetFraming::LINES : LogNetFraming::LENGTH_PREFIXED;
+		}
+		else if (arg == "--output" && hasValue) {
+			output = argv[++i];
+		}
+		else {
+			fprintf(stderr, "Usage: logger_net_bench [--format table|csv] [--records N] [--dir DIR]\n"
+				"       logger_net_bench --listen ENDPOINT [--framing prefixed|lines] [--output FILE]\n");
+			return 1;
+		}
+	}
+
+	if (!listenEndpoint.empty()) {
+		FILE* file = output.empty() ? nullptr : fopen(output.c_str(), "ab");
+		Collector collector;
+		std::string actual = collector.start(listenEndpoint, framing, file);
+		if (actual.empty()) {
+			fprintf(stderr, "cannot listen on %s\n", listenEndpoint.c_str());
+			return 1;
+		}
+		fprintf(stderr, "listening on %s\n", actual.c_str());
+		while (true) {
+			std::this_thread::sleep_for(std::chrono::seconds(1));
+			fprintf(stderr, "records %llu bytes %llu\n", static_cast<unsigned long long>(collector.records()),
+				static_cast<unsigned long long>(collector.bytes()));
+			if (file != nullptr) {
+				fflush(file);
+			}
+		}
+	}
+
+	mkdir(dir.c_str(), 0755);
+	std::vector<NetResult> results;
+	results.push_back(measure("file_sync", dir, "", false, false, records));
+	results.push_back(measure("file_async", dir, "", true, false, records));
+	static const char* const transports[] = { "unix", "tcp", "udp" };
+	for (size_t t = 0; t < sizeof(transports) / sizeof(transports[0]); ++t) {
+		std::string transport = transports[t];
+		results.push_back(measure(transport + "_sync", dir, transport, false, false, records));
+		results.push_back(measure(transport + "_async", dir, transport, true, false, records));
+	}
+	results.push_back(measure("outage_unix", dir, "unix", true, true, records));
+	results.push_back(measure("outage_tcp", dir, "tcp", true, true, records));
+
+	if (format == "csv") {
+		printf("name,records,seconds,records_per_second,received,spilled,lost,reconnects\n");
+		for (size_t i = 0; i < results.size(); ++i) {
+			const NetResult& r = results[i];
+			printf("%s,%llu,%.3f,%.0f,%llu,%llu,%llu,%llu\n", r.name.c_str(), static_cast<unsigned long long>(r.records),
+				r.seconds, static_cast<double>(r.records) / r.seconds, static_cast<unsigned long long>(r.received),
+				static_cast<unsigned long long>(r.spilled), static_cast<unsigned long long>(r.lost),
+				static_cast<unsigned long long>(r.reconnects));
+		}
+	}
+	else {
+		printf("%-12s %10s %8s %12s %10s %9s %8s %10s\n", "name", "records", "seconds", "records/s", "received", "spilled",
+			"lost", "reconnects");
+		for (size_t i = 0; i < results.size(); ++i) {
+			const NetResult& r = results[i];
+			printf("%-12s %10llu %8.3f %12.0f %10llu %9llu %8llu %10llu\n", r.name.c_str(),
+				static_cast<unsigned long long>(r.records), r.seconds, static_cast<double>(r.records) / r.seconds,
+				static_cast<unsigned long long>(r.received), static_cast<unsigned long long>(r.spilled),
+				static_cast<unsigned long long>(r.lost), static_cast<unsigned long long>(r.reconnects));
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,196 @@
+/******************************************************************************/
+/* File Name:    PolicyBench.cpp                                             */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Compares the per-call cost of the policy-based            */
+/*               BasicLogger (BasicLogger.h) with the runtime-configured   */
+/*               Logger for the same message, single producer thread.     */
+/*----------------------------------------------------------------------------*/
+/* Usage:                                                                    */
+/*   logger_policy_bench [--format table|csv] [--records N] [--dir DIR]      */
+/*----------------------------------------------------------------------------*/
+/* Note:                                                                     */
+/*   - The *HotPath functions are not inlined so that the generated code  */
+/*     can be inspected, e.g.                                                */
+/*       objdump -d --no-show-raw-insn -C build/logger_policy_bench         */
+/*         | sed -n '/<policyAsyncHotPath/,/^$/p'                           */
+/*   - ns_per_call is the producer side only; drain_ms is the time flush() */
+/*     then needs to write the rest (async cases).                         */
+/******************************************************************************/
+
+#include "Logger.h"
+#include "BasicLogger.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <direct.h>
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#include <sys/stat.h>
+#define BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+namespace {
+
+typedef BasicLogger<LogSyncQueue, LogTextLayout, LogNullSink, LOG_LEVEL_INFO> SyncNullLogger;
+typedef BasicLogger<LogSyncQueue, LogTextLayout, LogFileSink, LOG_LEVEL_INFO> SyncPolicyLogger;
+typedef BasicLogger<LogAsyncQueue, LogTextLayout, LogFileSink, LOG_LEVEL_INFO> AsyncPolicyLogger;
+
+// 单个用例的结果
+struct PolicyResult {
+	std::string name;     // 用例名称
+	std::string logger;   // "Logger" 或 "BasicLogger"
+	uint64_t calls;       // 调用次数
+	double nsPerCall;     // 生产者每次调用耗时
+	double drainMs;       // 之后 flush() 的耗时
+};
+
+uint64_t nowNanos() {
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void makeDir(const std::string& path) {
+#ifdef _MSC_VER
+	_mkdir(path.c_str());
+#else
+	mkdir(path.c_str(), 0755);
+#endif
+}
+
+}
+
+// 以下函数只包含一次日志调用，供查看生成的代码
+BENCH_NOINLINE void policyAsyncHotPath(AsyncPolicyLogger& logger, const char* message, size_t len) {
+	logger.log<LOG_LEVEL_INFO>(message, len);
+}
+
+BENCH_NOINLINE void policyDisabledHotPath(AsyncPolicyLogger& logger, const char* message, size_t len) {
+	logger.log<LOG_LEVEL_DEBUG>(message, len);
+}
+
+BENCH_NOINLINE void policySyncNullHotPath(SyncNullLogger& logger, const char* message, size_t len) {
+	logger.log<LOG_LEVEL_INFO>(message, len);
+}
+
+BENCH_NOINLINE void policySyncHotPath(SyncPolicyLogger& logger, const char* message, size_t len) {
+	logger.log<LOG_LEVEL_INFO>(message, len);
+}
+
+BENCH_NOINLINE void loggerHotPath(Logger& logger, const std::string& message) {
+	logger.info(message);
+}
+
+BENCH_NOINLINE void loggerDisabledHotPath(Logger& logger, const std::string& message) {
+	logger.debug(message);
+}
+
+namespace {
+
+// 计时执行 calls 次 call，再计时 drain
+template <typename Call, typename Drain>
+PolicyResult measure(const std::string& name, const std::string& logger, uint64_t calls, Call call, Drain drain) {
+	uint64_t start = nowNanos();
+	for (uint64_t i = 0; i < calls; ++i) {
+		call();
+	}
+	uint64_t produced = nowNanos();
+	drain();
+	uint64_t drained = nowNanos();
+	PolicyResult result = { name, logger, calls, static_cast<double>(produced - start) / static_cast<double>(calls),
+		static_cast<double>(drained - produced) / 1e6 };
+	fprintf(stderr, "%-18s %-12s %8.1f ns/call\n", name.c_str(), logger.c_str(), result.nsPerCall);
+	return result;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+	std::string format = "table";
+	std::string dir = "policy_bench_logs";
+	uint64_t records = 1000000;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--format" && hasValue) {
+			format = argv[++i];
+		}
+		else if (arg == "--records" && hasValue) {
+			records = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (arg == "--dir" && hasValue) {
+			dir = argv[++i];
+		}
+		else {
+			fprintf(stderr, "Usage: logger_policy_bench [--format table|csv] [--records N] [--dir DIR]\n");
+			return 1;
+		}
+	}
+	if (records == 0) {
+		records = 1;
+	}
+	makeDir(dir);
+	makeDir(dir + "/logger_sync");
+	makeDir(dir + "/logger_async");
+	makeDir(dir + "/logger_disabled");
+
+	const std::string message = "request done user=u-1042 status=200 bytes=5120";
+	const char* text = message.c_str();
+	size_t len = message.size();
+	std::vector<PolicyResult> results;
+
+	{
+		Logger logger(dir + "/logger_disabled", Logger::LogLevel::LOG_INFO);
+		results.push_back(measure("disabled", "Logger", records * 10, [&]() { loggerDisabledHotPath(logger, message); }, []() {}));
+	}
+	{
+		AsyncPolicyLogger logger(dir + "/policy_disabled.log");
+		results.push_back(measure("disabled", "BasicLogger", records * 10, [&]() { policyDisabledHotPath(logger, text, len); }, []() {}));
+	}
+	{
+		SyncNullLogger logger;
+		results.push_back(measure("sync_null_sink", "BasicLogger", records, [&]() { policySyncNullHotPath(logger, text, len); },
+			[&]() { logger.flush(); }));
+	}
+	{
+		Logger logger(dir + "/logger_sync", Logger::LogLevel::LOG_INFO);
+		logger.setDurability(Logger::LogLevel::LOG_INFO, Logger::Durability::NONE);
+		results.push_back(measure("sync_file", "Logger", records, [&]() { loggerHotPath(logger, message); },
+			[&]() { logger.flush(); }));
+	}
+	{
+		SyncPolicyLogger logger(dir + "/policy_sync.log");
+		results.push_back(measure("sync_file", "BasicLogger", records, [&]() { policySyncHotPath(logger, text, len); },
+			[&]() { logger.flush(); }));
+	}
+	{
+		Logger logger(dir + "/logger_async", Logger::LogLevel::LOG_INFO, false, true, 1);
+		results.push_back(measure("async_file", "Logger", records, [&]() { loggerHotPath(logger, message); },
+			[&]() { logger.flush(); }));
+	}
+	{
+		AsyncPolicyLogger logger(dir + "/policy_async.log");
+		results.push_back(measure("async_file", "BasicLogger", records, [&]() { policyAsyncHotPath(logger, text, len); },
+			[&]() { logger.flush(); }));
+	}
+
+	if (format == "csv") {
+		printf("name,logger,calls,ns_per_call,drain_ms\n");
+		for (size_t i = 0; i < results.size(); ++i) {
+			printf("%s,%s,%llu,%.2f,%.2f\n", results[i].name.c_str(), results[i].logger.c_str(),
+				static_cast<unsigned long long>(results[i].calls), results[i].nsPerCall, results[i].drainMs);
+		}
+	}
+	else {
+		printf("%-18s %-12s %12s %12s %10s\n", "name", "logger", "calls", "ns_per_call", "drain_ms");
+		for (size_t i = 0; i < results.size(); ++i) {
+			printf("%-18s %-12s %12llu %12.2f %10.2f\n", results[i].name.c_str(), results[i].logger.c_str(),
+				static_cast<unsigned long long>(results[i].calls), results[i].nsPerCall, results[i].drainMs);
+		}
+	}
+	return 0;
+}
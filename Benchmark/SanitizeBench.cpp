@@ -0,0 +1,197 @@
+/******************************************************************************/
+/* File Name:    SanitizeBench.cpp                                           */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Throughput of the message sanitizer (LogSanitize.h) next  */
+/*               to memcpy and a byte-at-a-time escaper, for clean ASCII,  */
+/*               clean UTF-8 and dirty input of several sizes.            */
+/*----------------------------------------------------------------------------*/
+/* Usage:                                                                    */
+/*   logger_sanitize_bench [--format table|csv] [--bytes N]                  */
+/*----------------------------------------------------------------------------*/
+/* Note:                                                                     */
+/*   - --bytes is the amount of input processed per case (default 256 MB). */
+/*   - scan_* cases only run the escape classifier of one instruction set */
+/*     over the whole input, restarting after every byte it stops at;     */
+/*     sanitize is the full text escaper (dispatched at run time).         */
+/******************************************************************************/
+
+#include "LogSanitize.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 单个用例的结果
+struct SanitizeResult {
+	std::string input;    // 输入类型
+	size_t size;          // 单条消息长度
+	std::string method;   // 处理方式
+	double gbPerSecond;   // 输入吞吐，单位 GB/s
+};
+
+uint64_t nowNanos() {
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// 逐字节判断的转义，作为对比基准
+void escapeBytewise(std::string& out, const char* text, size_t len) {
+	for (size_t i = 0; i < len; ++i) {
+		unsigned char c = static_cast<unsigned char>(text[i]);
+		if (c >= 0x20 && c != 0x7f) {
+			out.push_back(static_cast<char>(c));
+		}
+		else if (c == '\n') {
+			out.append("\\n", 2);
+		}
+		else {
+			LogSanitize::appendHex(out, "\\x", c, 2);
+		}
+	}
+}
+
+// 生成一条消息：clean 为 ASCII，utf8 每 4 个字符中有一个中文字符，dirty 每 64 字节一个换行
+std::string makeInput(const std::string& kind, size_t size) {
+	static const char words[] = "request done user=u-1042 status=200 bytes=5120 path=/api/v1/items ";
+	std::string text;
+	while (text.size() < size) {
+		if (kind == "utf8" && text.size() % 16 == 12) {
+			text.append("\xe6\x97\xa5");
+		}
+		else if (kind == "dirty" && text.size() % 64 == 63) {
+			text.push_back('\n');
+		}
+		else {
+			text.push_back(words[text.size() % (sizeof(words) - 1)]);
+		}
+	}
+	text.resize(size);
+	// 截断可能切开多字节字符，末尾改为 ASCII
+	while (!text.empty() && static_cast<unsigned char>(text.back()) >= 0x80) {
+		text.back() = '.';
+	}
+	return text;
+}
+
+template <typename Process>
+double measure(size_t size, uint64_t totalBytes, Process process) {
+	uint64_t rounds = totalBytes / size;
+	rounds = rounds > 0 ? rounds : 1;
+	uint64_t start = nowNanos();
+	for (uint64_t i = 0; i < rounds; ++i) {
+		process();
+	}
+	uint64_t elapsed = nowNanos() - start;
+	return static_cast<double>(rounds * size) / static_cast<double>(elapsed > 0 ? elapsed : 1);
+}
+
+}
+
+int main(int argc, char* argv[]) {
+	std::string format = "table";
+	uint64_t totalBytes = 256ull * 1024 * 1024;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--format" && hasValue) {
+			format = argv[++i];
+		}
+		else if (arg == "--bytes" && hasValue) {
+			totalBytes = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else {
+			fprintf(stderr, "Usage: logger_sanitize_bench [--format table|csv] [--bytes N]\n");
+			return 1;
+		}
+	}
+
+	static const char* const kinds[] = { "clean", "utf8", "dirty" };
+	static const size_t sizes[] = { 64, 1024, 64 * 1024 };
+	std::vector<SanitizeResult> results;
+	volatile size_t sink = 0;
+	for (size_t k = 0; k < sizeof(kinds) / sizeof(kinds[0]); ++k) {
+		for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+			std::string input = makeInput(kinds[k], sizes[s]);
+			const char* begin = input.data();
+			const char* end = begin + input.size();
+			std::string out;
+			out.reserve(input.size() * 4);
+			std::vector<char> copy(input.size());
+
+			SanitizeResult result = { kinds[k], sizes[s], "", 0 };
+			result.method = "memcpy";
+			result.gbPerSecond = measure(sizes[s], totalBytes, [&]() {
+				memcpy(copy.data(), begin, input.size());
+				sink = sink + static_cast<size_t>(copy[0]);
+			});
+			results.push_back(result);
+			result.method = "bytewise";
+			result.gbPerSecond = measure(sizes[s], totalBytes, [&]() {
+				out.clear();
+				escapeBytewise(out, begin, input.size());
+				sink = sink + out.size();
+			});
+			results.push_back(result);
+			result.method = "sanitize";
+			result.gbPerSecond = measure(sizes[s], totalBytes, [&]() {
+				out.clear();
+				LogSanitize::appendText(out, begin, input.size());
+				sink = sink + out.size();
+			});
+			results.push_back(result);
+			result.method = "scan_scalar";
+			result.gbPerSecond = measure(sizes[s], totalBytes, [&]() {
+				size_t stops = 0;
+				for (const char* p = begin; (p = logsimd::findEscapeScalar(p, end, '\x7f', '\x7f', true)) != end; ++p) {
+					++stops;
+				}
+				sink = sink + stops;
+			});
+			results.push_back(result);
+#ifdef LOG_SIMD_X86
+			result.method = "scan_sse2";
+			result.gbPerSecond = measure(sizes[s], totalBytes, [&]() {
+				size_t stops = 0;
+				for (const char* p = begin; (p = logsimd::findEscapeSse2(p, end, '\x7f', '\x7f', true)) != end; ++p) {
+					++stops;
+				}
+				sink = sink + stops;
+			});
+			results.push_back(result);
+			if (logSimdLevel() == LogSimdLevel::AVX2) {
+				result.method = "scan_avx2";
+				result.gbPerSecond = measure(sizes[s], totalBytes, [&]() {
+					size_t stops = 0;
+					for (const char* p = begin; (p = logsimd::findEscapeAvx2(p, end, '\x7f', '\x7f', true)) != end; ++p) {
+						++stops;
+					}
+					sink = sink + stops;
+				});
+				results.push_back(result);
+			}
+#endif
+		}
+	}
+
+	if (format == "csv") {
+		printf("input,size,method,gb_per_second\n");
+		for (size_t i = 0; i < results.size(); ++i) {
+			printf("%s,%zu,%s,%.2f\n", results[i].input.c_str(), results[i].size, results[i].method.c_str(),
+				results[i].gbPerSecond);
+		}
+	}
+	else {
+		printf("%-8s %8s %-12s %10s\n", "input", "size", "method", "GB/s");
+		for (size_t i = 0; i < results.size(); ++i) {
+			printf("%-8s %8zu %-12s %10.2f\n", results[i].input.c_str(), results[i].size, results[i].method.c_str(),
+				results[i].gbPerSecond);
+		}
+	}
+	return 0;
+}
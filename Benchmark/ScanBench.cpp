@@ -0,0 +1,315 @@
+/******************************************************************************/
+/* File Name:    ScanBench.cpp                                               */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Compares logger_scan with grep -F on the same log folder.  */
+/*               The folder is written by the C11 Logger itself, then every */
+/*               query runs through both tools; the best wall time of      */
+/*               several runs and the number of matched lines are reported. */
+/*----------------------------------------------------------------------------*/
+/* Usage:                                                                    */
+/*   logger_scan_bench [--format json|csv] [--dir DIR] [--size MB]           */
+/*                     [--runs N] [--scan PATH] [--keep]                     */
+/*----------------------------------------------------------------------------*/
+/* Note:                                                                     */
+/*   - grep runs with LC_ALL=C; the level query is "grep -F ' ERROR] '".   */
+/*   - The first run of every query warms the page cache and is not timed. */
+/*   - Commands run through the POSIX shell (grep, wc).                     */
+/******************************************************************************/
+
+#include "Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <direct.h>
+#include <io.h>
+#define popen _popen
+#define pclose _pclose
+#else
+#include <sys/stat.h>
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+#ifndef LOGGER_SCAN_PATH
+#define LOGGER_SCAN_PATH "logger_scan"
+#endif
+
+namespace {
+
+// 一组对比查询
+struct ScanCase {
+	std::string name;     // 用例名称
+	std::string scanArgs; // logger_scan 参数
+	std::string grepArgs; // grep 参数
+};
+
+// 单个工具的结果
+struct ScanResult {
+	std::string name;
+	std::string tool;
+	double seconds;       // 多次运行中的最短耗时
+	double bytesPerSecond;
+	uint64_t matches;     // 命中行数
+};
+
+// 命令行参数
+struct ScanOptions {
+	std::string format = "json";
+	std::string dir = "scan_bench_logs";
+	std::string scan = LOGGER_SCAN_PATH;
+	uint64_t sizeMB = 256;
+	int runs = 3;
+	bool keep = false;
+};
+
+double nowSeconds() {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool makeDir(const std::string& path) {
+#ifdef _MSC_VER
+	return _mkdir(path.c_str()) == 0 || errno == EEXIST;
+#else
+	return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+}
+
+// 目录下的日志文件及总字节数
+std::vector<std::string> listFiles(const std::string& path, uint64_t& totalBytes) {
+	std::vector<std::string> files;
+	totalBytes = 0;
+#ifdef _MSC_VER
+	struct _finddata_t fileInfo;
+	intptr_t handle = _findfirst((path + "\\*.log").c_str(), &fileInfo);
+	if (handle != -1) {
+		do {
+			files.push_back(path + "\\" + fileInfo.name);
+			totalBytes += fileInfo.size;
+		} while (_findnext(handle, &fileInfo) == 0);
+		_findclose(handle);
+	}
+#else
+	DIR* dir = opendir(path.c_str());
+	if (dir != nullptr) {
+		struct dirent* entry;
+		while ((entry = readdir(dir)) != nullptr) {
+			std::string fileName = entry->d_name;
+			if (fileName.size() > 4 && fileName.compare(fileName.size() - 4, 4, ".log") == 0) {
+				struct stat fileStat;
+				std::string filePath = path + "/" + fileName;
+				if (stat(filePath.c_str(), &fileStat) == 0) {
+					totalBytes += static_cast<uint64_t>(fileStat.st_size);
+				}
+				files.push_back(filePath);
+			}
+		}
+		closedir(dir);
+	}
+#endif
+	std::sort(files.begin(), files.end());
+	return files;
+}
+
+void removeFiles(const std::string& path) {
+	uint64_t totalBytes = 0;
+	std::vector<std::string> files = listFiles(path, totalBytes);
+	for (size_t i = 0; i < files.size(); ++i) {
+		remove(files[i].c_str());
+		remove((files[i].substr(0, files[i].size() - 4) + ".idx").c_str());
+	}
+#ifdef _MSC_VER
+	_rmdir(path.c_str());
+#else
+	rmdir(path.c_str());
+#endif
+}
+
+// 请求 ID，按序号散列，互不相同
+unsigned int requestId(uint64_t i) {
+	uint64_t x = (i + 1) * 0x9E3779B97F4A7C15ull;
+	return static_cast<unsigned int>(x >> 32);
+}
+
+// 用 Logger 写入约 sizeMB 的日志，返回用作稀有子串的请求 ID
+std::string generate(const ScanOptions& options) {
+	Logger* logger = new Logger(options.dir, Logger::LogLevel::LOG_DEBUG, false, true, 1, 30, 64 * 1024 * 1024);
+	uint64_t target = options.sizeMB * 1024 * 1024;
+	uint64_t written = 0;
+	uint64_t i = 0;
+	char message[256];
+	for (; written < target; ++i) {
+		int status = i % 50 == 0 ? 500 : 200;
+		int length = snprintf(message, sizeof(message),
+			"GET /api/v1/orders/%llu status=%d latency_us=%u req-%08x user=%u",
+			static_cast<unsigned long long>(i % 100000), status, static_cast<unsigned int>(i * 37 % 20000),
+			requestId(i), static_cast<unsigned int>(i % 9973));
+		if (i % 100 == 0) {
+			logger->error(message);
+		}
+		else if (i % 20 == 0) {
+			logger->warn(message);
+		}
+		else if (i % 3 == 0) {
+			logger->debug(message);
+		}
+		else {
+			logger->info(message);
+		}
+		written += length + 34;// 前缀 "[YYYY-MM-DD HH:MM:SS.fff LEVEL] " 与换行
+	}
+	delete logger;
+
+	char needle[16];
+	snprintf(needle, sizeof(needle), "req-%08x", requestId(i / 2));
+	return needle;
+}
+
+// 运行命令，返回输出的第一行数字
+uint64_t runCount(const std::string& command) {
+	FILE* pipe = popen(command.c_str(), "r");
+	if (pipe == nullptr) {
+		return 0;
+	}
+	unsigned long long count = 0;
+	if (fscanf(pipe, "%llu", &count) != 1) {
+		count = 0;
+	}
+	pclose(pipe);
+	return count;
+}
+
+double timeCommand(const std::string& command, int runs) {
+	if (std::system(command.c_str()) == -1) {// 预热页缓存
+		return 0;
+	}
+	double best = 0;
+	for (int r = 0; r < runs; ++r) {
+		double begin = nowSeconds();
+		int status = std::system(command.c_str());
+		double seconds = nowSeconds() - begin;
+		if (status == -1) {
+			return 0;
+		}
+		best = r == 0 ? seconds : std::min(best, seconds);
+	}
+	return best;
+}
+
+void writeCsv(FILE* out, const std::vector<ScanResult>& results) {
+	fprintf(out, "name,tool,seconds,bytes_per_second,matches\n");
+	for (size_t i = 0; i < results.size(); ++i) {
+		const ScanResult& r = results[i];
+		fprintf(out, "%s,%s,%.6f,%.1f,%llu\n", r.name.c_str(), r.tool.c_str(), r.seconds, r.bytesPerSecond,
+			static_cast<unsigned long long>(r.matches));
+	}
+}
+
+void writeJson(FILE* out, const std::vector<ScanResult>& results, uint64_t totalBytes) {
+	fprintf(out, "{\n  \"bytes\": %llu,\n  \"results\": [\n", static_cast<unsigned long long>(totalBytes));
+	for (size_t i = 0; i < results.size(); ++i) {
+		const ScanResult& r = results[i];
+		fprintf(out, "    {\"name\": \"%s\", \"tool\": \"%s\", \"seconds\": %.6f, \"bytes_per_second\": %.1f, "
+			"\"matches\": %llu}%s\n", r.name.c_str(), r.tool.c_str(), r.seconds, r.bytesPerSecond,
+			static_cast<unsigned long long>(r.matches), i + 1 < results.size() ? "," : "");
+	}
+	fprintf(out, "  ]\n}\n");
+}
+
+void printUsage() {
+	fprintf(stderr, "Usage: logger_scan_bench [--format json|csv] [--dir DIR] [--size MB]\n"
+		"                         [--runs N] [--scan PATH] [--keep]\n");
+}
+
+bool parseOptions(int argc, char* argv[], ScanOptions& options) {
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--format" && hasValue) {
+			options.format = argv[++i];
+		}
+		else if (arg == "--dir" && hasValue) {
+			options.dir = argv[++i];
+		}
+		else if (arg == "--size" && hasValue) {
+			options.sizeMB = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (arg == "--runs" && hasValue) {
+			options.runs = std::atoi(argv[++i]);
+		}
+		else if (arg == "--scan" && hasValue) {
+			options.scan = argv[++i];
+		}
+		else if (arg == "--keep") {
+			options.keep = true;
+		}
+		else {
+			return false;
+		}
+	}
+	return (options.format == "json" || options.format == "csv") && options.sizeMB > 0 && options.runs > 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	ScanOptions options;
+	if (!parseOptions(argc, argv, options)) {
+		printUsage();
+		return 1;
+	}
+	if (!makeDir(options.dir)) {
+		fprintf(stderr, "Failed to create directory: %s\n", options.dir.c_str());
+		return 1;
+	}
+	fprintf(stderr, "Generating %llu MB of logs in %s\n", static_cast<unsigned long long>(options.sizeMB),
+		options.dir.c_str());
+	std::string needle = generate(options);
+	uint64_t totalBytes = 0;
+	std::vector<std::string> files = listFiles(options.dir, totalBytes);
+	std::string fileArgs;
+	for (size_t i = 0; i < files.size(); ++i) {
+		fileArgs += " \"" + files[i] + "\"";
+	}
+
+	std::vector<ScanCase> cases;
+	cases.push_back(ScanCase{ "rare_substring", "-F " + needle, "-F " + needle });
+	cases.push_back(ScanCase{ "common_substring", "-F status=500", "-F status=500" });
+	cases.push_back(ScanCase{ "level_error", "--level ERROR", "-F ' ERROR] '" });
+
+	// 输出到普通文件：grep 发现输出是 /dev/null 时会在第一次命中后退出
+	std::string outPath = options.dir + "/scan_output.txt";
+	std::vector<ScanResult> results;
+	for (size_t i = 0; i < cases.size(); ++i) {
+		const ScanCase& c = cases[i];
+		fprintf(stderr, "[%zu/%zu] %s\n", i + 1, cases.size(), c.name.c_str());
+		std::string scan = "\"" + options.scan + "\" " + c.scanArgs + fileArgs;
+		std::string grep = "LC_ALL=C grep -h " + c.grepArgs + fileArgs;
+		ScanResult scanResult = { c.name, "logger_scan", timeCommand(scan + " > \"" + outPath + "\"", options.runs), 0,
+			runCount(scan + " --count") };
+		ScanResult grepResult = { c.name, "grep", timeCommand(grep + " > \"" + outPath + "\"", options.runs), 0,
+			runCount(grep + " | wc -l") };
+		scanResult.bytesPerSecond = scanResult.seconds > 0 ? totalBytes / scanResult.seconds : 0;
+		grepResult.bytesPerSecond = grepResult.seconds > 0 ? totalBytes / grepResult.seconds : 0;
+		results.push_back(scanResult);
+		results.push_back(grepResult);
+	}
+	remove(outPath.c_str());
+	if (!options.keep) {
+		removeFiles(options.dir);
+	}
+
+	if (options.format == "csv") {
+		writeCsv(stdout, results);
+	}
+	else {
+		writeJson(stdout, results, totalBytes);
+	}
+	return 0;
+}
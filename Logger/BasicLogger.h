@@ -0,0 +1,399 @@
+/******************************************************************************/
+/* File Name:    BasicLogger.h                                               */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Header-only logger assembled from compile-time policies:  */
+/*               BasicLogger<QueuePolicy, LayoutPolicy, SinkPolicy,        */
+/*               MinLevel>. Every call is resolved statically, so the      */
+/*               compiler can inline the whole path from info() to the     */
+/*               queue or sink, and levels below MinLevel compile to       */
+/*               nothing.                                                    */
+/*----------------------------------------------------------------------------*/
+/* Usage:                                                                    */
+/*   BasicLogger<LogAsyncQueue, LogTextLayout, LogFileSink, LOG_LEVEL_INFO>  */
+/*       logger("app.log");                                                  */
+/*   logger.info("started");                                                 */
+/*   logger.debug("dropped at compile time");                                */
+/*----------------------------------------------------------------------------*/
+/* Details:                                                                  */
+/*   - QueuePolicy: LogSyncQueue (write in the calling thread under a      */
+/*     mutex), LogUnlockedQueue (single-threaded, no lock), LogAsyncQueue  */
+/*     (pooled records, see LogRecordPool.h, and a writer thread).          */
+/*   - LayoutPolicy: LogTextLayout ("[time LEVEL] message"), LogJsonLayout */
+/*     (one JSON object per line).                                          */
+/*   - SinkPolicy: LogFileSink (one file, see LogFile.h), LogStdoutSink,    */
+/*     LogNullSink.                                                          */
+/*   - A policy is any class with the same members, e.g. a custom sink     */
+/*     needs write(data, len) and flush().                                   */
+/*----------------------------------------------------------------------------*/
+/* Note:                                                                     */
+/*   - Logger (Logger.h) stays the runtime-configured logger with rotation, */
+/*     retention, categories and the other features; BasicLogger only     */
+/*     covers the record path.                                              */
+/******************************************************************************/
+
+#ifndef BASIC_LOGGER_H
+#define BASIC_LOGGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include "LogClock.h"
+#include "LogFields.h"
+#include "LogFile.h"
+#include "LogRecordPool.h"
+
+// 日志等级，取值与 Logger::LogLevel 相同
+enum BasicLogLevel {
+	LOG_LEVEL_DEBUG = 0,
+	LOG_LEVEL_INFO = 1,
+	LOG_LEVEL_WARNING = 2,
+	LOG_LEVEL_ERROR = 3
+};
+
+// 等级名称
+inline const char* basicLogLevelName(int level) {
+	static const char* const names[4] = { "DEBUG", "INFO", "WARNING", "ERROR" };
+	return level >= 0 && level < 4 ? names[level] : "UNKNOWN";
+}
+
+// 秒级时间格式化缓存：YYYY-MM-DD HH:MM:SS.mmm，每秒只调用一次 localtime
+class LogTimeText {
+public:
+	LogTimeText() : second_(-1) {
+		text_[0] = '\0';
+	}
+
+	void append(std::string& out, uint64_t nanos) {
+		int64_t second = static_cast<int64_t>(nanos / 1000000000ull);
+		if (second != second_) {
+			std::time_t time = static_cast<std::time_t>(second);
+			std::tm tm;
+#ifdef _WIN32
+			localtime_s(&tm, &time);
+#else
+			localtime_r(&time, &tm);
+#endif
+			strftime(text_, sizeof(text_), "%Y-%m-%d %H:%M:%S", &tm);
+			second_ = second;
+		}
+		out.append(text_);
+		unsigned millis = static_cast<unsigned>(nanos % 1000000000ull / 1000000);
+		char digits[4] = { '.', static_cast<char>('0' + millis / 100), static_cast<char>('0' + millis / 10 % 10),
+			static_cast<char>('0' + millis % 10) };
+		out.append(digits, 4);
+	}
+
+private:
+	int64_t second_;  // 已格式化的秒
+	char text_[32];   // 秒级时间的字符串格式
+};
+
+// 文本布局："[YYYY-MM-DD HH:MM:SS.mmm LEVEL] message\n"
+class LogTextLayout {
+public:
+	void format(std::string& out, uint64_t nanos, int level, const char* message, size_t len) {
+		out.clear();
+		out.push_back('[');
+		time_.append(out, nanos);
+		out.push_back(' ');
+		out.append(basicLogLevelName(level));
+		out.append("] ", 2);
+		out.append(message, len);
+		out.push_back('\n');
+	}
+
+private:
+	LogTimeText time_;
+};
+
+// JSON Lines 布局：{"time":"...","level":"...","msg":"..."}
+class LogJsonLayout {
+public:
+	void format(std::string& out, uint64_t nanos, int level, const char* message, size_t len) {
+		out.clear();
+		out.append("{\"time\":\"", 9);
+		time_.append(out, nanos);
+		out.append("\",\"level\":\"", 11);
+		out.append(basicLogLevelName(level));
+		out.append("\",\"msg\":\"", 9);
+		LogFieldCodec::appendJsonEscaped(out, message, len);
+		out.append("\"}\n", 3);
+	}
+
+private:
+	LogTimeText time_;
+};
+
+// 文件输出：追加写入一个文件，带用户态缓冲区（不切换、不清理）
+class LogFileSink {
+public:
+	explicit LogFileSink(const std::string& path) {
+		file_.open(path);
+	}
+
+	void write(const char* data, size_t len) {
+		file_.write(data, len);
+	}
+
+	void flush() {
+		file_.flush();
+	}
+
+private:
+	LogFile file_;
+};
+
+// 标准输出
+class LogStdoutSink {
+public:
+	void write(const char* data, size_t len) {
+		fwrite(data, 1, len, stdout);
+	}
+
+	void flush() {
+		fflush(stdout);
+	}
+};
+
+// 丢弃所有输出，用于测量日志路径本身的开销
+class LogNullSink {
+public:
+	void write(const char*, size_t) {}
+	void flush() {}
+};
+
+// 同步队列：调用线程在锁内格式化并写出
+class LogSyncQueue {
+public:
+	template <class Writer>
+	void start(Writer&) {}
+
+	template <class Writer>
+	void push(Writer& writer, uint64_t nanos, int level, const char* message, size_t len) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		writer.write(nanos, level, message, len);
+	}
+
+	template <class Writer>
+	void flush(Writer& writer) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		writer.flushSink();
+	}
+
+	template <class Writer>
+	void stop(Writer& writer) {
+		flush(writer);
+	}
+
+private:
+	std::mutex mutex_;
+};
+
+// 单线程队列：与 LogSyncQueue 相同但不加锁，只能在一个线程中使用
+class LogUnlockedQueue {
+public:
+	template <class Writer>
+	void start(Writer&) {}
+
+	template <class Writer>
+	void push(Writer& writer, uint64_t nanos, int level, const char* message, size_t len) {
+		writer.write(nanos, level, message, len);
+	}
+
+	template <class Writer>
+	void flush(Writer& writer) {
+		writer.flushSink();
+	}
+
+	template <class Writer>
+	void stop(Writer& writer) {
+		writer.flushSink();
+	}
+};
+
+// 异步队列：消息复制到池化记录后入队，由后台线程格式化并批量写出
+class LogAsyncQueue {
+public:
+	static const size_t maxQueueSize = 1000000;// 队列超过该长度时生产者等待 1ms
+
+	LogAsyncQueue() : exit_(false), flushRequested_(0), flushCompleted_(0) {}
+
+	template <class Writer>
+	void start(Writer& writer) {
+		thread_ = std::thread([this, &writer]() { run(writer); });
+	}
+
+	template <class Writer>
+	void push(Writer&, uint64_t nanos, int level, const char* message, size_t len) {
+		// 在锁外复制消息，队列锁内只链接记录
+		LogPoolRecord* record = LogRecordPool::instance().acquire(nanos, level, message, len);
+		bool wait;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (queue_.empty()) {
+				cond_.notify_one();
+			}
+			queue_.push_back(record);
+			wait = queue_.size() >= maxQueueSize;
+		}
+		if (wait) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+
+	// 等待此前入队的记录全部写出
+	template <class Writer>
+	void flush(Writer&) {
+		std::unique_lock<std::mutex> lock(mutex_);
+		uint64_t target = ++flushRequested_;
+		cond_.notify_one();
+		doneCond_.wait(lock, [&]() { return flushCompleted_ >= target || exit_; });
+	}
+
+	template <class Writer>
+	void stop(Writer&) {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (!thread_.joinable()) {
+				return;
+			}
+			exit_ = true;
+			cond_.notify_one();
+		}
+		thread_.join();
+	}
+
+private:
+	std::mutex mutex_;                  // 队列锁
+	std::condition_variable cond_;      // 有新记录、flush 或退出
+	std::condition_variable doneCond_;  // flush 完成
+	LogRecordList queue_;               // 待写出的记录
+	std::thread thread_;                // 写日志线程
+	bool exit_;                         // 退出标识
+	uint64_t flushRequested_;           // 已请求的 flush 次数
+	uint64_t flushCompleted_;           // 已完成的 flush 次数
+	std::string spill_;                 // 续块拼接缓冲区，仅写日志线程使用
+
+	template <class Writer>
+	void run(Writer& writer) {
+		LogRecordList batch;
+		while (true) {
+			uint64_t flushTarget;
+			bool exiting;
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				cond_.wait(lock, [this]() { return !queue_.empty() || exit_ || flushRequested_ != flushCompleted_; });
+				batch.swap(queue_);
+				flushTarget = flushRequested_;
+				exiting = exit_;
+			}
+			while (!batch.empty()) {
+				LogPoolRecord* record = batch.pop_front();
+				const char* data = record->payload;
+				size_t len = record->length;
+				if (record->spill != nullptr) {
+					record->copyMessage(spill_);
+					data = spill_.data();
+					len = spill_.size();
+				}
+				writer.write(record->tick, record->level, data, len);
+				LogRecordPool::instance().release(record);
+			}
+			// 每批写入内核一次
+			writer.flushSink();
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				if (flushTarget > flushCompleted_) {
+					flushCompleted_ = flushTarget;
+					doneCond_.notify_all();
+				}
+				if (exiting && queue_.empty()) {
+					doneCond_.notify_all();
+					return;
+				}
+			}
+		}
+	}
+};
+
+template <class QueuePolicy, class LayoutPolicy, class SinkPolicy, int MinLevel = LOG_LEVEL_DEBUG>
+class BasicLogger {
+public:
+	typedef BasicLogger<QueuePolicy, LayoutPolicy, SinkPolicy, MinLevel> Self;
+
+	// 参数转发给输出策略的构造函数，如 LogFileSink 的文件路径
+	template <typename... SinkArgs>
+	explicit BasicLogger(SinkArgs&&... sinkArgs)
+		: sink_(std::forward<SinkArgs>(sinkArgs)...), level_(MinLevel) {
+		queue_.start(*this);
+	}
+
+	~BasicLogger() {
+		queue_.stop(*this);
+	}
+
+	// 运行时等级，低于 MinLevel 的设置无效
+	void setLevel(int level) {
+		level_.store(level < MinLevel ? MinLevel : level, std::memory_order_relaxed);
+	}
+
+	// 该等级是否输出：低于 MinLevel 时为编译期常量 false
+	template <int Level>
+	bool enabled() const {
+		return Level >= MinLevel && Level >= level_.load(std::memory_order_relaxed);
+	}
+
+	template <int Level>
+	void log(const char* message, size_t len) {
+		if (!enabled<Level>()) return;
+		queue_.push(*this, LogClock::systemNanos(), Level, message, len);
+	}
+
+	void debug(const char* message) { log<LOG_LEVEL_DEBUG>(message, strlen(message)); }
+	void debug(const std::string& message) { log<LOG_LEVEL_DEBUG>(message.data(), message.size()); }
+	void info(const char* message) { log<LOG_LEVEL_INFO>(message, strlen(message)); }
+	void info(const std::string& message) { log<LOG_LEVEL_INFO>(message.data(), message.size()); }
+	void warn(const char* message) { log<LOG_LEVEL_WARNING>(message, strlen(message)); }
+	void warn(const std::string& message) { log<LOG_LEVEL_WARNING>(message.data(), message.size()); }
+	void error(const char* message) { log<LOG_LEVEL_ERROR>(message, strlen(message)); }
+	void error(const std::string& message) { log<LOG_LEVEL_ERROR>(message.data(), message.size()); }
+
+	// 等待此前的日志写入内核
+	void flush() {
+		queue_.flush(*this);
+	}
+
+	// 以下由队列策略调用：格式化一条记录并交给输出策略
+	void write(uint64_t nanos, int level, const char* message, size_t len) {
+		layout_.format(line_, nanos, level, message, len);
+		sink_.write(line_.data(), line_.size());
+	}
+
+	void flushSink() {
+		sink_.flush();
+	}
+
+private:
+	BasicLogger(const BasicLogger&);
+	BasicLogger& operator=(const BasicLogger&);
+
+	SinkPolicy sink_;          // 输出
+	LayoutPolicy layout_;      // 布局
+	std::string line_;         // 格式化缓冲区，由写出方（队列策略保证串行）使用
+	std::atomic<int> level_;   // 运行时等级
+	QueuePolicy queue_;        // 队列，最后构造、最先停止
+};
+
+// 常用组合
+typedef BasicLogger<LogSyncQueue, LogTextLayout, LogFileSink, LOG_LEVEL_DEBUG> SyncFileLogger;
+typedef BasicLogger<LogAsyncQueue, LogTextLayout, LogFileSink, LOG_LEVEL_DEBUG> AsyncFileLogger;
+
+#endif // BASIC_LOGGER_H
@@ -1,15 +1,5 @@
 ﻿#include "Logger.h"
 
-template <typename Func>
-void performanceTest(Func&& func, uint64_t count = 1000000) {
-	uint64_t startTime = Logger::getCurrentTimestamp();
-	for (auto i = 0; i < count; ++i) {
-		func();
-	}
-	uint64_t stopTime = Logger::getCurrentTimestamp();
-	Logger::console("The execution of %lu times takes %lu milliseconds | %lu times per millisecond", count, stopTime - startTime, count / (stopTime - startTime));
-}
-
 int main() {
 	//// 日志对象创建
 	Logger logger;// 默认"logs"文件夹
@@ -41,12 +31,6 @@ int main() {
 	logger.warn("Low memory detected. Consider freeing some %s.", "resources");
 	logger.error("Failed to open the no.%d configuration file. Please check the path.", 13936);
 
-	// 日志性能测试
-	auto loggerLambda = [&logger]() {
-		return logger.info("Hello, World!");
-	};
-	for (auto i = 0; i < 10; ++i) {
-		performanceTest(loggerLambda);
-	}
+	// 性能测试见 Benchmark/Benchmark.cpp（CMake 目标 logger_bench）
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,205 @@
+/******************************************************************************/
+/* File Name:    LogBroadcast.h                                              */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Lock-free single-writer broadcast ring for live           */
+/*               subscribers: the writer publishes every formatted line    */
+/*               once, each reader follows with its own cursor.            */
+/*----------------------------------------------------------------------------*/
+/* Details:                                                                  */
+/*   - The writer never waits for readers: when the ring is full it        */
+/*     overwrites the oldest records. A reader that falls behind is moved  */
+/*     to the oldest record still present and counts the records it       */
+/*     missed (lost); records longer than a quarter of the ring are not   */
+/*     published and are counted as lost as well.                          */
+/*   - head and tail are byte positions that only grow. The writer moves  */
+/*     tail past the records it is about to overwrite before writing, and */
+/*     publishes a record with the release store of head. A reader copies */
+/*     a record and then checks that tail has not passed it (seqlock);    */
+/*     otherwise the copy is discarded.                                     */
+/*   - Readers never write shared state, so any number of them costs the  */
+/*     writer nothing. The writer must be serialized by the caller.       */
+/******************************************************************************/
+
+#ifndef LOG_BROADCAST_H
+#define LOG_BROADCAST_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// 环中一条记录的头部，后接消息，整体按 8 字节对齐
+struct LogBroadcastRecord {
+	uint32_t size;    // 记录总长度（含头部和对齐）
+	int32_t level;    // 日志等级，skipLevel 表示跳到数据区开头
+	uint64_t seq;     // 记录序号，连续递增，读取方据此统计丢失
+	uint32_t length;  // 消息长度
+	uint32_t reserved;
+};
+
+class LogBroadcast {
+public:
+	static const int32_t skipLevel = -1;
+
+	// capacity 向上取整为 2 的幂，至少 4KB
+	explicit LogBroadcast(size_t capacity) : head_(0), tail_(0), published_(0), nextSeq_(0) {
+		size_t size = 4096;
+		while (size < capacity) {
+			size <<= 1;
+		}
+		data_.resize(size);
+	}
+
+	// 发布一条记录，调用方保证同一时间只有一个写入方
+	void publish(int level, const char* message, size_t len) {
+		uint64_t seq = nextSeq_++;
+		size_t size = align(sizeof(LogBroadcastRecord) + len);
+		if (size > data_.size() / 4) {
+			published_.store(nextSeq_, std::memory_order_relaxed);
+			return;
+		}
+		uint64_t head = head_.load(std::memory_order_relaxed);
+		size_t offset = static_cast<size_t>(head & (data_.size() - 1));
+		size_t pad = data_.size() - offset < size ? data_.size() - offset : 0;
+		uint64_t end = head + pad + size;
+
+		// 先移动 tail 越过将被覆盖的记录，读取方复制后据此判断是否被覆盖
+		uint64_t tail = tail_.load(std::memory_order_relaxed);
+		if (end - tail > data_.size()) {
+			while (end - tail > data_.size()) {
+				tail = next(tail);
+			}
+			tail_.store(tail, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+		}
+
+		if (pad >= sizeof(LogBroadcastRecord)) {
+			LogBroadcastRecord skip = { static_cast<uint32_t>(pad), skipLevel, 0, 0, 0 };
+			memcpy(&data_[offset], &skip, sizeof(skip));
+		}
+		offset = static_cast<size_t>((head + pad) & (data_.size() - 1));
+		LogBroadcastRecord record = { static_cast<uint32_t>(size), level, seq, static_cast<uint32_t>(len), 0 };
+		memcpy(&data_[offset], &record, sizeof(record));
+		memcpy(&data_[offset + sizeof(record)], message, len);
+		published_.store(nextSeq_, std::memory_order_relaxed);
+		head_.store(end, std::memory_order_release);
+	}
+
+private:
+	friend class LogBroadcastReader;
+
+	LogBroadcast(const LogBroadcast&);
+	LogBroadcast& operator=(const LogBroadcast&);
+
+	static size_t align(size_t size) {
+		return (size + 7) & ~static_cast<size_t>(7);
+	}
+
+	// pos 处记录之后的位置，仅写入方调用
+	uint64_t next(uint64_t pos) const {
+		size_t offset = static_cast<size_t>(pos & (data_.size() - 1));
+		size_t rest = data_.size() - offset;
+		if (rest < sizeof(LogBroadcastRecord)) {
+			return pos + rest;
+		}
+		LogBroadcastRecord record;
+		memcpy(&record, &data_[offset], sizeof(record));
+		return pos + record.size;
+	}
+
+	std::vector<char> data_;          // 数据区，长度为 2 的幂
+	std::atomic<uint64_t> head_;      // 已发布的结束位置
+	char pad0_[64 - sizeof(std::atomic<uint64_t>)];
+	std::atomic<uint64_t> tail_;      // 最早的有效位置，写入方覆盖前移动
+	char pad1_[64 - sizeof(std::atomic<uint64_t>)];
+	std::atomic<uint64_t> published_; // head_ 之后下一条记录的序号，先于 head_ 写入
+	uint64_t nextSeq_;                // 下一条记录的序号，仅写入方使用
+};
+
+// 读取方：各自持有游标，不影响写入方和其他读取方
+class LogBroadcastReader {
+public:
+	// fromOldest 为 true 时从仍保留的最早记录开始，否则只读取之后发布的记录
+	LogBroadcastReader(const LogBroadcast& ring, bool fromOldest)
+		: ring_(ring), pos_(0), nextSeq_(0), started_(!fromOldest), lost_(0) {
+		if (fromOldest) {
+			pos_ = ring.tail_.load(std::memory_order_acquire);
+			return;
+		}
+		// 位置与序号须对应：读取期间有新记录发布时重读（序号至多超前一条正在发布的记录）
+		do {
+			pos_ = ring.head_.load(std::memory_order_acquire);
+			nextSeq_ = ring.published_.load(std::memory_order_relaxed);
+		} while (ring.head_.load(std::memory_order_acquire) != pos_);
+	}
+
+	// 读取下一条 level >= minLevel 的记录到 out，没有新记录时返回 false
+	bool next(std::string& out, int& level, int minLevel) {
+		const std::vector<char>& data = ring_.data_;
+		while (true) {
+			uint64_t head = ring_.head_.load(std::memory_order_acquire);
+			uint64_t tail = ring_.tail_.load(std::memory_order_acquire);
+			if (pos_ < tail) {
+				pos_ = tail;
+			}
+			if (pos_ >= head) {
+				return false;
+			}
+			size_t offset = static_cast<size_t>(pos_ & (data.size() - 1));
+			size_t rest = data.size() - offset;
+			if (rest < sizeof(LogBroadcastRecord)) {
+				pos_ += rest;
+				continue;
+			}
+			LogBroadcastRecord record;
+			memcpy(&record, &data[offset], sizeof(record));
+			// 被覆盖的头部可能不完整，长度越界时不复制，由下面的检查重新开始
+			bool valid = record.size >= sizeof(record) && record.size <= rest
+				&& record.length <= record.size - sizeof(record);
+			bool wanted = valid && record.level != LogBroadcast::skipLevel && record.level >= minLevel;
+			if (wanted) {
+				out.assign(&data[offset + sizeof(record)], record.length);
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (ring_.tail_.load(std::memory_order_relaxed) > pos_) {
+				continue;
+			}
+			if (!valid) {
+				// 未被覆盖的头部不会越界，出现时跳到最新位置
+				pos_ = head;
+				started_ = false;
+				continue;
+			}
+			pos_ += record.size;
+			if (record.level == LogBroadcast::skipLevel) {
+				continue;
+			}
+			if (started_ && record.seq > nextSeq_) {
+				lost_ += record.seq - nextSeq_;
+			}
+			started_ = true;
+			nextSeq_ = record.seq + 1;
+			if (wanted) {
+				level = record.level;
+				return true;
+			}
+		}
+	}
+
+	// 因读取过慢被覆盖（或过长未发布）而错过的记录数
+	uint64_t lost() const {
+		return lost_;
+	}
+
+private:
+	const LogBroadcast& ring_;  // 所属环
+	uint64_t pos_;              // 下一条记录的位置
+	uint64_t nextSeq_;          // 期望的下一条记录序号
+	bool started_;              // 已知期望序号（从最早记录开始时读到第一条之后），此后才统计丢失
+	uint64_t lost_;             // 错过的记录数
+};
+
+#endif // LOG_BROADCAST_H
@@ -0,0 +1,205 @@
+/******************************************************************************/
+/* File Name:    LogClock.h                                                  */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Clock source used by the C11 Logger. Producers only read a  */
+/*               raw 64-bit tick; the backend converts it to Unix epoch     */
+/*               nanoseconds.                                                */
+/*----------------------------------------------------------------------------*/
+/* Details:                                                                  */
+/*   - SYSTEM: std::chrono::system_clock, tick is epoch nanoseconds.         */
+/*   - COARSE: CLOCK_REALTIME_COARSE (Linux), tick is epoch nanoseconds,     */
+/*     resolution is one scheduler tick (1-4 ms). Falls back to SYSTEM.      */
+/*   - TSC:    rdtsc, tick is CPU cycles, converted with a calibration that  */
+/*     is refreshed about once per second. Requires an invariant TSC and    */
+/*     falls back to SYSTEM otherwise.                                       */
+/*   - Records that already carry epoch nanoseconds (e.g. from another     */
+/*     process) use fromNanos(); under TSC the tick is tagged with the top */
+/*     bit and toNanos() returns it unchanged.                              */
+/******************************************************************************/
+
+#ifndef LOG_CLOCK_H
+#define LOG_CLOCK_H
+
+#include <cstdint>
+#include <chrono>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define LOG_CLOCK_HAS_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#include <cpuid.h>
+#define LOG_CLOCK_HAS_TSC 1
+#endif
+
+#ifdef __linux__
+#include <time.h>
+#endif
+
+enum class LogClockType {// 时钟源
+	SYSTEM,
+	COARSE,
+	TSC
+};
+
+class LogClock {
+public:
+	explicit LogClock(LogClockType type = LogClockType::SYSTEM)
+		: type_(resolveType(type)), startTick_(0), startNanos_(0), baseTick_(0), baseNanos_(0),
+		nanosPerTick_(1.0), ticksPerSecond_(0), nextCalibrateTick_(0) {
+		if (type_ == LogClockType::TSC) {
+			initCalibration();
+		}
+	}
+
+	// 实际使用的时钟源（不支持时回退为 SYSTEM）
+	LogClockType type() const {
+		return type_;
+	}
+
+	// 读取原始时钟值，生产者线程调用
+	uint64_t now() const {
+		switch (type_) {
+		case LogClockType::TSC:
+			return readTsc();
+		case LogClockType::COARSE:
+			return coarseNanos();
+		default:
+			return systemNanos();
+		}
+	}
+
+	// 已是 Unix 纪元纳秒的时间作为时钟值，TSC 时以最高位标记，换算时不经校准原样取回
+	uint64_t fromNanos(uint64_t nanos) const {
+		return type_ == LogClockType::TSC ? nanos | wallTickFlag_ : nanos;
+	}
+
+	// 线程安全的换算：SYSTEM、COARSE 和 fromNanos 的值直接取回，TSC 时钟值以当前系统时钟代替
+	uint64_t wallNanos(uint64_t tick) const {
+		if (type_ != LogClockType::TSC) {
+			return tick;
+		}
+		return (tick & wallTickFlag_) != 0 ? tick & ~wallTickFlag_ : systemNanos();
+	}
+
+	// 将原始时钟值转换为 Unix 纪元纳秒，非线程安全，由写日志线程（持锁）调用
+	uint64_t toNanos(uint64_t tick) {
+		if (type_ != LogClockType::TSC) {
+			return tick;
+		}
+		if ((tick & wallTickFlag_) != 0) {
+			return tick & ~wallTickFlag_;
+		}
+		if (tick >= nextCalibrateTick_) {
+			recalibrate();
+		}
+		int64_t delta = static_cast<int64_t>(tick - baseTick_);
+		return baseNanos_ + static_cast<int64_t>(static_cast<double>(delta) * nanosPerTick_);
+	}
+
+	// 返回 Unix 纪元时间，精确到纳秒
+	static uint64_t systemNanos() {
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count());
+	}
+
+	// 返回低精度 Unix 纪元时间（纳秒单位）
+	static uint64_t coarseNanos() {
+#if defined(__linux__) && defined(CLOCK_REALTIME_COARSE)
+		struct timespec ts;
+		clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+		return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+#else
+		return systemNanos();
+#endif
+	}
+
+	// 读取 CPU 时间戳计数器
+	static uint64_t readTsc() {
+#ifdef LOG_CLOCK_HAS_TSC
+		return __rdtsc();
+#else
+		return systemNanos();
+#endif
+	}
+
+private:
+	static const uint64_t calibrateSpinNanos_ = 10 * 1000 * 1000;// 首次校准时长，10ms
+	static const uint64_t wallTickFlag_ = 1ull << 63;// fromNanos 的标记位，TSC 计数达不到
+
+	LogClockType type_;          // 时钟源
+	uint64_t startTick_;         // 首次校准点
+	uint64_t startNanos_;
+	uint64_t baseTick_;          // 最近一次校准点
+	uint64_t baseNanos_;
+	double nanosPerTick_;        // 每个 tick 对应的纳秒数
+	uint64_t ticksPerSecond_;    // 每秒 tick 数
+	uint64_t nextCalibrateTick_; // 下次校准的 tick
+
+	// 检查平台支持，不支持时回退为 SYSTEM
+	static LogClockType resolveType(LogClockType type) {
+		if (type == LogClockType::TSC && !hasInvariantTsc()) {
+			return LogClockType::SYSTEM;
+		}
+#if !defined(__linux__) || !defined(CLOCK_REALTIME_COARSE)
+		if (type == LogClockType::COARSE) {
+			return LogClockType::SYSTEM;
+		}
+#endif
+		return type;
+	}
+
+	// CPUID.80000007H:EDX[8]，TSC 频率不随 CPU 频率和休眠状态变化
+	static bool hasInvariantTsc() {
+#if defined(_MSC_VER) && defined(LOG_CLOCK_HAS_TSC)
+		int regs[4] = { 0 };
+		__cpuid(regs, 0x80000000);
+		if (static_cast<unsigned>(regs[0]) < 0x80000007u) {
+			return false;
+		}
+		__cpuid(regs, 0x80000007);
+		return (regs[3] & (1 << 8)) != 0;
+#elif defined(LOG_CLOCK_HAS_TSC)
+		unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+		if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007u) {
+			return false;
+		}
+		__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+		return (edx & (1u << 8)) != 0;
+#else
+		return false;
+#endif
+	}
+
+	// 忙等一小段时间估算 TSC 频率
+	void initCalibration() {
+		startNanos_ = systemNanos();
+		startTick_ = readTsc();
+		uint64_t nanos = startNanos_;
+		while (nanos - startNanos_ < calibrateSpinNanos_) {
+			nanos = systemNanos();
+		}
+		uint64_t tick = readTsc();
+		updateCalibration(tick, nanos);
+	}
+
+	// 以最新采样点为基准，频率取自首次校准点到当前的长基线
+	void recalibrate() {
+		uint64_t nanos = systemNanos();
+		uint64_t tick = readTsc();
+		updateCalibration(tick, nanos);
+	}
+
+	void updateCalibration(uint64_t tick, uint64_t nanos) {
+		if (tick > startTick_ && nanos > startNanos_) {
+			nanosPerTick_ = static_cast<double>(nanos - startNanos_) / static_cast<double>(tick - startTick_);
+			ticksPerSecond_ = static_cast<uint64_t>(1e9 / nanosPerTick_);
+		}
+		baseTick_ = tick;
+		baseNanos_ = nanos;
+		nextCalibrateTick_ = tick + ticksPerSecond_;
+	}
+};
+
+#endif // LOG_CLOCK_H
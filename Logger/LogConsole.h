@@ -0,0 +1,217 @@
+/******************************************************************************/
+/* File Name:    LogConsole.h                                                */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Console sink of the C11 Logger. Lines are written directly */
+/*               to the file descriptor, or, in async mode, appended to a   */
+/*               bounded buffer that a background thread writes with one    */
+/*               write() per batch.                                          */
+/*----------------------------------------------------------------------------*/
+/* Details:                                                                  */
+/*   - Overflow policy DROP (default): when the buffer is full the line is  */
+/*     dropped and counted, so a slow terminal or pipe never stalls the     */
+/*     caller; the number of dropped lines is reported on the console once */
+/*     it catches up. BLOCK waits for space instead and loses nothing.      */
+/*   - Colouring wraps the level text of a line in a constant ANSI code.    */
+/******************************************************************************/
+
+#ifndef LOG_CONSOLE_H
+#define LOG_CONSOLE_H
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// 异步控制台缓冲区满时的处理方式
+enum class LogConsoleOverflow {
+	DROP,  // 丢弃并计数，不阻塞调用方
+	BLOCK  // 等待缓冲区有空间
+};
+
+class LogConsole {
+public:
+	explicit LogConsole(int fd = 1)
+		: fd_(fd), async_(false), exit_(false), capacity_(0), overflow_(LogConsoleOverflow::DROP),
+		color_(false), dropped_(0), droppedReported_(0) {}
+
+	~LogConsole() {
+		stop();
+	}
+
+	// 开启异步输出：capacity 为等待写出的最大字节数
+	void start(LogConsoleOverflow overflow, size_t capacity) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		overflow_ = overflow;
+		capacity_ = capacity;
+		if (!async_) {
+			async_ = true;
+			exit_ = false;
+			pending_.reserve(capacity);
+			thread_ = std::thread(&LogConsole::run, this);
+		}
+	}
+
+	// 写出剩余内容后关闭异步输出，之后的行直接写出
+	void stop() {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (!async_) {
+				return;
+			}
+			exit_ = true;
+			dataCond_.notify_one();
+		}
+		thread_.join();
+		std::lock_guard<std::mutex> lock(mutex_);
+		async_ = false;
+	}
+
+	// 是否给等级着色（ANSI 转义序列）
+	void setColor(bool enable) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		color_ = enable;
+	}
+
+	// 写一行（不含换行）；level 为 0-3 且开启着色时给 [levelBegin, levelEnd) 着色
+	void writeLine(const char* text, size_t len, int level = -1, size_t levelBegin = 0, size_t levelEnd = 0) {
+		std::unique_lock<std::mutex> lock(mutex_);
+		bool colored = color_ && level >= 0 && level < 4 && levelBegin < levelEnd && levelEnd <= len;
+		size_t size = len + 1 + (colored ? levelColorSize_ + resetSize_ : 0);
+		if (!async_) {
+			direct_.clear();
+			append(direct_, text, len, colored ? level : -1, levelBegin, levelEnd);
+			writeAll(direct_.data(), direct_.size());
+			return;
+		}
+		if (pending_.size() + size > capacity_ && !pending_.empty()) {
+			if (overflow_ == LogConsoleOverflow::DROP) {
+				dropped_.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			spaceCond_.wait(lock, [&]() { return pending_.size() + size <= capacity_ || pending_.empty() || !async_; });
+		}
+		bool wake = pending_.empty();
+		append(pending_, text, len, colored ? level : -1, levelBegin, levelEnd);
+		if (wake) {
+			dataCond_.notify_one();
+		}
+	}
+
+	// 因缓冲区满丢弃的行数
+	uint64_t dropped() const {
+		return dropped_.load(std::memory_order_relaxed);
+	}
+
+	// 文件描述符是否为终端
+	static bool isTerminal(int fd) {
+#ifdef _WIN32
+		return _isatty(fd) != 0;
+#else
+		return isatty(fd) != 0;
+#endif
+	}
+
+private:
+	LogConsole(const LogConsole&);
+	LogConsole& operator=(const LogConsole&);
+
+	static const size_t levelColorSize_ = 5;// 等级颜色序列长度，见 levelColor_
+	static const size_t resetSize_ = 4;     // "\033[0m" 长度
+
+	int fd_;                                // 输出的文件描述符
+	std::mutex mutex_;                      // 缓冲区锁
+	std::condition_variable dataCond_;      // 有待写出的内容
+	std::condition_variable spaceCond_;     // 缓冲区有空间（BLOCK）
+	std::string pending_;                   // 待写出的内容
+	std::string writing_;                   // 正在写出的内容，仅后台线程使用
+	std::string direct_;                    // 同步写出时的拼接缓冲区
+	std::thread thread_;                    // 后台写出线程
+	bool async_;                            // 是否异步输出
+	bool exit_;                             // 后台线程退出标识
+	size_t capacity_;                       // 待写出内容的最大字节数
+	LogConsoleOverflow overflow_;           // 缓冲区满时的处理方式
+	bool color_;                            // 是否着色
+	std::atomic<uint64_t> dropped_;         // 丢弃的行数
+	uint64_t droppedReported_;              // 已提示过的丢弃行数，仅后台线程使用
+
+	static const char* levelColor(int level) {
+		// DEBUG 青色，INFO 绿色，WARNING 黄色，ERROR 红色
+		static const char* const colors[4] = { "\033[36m", "\033[32m", "\033[33m", "\033[31m" };
+		return colors[level];
+	}
+
+	static void append(std::string& out, const char* text, size_t len, int level, size_t levelBegin, size_t levelEnd) {
+		if (level >= 0) {
+			out.append(text, levelBegin);
+			out.append(levelColor(level), levelColorSize_);
+			out.append(text + levelBegin, levelEnd - levelBegin);
+			out.append("\033[0m", resetSize_);
+			out.append(text + levelEnd, len - levelEnd);
+		}
+		else {
+			out.append(text, len);
+		}
+		out.push_back('\n');
+	}
+
+	void run() {
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				dataCond_.wait(lock, [this]() { return !pending_.empty() || exit_; });
+				if (pending_.empty()) {
+					break;
+				}
+				pending_.swap(writing_);
+				spaceCond_.notify_all();
+			}
+			// 一批一次 write，慢终端只阻塞本线程
+			writeAll(writing_.data(), writing_.size());
+			writing_.clear();
+			uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+			if (dropped != droppedReported_) {
+				char note[64];
+				int length = snprintf(note, sizeof(note), "... %llu console lines dropped\n",
+					static_cast<unsigned long long>(dropped - droppedReported_));
+				writeAll(note, static_cast<size_t>(length));
+				droppedReported_ = dropped;
+			}
+		}
+	}
+
+	void writeAll(const char* data, size_t len) {
+		while (len > 0) {
+#ifdef _WIN32
+			int written = _write(fd_, data, static_cast<unsigned int>(len > 0x40000000 ? 0x40000000 : len));
+#else
+			ssize_t written = ::write(fd_, data, len);
+#endif
+			if (written < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				if (errno == EAGAIN) {// 非阻塞输出暂时写不进时稍后重试
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+					continue;
+				}
+				return;
+			}
+			data += written;
+			len -= static_cast<size_t>(written);
+		}
+	}
+};
+
+#endif // LOG_CONSOLE_H
@@ -0,0 +1,144 @@
+/******************************************************************************/
+/* File Name:    LogCoroutine.h                                              */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  C++20 awaitables for the C11 Logger: enqueue that         */
+/*               suspends instead of sleeping while the async queue is     */
+/*               full, and flush that suspends until the records are      */
+/*               written.                                                    */
+/*----------------------------------------------------------------------------*/
+/* Usage:                                                                    */
+/*   #include "Logger.h"                                                     */
+/*   #include "LogCoroutine.h"                                               */
+/*                                                                           */
+/*   co_await logEnqueue(logger, Logger::LogLevel::LOG_INFO, "done");        */
+/*   co_await logFlush(logger);                                              */
+/*----------------------------------------------------------------------------*/
+/* Details:                                                                  */
+/*   - Requires C++20; Logger.h itself stays C++11 and is included first   */
+/*     (this header sits next to the Windows Logger.h and does not include */
+/*     it).                                                                  */
+/*   - A suspended coroutine is resumed by the logger's writer thread. Pass */
+/*     a LogResumer that posts the handle to your executor so that the     */
+/*     coroutine continues there; without one it runs on the writer thread */
+/*     until its next suspension and must not call the blocking flush().   */
+/*   - The message is not copied before the enqueue: it must stay valid    */
+/*     until co_await returns, which holds for temporaries in the co_await */
+/*     expression.                                                           */
+/*   - After a wakeup the record is enqueued even if the queue has filled  */
+/*     up again, so the queue bound can be exceeded by the number of       */
+/*     waiting coroutines.                                                   */
+/******************************************************************************/
+
+#ifndef LOG_COROUTINE_H
+#define LOG_COROUTINE_H
+
+#ifndef LOGGER_H
+#error "include Logger.h (the C11 version) before LogCoroutine.h"
+#endif
+
+#include <atomic>
+#include <coroutine>
+#include <cstring>
+#include <functional>
+#include <string>
+
+// 恢复挂起的协程，通常投递到调用方的执行器；为空时在写日志线程中直接恢复
+typedef std::function<void(std::coroutine_handle<>)> LogResumer;
+
+// 按 resumer 恢复协程，resumer 为空时直接恢复
+inline void logResume(const LogResumer& resumer, std::coroutine_handle<> handle) {
+	if (resumer) {
+		resumer(handle);
+	}
+	else {
+		handle.resume();
+	}
+}
+
+// co_await logEnqueue(...)：队列未满时直接入队，不挂起；队列满时挂起，写日志线程取走队列后恢复并入队
+class LogEnqueueAwaitable {
+public:
+	LogEnqueueAwaitable(Logger& logger, Logger::LogLevel level, const char* message, size_t len, LogResumer resumer)
+		: logger_(logger), level_(level), message_(message), len_(len), resumer_(std::move(resumer)), enqueued_(false) {}
+
+	bool await_ready() {
+		enqueued_ = logger_.tryLog(message_, len_, level_);
+		return enqueued_;
+	}
+
+	// 登记失败说明队列已有空位，不挂起，由 await_resume 入队
+	bool await_suspend(std::coroutine_handle<> handle) {
+		LogResumer resumer = resumer_;
+		return logger_.waitQueueSpace([resumer, handle]() {
+			logResume(resumer, handle);
+		});
+	}
+
+	void await_resume() {
+		if (!enqueued_) {
+			logger_.tryLog(message_, len_, level_, true);
+		}
+	}
+
+private:
+	Logger& logger_;          // 所属日志器
+	Logger::LogLevel level_;  // 日志等级
+	const char* message_;     // 消息，不复制
+	size_t len_;              // 消息长度
+	LogResumer resumer_;      // 恢复方式
+	bool enqueued_;           // await_ready 中已入队
+};
+
+// co_await logFlush(...)：调用前提交的所有日志落盘后恢复（同步模式下不挂起）
+class LogFlushAwaitable {
+public:
+	LogFlushAwaitable(Logger& logger, LogResumer resumer)
+		: logger_(logger), resumer_(std::move(resumer)), arrived_(false) {}
+
+	bool await_ready() const {
+		return false;
+	}
+
+	// 回调与本函数各交换一次标记，后到的一方负责继续：回调先到（同步模式）时不挂起
+	bool await_suspend(std::coroutine_handle<> handle) {
+		handle_ = handle;
+		logger_.flushAsync([this]() {
+			if (arrived_.exchange(true)) {
+				// 恢复后本对象随协程帧失效，先复制
+				LogResumer resumer = resumer_;
+				logResume(resumer, handle_);
+			}
+		});
+		return !arrived_.exchange(true);
+	}
+
+	void await_resume() const {}
+
+private:
+	Logger& logger_;                  // 所属日志器
+	LogResumer resumer_;              // 恢复方式
+	std::coroutine_handle<> handle_;  // 挂起的协程
+	std::atomic<bool> arrived_;       // 回调或 await_suspend 已到达
+};
+
+inline LogEnqueueAwaitable logEnqueue(Logger& logger, Logger::LogLevel level, const char* message, size_t len,
+	LogResumer resumer = LogResumer()) {
+	return LogEnqueueAwaitable(logger, level, message, len, std::move(resumer));
+}
+
+inline LogEnqueueAwaitable logEnqueue(Logger& logger, Logger::LogLevel level, const char* message,
+	LogResumer resumer = LogResumer()) {
+	return LogEnqueueAwaitable(logger, level, message, strlen(message), std::move(resumer));
+}
+
+inline LogEnqueueAwaitable logEnqueue(Logger& logger, Logger::LogLevel level, const std::string& message,
+	LogResumer resumer = LogResumer()) {
+	return LogEnqueueAwaitable(logger, level, message.data(), message.size(), std::move(resumer));
+}
+
+inline LogFlushAwaitable logFlush(Logger& logger, LogResumer resumer = LogResumer()) {
+	return LogFlushAwaitable(logger, std::move(resumer));
+}
+
+#endif // LOG_COROUTINE_H
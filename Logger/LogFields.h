@@ -0,0 +1,345 @@
+/******************************************************************************/
+/* File Name:    LogFields.h                                                 */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Typed key-value fields for structured logging, their      */
+/*               binary encoding and rendering as text (key=value) or as   */
+/*               JSON members.                                               */
+/*----------------------------------------------------------------------------*/
+/* Usage:                                                                    */
+/*   logger.info("request done", kv("user", id), kv("latency_us", t));       */
+/*----------------------------------------------------------------------------*/
+/* Details:                                                                  */
+/*   - kv() only stores the key, the type and the value (strings by        */
+/*     pointer), so the arguments must outlive the logging call only.     */
+/*   - The producer copies message and fields into one binary record      */
+/*     without formatting; numbers are turned into text when the record   */
+/*     is written (in the writer thread in async mode).                     */
+/*   - Encoding: u32 message length, message, u8 field count, then per    */
+/*     field u8 type, u8 key length, key and the value (8 bytes for        */
+/*     numbers, 1 for bool, u32 length + bytes for strings). Keys longer   */
+/*     than 255 bytes and fields beyond 255 are cut.                        */
+/******************************************************************************/
+
+#ifndef LOG_FIELDS_H
+#define LOG_FIELDS_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include "LogSanitize.h"
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <string_view>
+#endif
+
+// 一个键值字段，由 kv() 创建
+struct LogField {
+	enum Type : uint8_t {
+		INT64,
+		UINT64,
+		DOUBLE,
+		BOOL,
+		STRING
+	};
+
+	const char* key;      // 键，不复制
+	size_t keyLen;        // 键长度
+	Type type;            // 值类型
+	union {
+		int64_t i;
+		uint64_t u;
+		double d;
+		bool b;
+	} value;              // 数值
+	const char* text;     // 字符串值，不复制
+	size_t textLen;       // 字符串值长度
+
+	LogField(const char* name, Type fieldType) : key(name), keyLen(strlen(name)), type(fieldType), text(nullptr), textLen(0) {
+		value.u = 0;
+	}
+};
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, LogField>::type
+kv(const char* key, T value) {
+	LogField field(key, LogField::INT64);
+	field.value.i = static_cast<int64_t>(value);
+	return field;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value, LogField>::type
+kv(const char* key, T value) {
+	LogField field(key, LogField::UINT64);
+	field.value.u = static_cast<uint64_t>(value);
+	return field;
+}
+
+inline LogField kv(const char* key, bool value) {
+	LogField field(key, LogField::BOOL);
+	field.value.b = value;
+	return field;
+}
+
+inline LogField kv(const char* key, double value) {
+	LogField field(key, LogField::DOUBLE);
+	field.value.d = value;
+	return field;
+}
+
+inline LogField kv(const char* key, float value) {
+	return kv(key, static_cast<double>(value));
+}
+
+inline LogField kv(const char* key, const char* value, size_t len) {
+	LogField field(key, LogField::STRING);
+	field.text = value;
+	field.textLen = len;
+	return field;
+}
+
+inline LogField kv(const char* key, const char* value) {
+	return kv(key, value != nullptr ? value : "", value != nullptr ? strlen(value) : 0);
+}
+
+inline LogField kv(const char* key, const std::string& value) {
+	return kv(key, value.data(), value.size());
+}
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+inline LogField kv(const char* key, std::string_view value) {
+	return kv(key, value.data(), value.size());
+}
+#endif
+
+namespace LogFieldCodec {
+
+	// 消息和字段编码为二进制，追加到 out
+	inline void encode(std::string& out, const char* message, size_t len, const LogField* fields, size_t count) {
+		uint32_t length = static_cast<uint32_t>(len);
+		out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+		out.append(message, len);
+		count = count > 255 ? 255 : count;
+		out.push_back(static_cast<char>(count));
+		for (size_t i = 0; i < count; ++i) {
+			const LogField& field = fields[i];
+			size_t keyLen = field.keyLen > 255 ? 255 : field.keyLen;
+			out.push_back(static_cast<char>(field.type));
+			out.push_back(static_cast<char>(keyLen));
+			out.append(field.key, keyLen);
+			switch (field.type) {
+			case LogField::BOOL:
+				out.push_back(field.value.b ? 1 : 0);
+				break;
+			case LogField::STRING:
+				length = static_cast<uint32_t>(field.textLen);
+				out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+				out.append(field.text, field.textLen);
+				break;
+			default:
+				out.append(reinterpret_cast<const char*>(&field.value), 8);
+				break;
+			}
+		}
+	}
+
+	// 追加 JSON 字符串内容（不含引号）：转义引号、反斜杠和控制字符，其余字节原样追加
+	inline void appendJsonEscaped(std::string& out, const char* text, size_t len) {
+		LogSanitize::appendJson(out, text, len, false);
+	}
+
+	inline void appendUnsigned(std::string& out, uint64_t value) {
+		char digits[20];
+		size_t count = 0;
+		do {
+			digits[count++] = static_cast<char>('0' + value % 10);
+			value /= 10;
+		} while (value != 0);
+		while (count > 0) {
+			out.push_back(digits[--count]);
+		}
+	}
+
+	inline void appendSigned(std::string& out, int64_t value) {
+		if (value < 0) {
+			out.push_back('-');
+			appendUnsigned(out, 0 - static_cast<uint64_t>(value));
+		}
+		else {
+			appendUnsigned(out, static_cast<uint64_t>(value));
+		}
+	}
+
+	// 浮点数按最短可还原的精度输出；json 为 true 时 NaN 和无穷输出为 null
+	inline void appendDouble(std::string& out, double value, bool json) {
+		if (value != value || value - value != 0) {
+			out.append(json ? "null" : (value != value ? "nan" : (value > 0 ? "inf" : "-inf")));
+			return;
+		}
+		char text[32];
+		int length = snprintf(text, sizeof(text), "%.15g", value);
+		if (length > 0 && strtod(text, nullptr) != value) {
+			length = snprintf(text, sizeof(text), "%.17g", value);
+		}
+		if (length > 0) {
+			out.append(text, static_cast<size_t>(length));
+		}
+	}
+
+	// 逐个读取编码后的字段
+	class Reader {
+	public:
+		Reader(const char* data, size_t len) : data_(data), end_(data + len), remaining_(0), messageLen_(0) {
+			uint32_t length = 0;
+			if (len >= sizeof(length)) {
+				memcpy(&length, data_, sizeof(length));
+				data_ += sizeof(length);
+			}
+			message_ = data_;
+			messageLen_ = length <= static_cast<size_t>(end_ - data_) ? length : static_cast<size_t>(end_ - data_);
+			data_ += messageLen_;
+			if (data_ < end_) {
+				remaining_ = static_cast<unsigned char>(*data_++);
+			}
+		}
+
+		const char* message() const { return message_; }
+		size_t messageLen() const { return messageLen_; }
+
+		// 读取下一个字段，没有更多字段或数据不完整时返回 false
+		bool next(LogField::Type& type, const char*& key, size_t& keyLen, const char*& value, size_t& valueLen) {
+			if (remaining_ == 0 || end_ - data_ < 2) {
+				return false;
+			}
+			--remaining_;
+			type = static_cast<LogField::Type>(static_cast<unsigned char>(data_[0]));
+			keyLen = static_cast<unsigned char>(data_[1]);
+			data_ += 2;
+			if (static_cast<size_t>(end_ - data_) < keyLen) {
+				return false;
+			}
+			key = data_;
+			data_ += keyLen;
+			if (type == LogField::STRING) {
+				uint32_t length;
+				if (static_cast<size_t>(end_ - data_) < sizeof(length)) {
+					return false;
+				}
+				memcpy(&length, data_, sizeof(length));
+				data_ += sizeof(length);
+				valueLen = length;
+			}
+			else {
+				valueLen = type == LogField::BOOL ? 1 : 8;
+			}
+			if (static_cast<size_t>(end_ - data_) < valueLen) {
+				return false;
+			}
+			value = data_;
+			data_ += valueLen;
+			return true;
+		}
+
+	private:
+		const char* data_;
+		const char* end_;
+		const char* message_;
+		size_t remaining_;
+		size_t messageLen_;
+	};
+
+	// 追加数值或布尔值
+	inline void appendScalar(std::string& out, LogField::Type type, const char* value, bool json) {
+		if (type == LogField::BOOL) {
+			out.append(value[0] != 0 ? "true" : "false");
+			return;
+		}
+		uint64_t bits;
+		memcpy(&bits, value, sizeof(bits));
+		if (type == LogField::INT64) {
+			appendSigned(out, static_cast<int64_t>(bits));
+		}
+		else if (type == LogField::UINT64) {
+			appendUnsigned(out, bits);
+		}
+		else {
+			double number;
+			memcpy(&number, &bits, sizeof(number));
+			appendDouble(out, number, json);
+		}
+	}
+
+	// 文本格式："message key=value key2=\"a b\""，字符串含空格、引号、'=' 或控制字符时加引号并转义；
+	// sanitize 为 true 时消息和字符串值还转义控制字符和非法 UTF-8（见 LogSanitize）
+	inline void renderText(std::string& out, const char* data, size_t len, bool sanitize = false) {
+		Reader reader(data, len);
+		if (sanitize) {
+			LogSanitize::appendText(out, reader.message(), reader.messageLen());
+		}
+		else {
+			out.append(reader.message(), reader.messageLen());
+		}
+		LogField::Type type;
+		const char* key;
+		const char* value;
+		size_t keyLen;
+		size_t valueLen;
+		while (reader.next(type, key, keyLen, value, valueLen)) {
+			out.push_back(' ');
+			out.append(key, keyLen);
+			out.push_back('=');
+			if (type != LogField::STRING) {
+				appendScalar(out, type, value, false);
+				continue;
+			}
+			bool quote = valueLen == 0;
+			for (size_t i = 0; i < valueLen && !quote; ++i) {
+				unsigned char c = static_cast<unsigned char>(value[i]);
+				quote = c <= ' ' || c == '"' || c == '=' || c == '\\';
+			}
+			if (quote) {
+				out.push_back('"');
+				LogSanitize::appendJson(out, value, valueLen, sanitize);
+				out.push_back('"');
+			}
+			else if (sanitize) {
+				LogSanitize::appendText(out, value, valueLen);
+			}
+			else {
+				out.append(value, valueLen);
+			}
+		}
+	}
+
+	// JSON 成员：“"msg":"...","key":value,...”（不含花括号）；sanitize 为 true 时非法 UTF-8 替换为 \ufffd
+	inline void renderJson(std::string& out, const char* data, size_t len, bool sanitize = false) {
+		Reader reader(data, len);
+		out.append("\"msg\":\"", 7);
+		LogSanitize::appendJson(out, reader.message(), reader.messageLen(), sanitize);
+		out.push_back('"');
+		LogField::Type type;
+		const char* key;
+		const char* value;
+		size_t keyLen;
+		size_t valueLen;
+		while (reader.next(type, key, keyLen, value, valueLen)) {
+			out.append(",\"", 2);
+			LogSanitize::appendJson(out, key, keyLen, sanitize);
+			out.append("\":", 2);
+			if (type == LogField::STRING) {
+				out.push_back('"');
+				LogSanitize::appendJson(out, value, valueLen, sanitize);
+				out.push_back('"');
+			}
+			else {
+				appendScalar(out, type, value, true);
+			}
+		}
+	}
+}
+
+#endif // LOG_FIELDS_H
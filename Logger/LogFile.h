@@ -0,0 +1,429 @@
+/******************************************************************************/
+/* File Name:    LogFile.h                                                   */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Append-only log file on a plain file descriptor with a     */
+/*               user-space buffer, used by the C11 Logger instead of       */
+/*               std::ofstream so that page-cache writes and data syncs can */
+/*               be requested explicitly.                                    */
+/*----------------------------------------------------------------------------*/
+/* Details:                                                                  */
+/*   - write() only appends to the buffer; flush() hands it to the kernel   */
+/*     (page cache); sync() additionally waits for the disk (fdatasync,     */
+/*     fsync on macOS, _commit on Windows).                                  */
+/*   - The file is opened in binary append mode; line endings are written  */
+/*     by the caller.                                                        */
+/*   - LogCacheMode::DIRECT (Linux) writes complete 4 KB blocks with      */
+/*     O_DIRECT at explicit offsets, so log data does not stay in the page */
+/*     cache. flush() writes the partial last block through a second,     */
+/*     buffered descriptor with its exact length, so the file is always   */
+/*     byte-accurate; the block stays in the buffer and is written with    */
+/*     O_DIRECT once it is complete, which also evicts its cached page.    */
+/*     File systems without O_DIRECT fall back to DONTNEED.                  */
+/*   - LogCacheMode::DONTNEED writes through the page cache, starts        */
+/*     writeback of new data and drops pages one window (1 MB) behind the  */
+/*     end with posix_fadvise; sync() drops the whole file. macOS uses    */
+/*     F_NOCACHE instead; Windows always writes through the page cache.    */
+/******************************************************************************/
+
+#ifndef LOG_FILE_H
+#define LOG_FILE_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// 日志文件对页缓存的使用方式
+enum class LogCacheMode {
+	NORMAL,   // 经页缓存写入
+	DIRECT,   // O_DIRECT 按 4KB 对齐的块写入，不进入页缓存；不支持时退回 DONTNEED
+	DONTNEED  // 经页缓存写入，写回后用 posix_fadvise(DONTNEED) 丢弃
+};
+
+class LogFile {
+public:
+	LogFile() : fd_(-1), size_(0), mode_(LogCacheMode::NORMAL), active_(LogCacheMode::NORMAL), direct_(nullptr),
+		directUsed_(0), directStart_(0), tailFd_(-1), tailWritten_(0), dropped_(0) {
+		buffer_.reserve(bufferSize_);
+	}
+
+	~LogFile() {
+		close();
+		freeDirect();
+	}
+
+	// 以追加方式打开（不存在时创建），size() 为打开时的文件长度
+	bool open(const std::string& path) {
+		close();
+		path_ = path;
+		active_ = LogCacheMode::NORMAL;
+		dropped_ = 0;
+#ifdef _WIN32
+		fd_ = _open(path.c_str(), _O_WRONLY | _O_APPEND | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+		if (fd_ >= 0) {
+			__int64 end = _lseeki64(fd_, 0, SEEK_END);
+			size_ = end > 0 ? static_cast<uint64_t>(end) : 0;
+		}
+#else
+		if (mode_ == LogCacheMode::DIRECT && openDirect(path)) {
+			return true;
+		}
+		fd_ = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+		if (fd_ >= 0) {
+			off_t end = lseek(fd_, 0, SEEK_END);
+			size_ = end > 0 ? static_cast<uint64_t>(end) : 0;
+			if (mode_ != LogCacheMode::NORMAL) {
+				active_ = LogCacheMode::DONTNEED;
+#if defined(__APPLE__) && defined(F_NOCACHE)
+				fcntl(fd_, F_NOCACHE, 1);
+#endif
+			}
+		}
+#endif
+		return fd_ >= 0;
+	}
+
+	// 设置页缓存使用方式，已打开时写出缓冲区后重新打开；返回实际生效的方式（未打开时为请求的方式）
+	LogCacheMode setCacheMode(LogCacheMode mode) {
+		mode_ = mode;
+		if (fd_ < 0) {
+			return mode;
+		}
+		std::string path = path_;
+		close();
+		open(path);
+		return active_;
+	}
+
+	// 当前文件实际使用的方式
+	LogCacheMode cacheMode() const {
+		return active_;
+	}
+
+	bool is_open() const {
+		return fd_ >= 0;
+	}
+
+	// 文件长度，含缓冲区中尚未写入的部分
+	uint64_t size() const {
+		return size_;
+	}
+
+	// 追加到缓冲区，缓冲区满时写入内核
+	void write(const char* data, size_t len) {
+		if (active_ == LogCacheMode::DIRECT) {
+			writeDirect(data, len);
+			return;
+		}
+		if (buffer_.size() + len > bufferSize_) {
+			flush();
+		}
+		if (len >= bufferSize_) {
+			writeAll(data, len);
+			dropBehind();
+		}
+		else {
+			buffer_.append(data, len);
+		}
+		size_ += len;
+	}
+
+	// 缓冲区写入内核（页缓存）；DIRECT 时写入含末尾不完整块在内的全部数据
+	bool flush() {
+		if (active_ == LogCacheMode::DIRECT) {
+			return flushDirect(true);
+		}
+		if (buffer_.empty()) {
+			return true;
+		}
+		bool ok = writeAll(buffer_.data(), buffer_.size());
+		buffer_.clear();
+		dropBehind();
+		return ok;
+	}
+
+	// 写入内核并等待数据落盘
+	bool sync() {
+		bool ok = flush();
+		ok = syncHandle(fd_) && ok;
+#if !defined(_WIN32) && defined(POSIX_FADV_DONTNEED)
+		// 已落盘的页可以全部丢弃
+		if (active_ == LogCacheMode::DONTNEED && fd_ >= 0) {
+			posix_fadvise(fd_, 0, 0, POSIX_FADV_DONTNEED);
+			dropped_ = size_;
+		}
+#endif
+		return ok;
+	}
+
+	// 写入剩余数据并关闭
+	void close() {
+		if (fd_ < 0) {
+			return;
+		}
+		flush();
+#ifdef _WIN32
+		_close(fd_);
+#else
+		::close(fd_);
+		if (tailFd_ >= 0) {
+			::close(tailFd_);
+			tailFd_ = -1;
+		}
+#endif
+		fd_ = -1;
+		size_ = 0;
+		directUsed_ = 0;
+		directStart_ = 0;
+		tailWritten_ = 0;
+	}
+
+	// 复制文件描述符，用于在不持有写锁时落盘；用完后由 closeHandle 关闭
+	int duplicateHandle() const {
+		if (fd_ < 0) {
+			return -1;
+		}
+#ifdef _WIN32
+		return _dup(fd_);
+#else
+		return fcntl(fd_, F_DUPFD_CLOEXEC, 0);
+#endif
+	}
+
+	// 等待文件描述符上已写入的数据落盘
+	static bool syncHandle(int fd) {
+		if (fd < 0) {
+			return false;
+		}
+#if defined(_WIN32)
+		return _commit(fd) == 0;
+#elif defined(__APPLE__)
+		return fsync(fd) == 0;
+#else
+		return fdatasync(fd) == 0;
+#endif
+	}
+
+	// 丢弃文件在页缓存中的页，需在落盘后调用
+	static void dropHandle(int fd) {
+#if !defined(_WIN32) && defined(POSIX_FADV_DONTNEED)
+		if (fd >= 0) {
+			posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+		}
+#else
+		(void)fd;
+#endif
+	}
+
+	static void closeHandle(int fd) {
+		if (fd >= 0) {
+#ifdef _WIN32
+			_close(fd);
+#else
+			::close(fd);
+#endif
+		}
+	}
+
+private:
+	LogFile(const LogFile&);
+	LogFile& operator=(const LogFile&);
+
+	static const size_t bufferSize_ = 64 * 1024;// 缓冲区大小
+	static const size_t blockSize_ = 4096;// DIRECT 写入的对齐单位
+	static const uint64_t dropWindow_ = 1024 * 1024;// DONTNEED 时保留在页缓存中的末尾长度
+
+	int fd_;                  // 文件描述符，-1 表示未打开
+	uint64_t size_;           // 文件长度
+	std::string buffer_;      // 尚未写入内核的数据
+	std::string path_;        // 文件路径，重新打开时使用
+	LogCacheMode mode_;       // 请求的页缓存使用方式，下次打开时生效
+	LogCacheMode active_;     // 当前文件实际使用的方式
+	char* direct_;            // DIRECT 的对齐缓冲区，长度 bufferSize_
+	size_t directUsed_;       // direct_ 中的有效字节数
+	uint64_t directStart_;    // direct_ 开头对应的文件偏移，按块对齐
+	int tailFd_;              // DIRECT 时写末尾不完整块的普通描述符（经页缓存）
+	size_t tailWritten_;      // 末尾不完整块中已经由 tailFd_ 写出的字节数
+	uint64_t dropped_;        // DONTNEED 已丢弃到的文件偏移
+
+#ifndef _WIN32
+	// 以 O_DIRECT 打开，另开一个普通描述符写末尾不完整的块；文件长度不是块的整数倍时把末尾的块读入缓冲区。
+	// 失败时返回 false，由调用方普通打开
+	bool openDirect(const std::string& path) {
+#ifdef O_DIRECT
+		if (direct_ == nullptr) {
+			void* memory = nullptr;
+			if (posix_memalign(&memory, blockSize_, bufferSize_) != 0) {
+				return false;
+			}
+			direct_ = static_cast<char*>(memory);
+		}
+		tailFd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+		fd_ = tailFd_ >= 0 ? ::open(path.c_str(), O_WRONLY | O_CLOEXEC | O_DIRECT) : -1;
+		bool ok = fd_ >= 0;
+		if (ok) {
+			off_t end = lseek(fd_, 0, SEEK_END);
+			size_ = end > 0 ? static_cast<uint64_t>(end) : 0;
+			directStart_ = size_ - size_ % blockSize_;
+			directUsed_ = static_cast<size_t>(size_ - directStart_);
+			tailWritten_ = directUsed_;
+			ok = directUsed_ == 0
+				|| pread(tailFd_, direct_, directUsed_, static_cast<off_t>(directStart_)) == static_cast<ssize_t>(directUsed_);
+		}
+		if (!ok) {
+			closeHandle(fd_);
+			closeHandle(tailFd_);
+			fd_ = tailFd_ = -1;
+			directUsed_ = tailWritten_ = 0;
+			return false;
+		}
+		active_ = LogCacheMode::DIRECT;
+		return true;
+#else
+		(void)path;
+		return false;
+#endif
+	}
+
+	// 复制到对齐缓冲区，写满时写出整块
+	void writeDirect(const char* data, size_t len) {
+		while (len > 0) {
+			size_t n = bufferSize_ - directUsed_ < len ? bufferSize_ - directUsed_ : len;
+			memcpy(direct_ + directUsed_, data, n);
+			directUsed_ += n;
+			size_ += n;
+			data += n;
+			len -= n;
+			if (directUsed_ == bufferSize_) {
+				flushDirect(false);
+				if (active_ != LogCacheMode::DIRECT) {
+					write(data, len);
+					return;
+				}
+			}
+		}
+	}
+
+	// 以 O_DIRECT 写出缓冲区中的整块；tail 为 true 时末尾不完整的块中尚未写出的部分经 tailFd_ 按实际长度写出。
+	// 不完整的块留在缓冲区开头，写满后以 O_DIRECT 在同一偏移再写一次，内核随之丢弃它的缓存页
+	bool flushDirect(bool tail) {
+		size_t full = directUsed_ - directUsed_ % blockSize_;
+		bool ok = true;
+		if (full > 0) {
+			ok = pwriteAll(fd_, direct_, full, directStart_);
+			if (!ok && errno == EINVAL) {
+				// 文件系统不支持 O_DIRECT：退回经页缓存写入，按实际长度重写
+				return fallbackFromDirect();
+			}
+			size_t rest = directUsed_ - full;
+			if (rest > 0) {
+				memmove(direct_, direct_ + full, rest);
+			}
+			directStart_ += full;
+			directUsed_ = rest;
+			tailWritten_ = 0;
+		}
+		if (tail && directUsed_ > tailWritten_) {
+			ok = pwriteAll(tailFd_, direct_ + tailWritten_, directUsed_ - tailWritten_, directStart_ + tailWritten_) && ok;
+			tailWritten_ = directUsed_;
+		}
+		return ok;
+	}
+
+	bool fallbackFromDirect() {
+		active_ = LogCacheMode::DONTNEED;
+		int flags = fcntl(fd_, F_GETFL, 0);
+#ifdef O_DIRECT
+		flags &= ~O_DIRECT;
+#endif
+		fcntl(fd_, F_SETFL, flags);
+		bool ok = pwriteAll(fd_, direct_, directUsed_, directStart_);
+		// 之后按普通方式追加
+		fcntl(fd_, F_SETFL, flags | O_APPEND);
+		directUsed_ = 0;
+		tailWritten_ = 0;
+		return ok;
+	}
+
+	static bool pwriteAll(int fd, const char* data, size_t len, uint64_t offset) {
+		while (len > 0) {
+			ssize_t written = pwrite(fd, data, len, static_cast<off_t>(offset));
+			if (written < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				return false;
+			}
+			data += written;
+			len -= static_cast<size_t>(written);
+			offset += static_cast<uint64_t>(written);
+		}
+		return true;
+	}
+#else
+	void writeDirect(const char*, size_t) {}
+	bool flushDirect(bool) { return true; }
+#endif
+
+	void freeDirect() {
+#ifndef _WIN32
+		free(direct_);
+#endif
+		direct_ = nullptr;
+	}
+
+	// DONTNEED：开始写回新写入的数据，丢弃离末尾超过一个窗口的页（通常已写回，等待很短）
+	void dropBehind() {
+#if !defined(_WIN32) && defined(POSIX_FADV_DONTNEED)
+		if (active_ != LogCacheMode::DONTNEED) {
+			return;
+		}
+		uint64_t written = size_ - buffer_.size();
+		if (written < dropped_ + 2 * dropWindow_) {
+			return;
+		}
+		uint64_t end = written - dropWindow_;
+		end -= end % blockSize_;
+#ifdef SYNC_FILE_RANGE_WRITE
+		sync_file_range(fd_, static_cast<off_t>(dropped_), static_cast<off_t>(end - dropped_),
+			SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+		sync_file_range(fd_, static_cast<off_t>(end), static_cast<off_t>(written - end), SYNC_FILE_RANGE_WRITE);
+#endif
+		posix_fadvise(fd_, static_cast<off_t>(dropped_), static_cast<off_t>(end - dropped_), POSIX_FADV_DONTNEED);
+		dropped_ = end;
+#endif
+	}
+
+	bool writeAll(const char* data, size_t len) {
+		while (len > 0) {
+#ifdef _WIN32
+			int written = _write(fd_, data, static_cast<unsigned int>(len > 0x40000000 ? 0x40000000 : len));
+#else
+			ssize_t written = ::write(fd_, data, len);
+#endif
+			if (written < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				return false;
+			}
+			data += written;
+			len -= static_cast<size_t>(written);
+		}
+		return true;
+	}
+};
+
+#endif // LOG_FILE_H
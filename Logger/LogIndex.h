@@ -0,0 +1,49 @@
+/******************************************************************************/
+/* File Name:    LogIndex.h                                                  */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  On-disk format of the sparse time index written next to     */
+/*               every log segment (YYYYMMDDHH_N.log -> YYYYMMDDHH_N.idx).   */
+/*----------------------------------------------------------------------------*/
+/* Details:                                                                  */
+/*   - 8-byte magic "LOGIDX01" followed by fixed 16-byte entries in native   */
+/*     byte order, appended by the writer as the segment grows.              */
+/*   - An entry is emitted for the first line of a segment and then every    */
+/*     64 KB or every second (configurable), whichever comes first.         */
+/*   - Times are local wall-clock nanoseconds, i.e. the text timestamp of    */
+/*     the line read as if it were UTC, truncated to the rendered precision */
+/*     (see Logger::setTimePrecision). An entry therefore equals the time   */
+/*     parsed from the "[YYYY-MM-DD HH:MM:SS.fff" prefix of its line and   */
+/*     compares directly with it, without any time zone lookup.             */
+/******************************************************************************/
+
+#ifndef LOG_INDEX_H
+#define LOG_INDEX_H
+
+#include <cstdint>
+
+// 索引文件魔数
+static const char logIndexMagic[8] = { 'L', 'O', 'G', 'I', 'D', 'X', '0', '1' };
+
+// 索引项
+struct LogIndexEntry {
+	uint64_t wallNanos; // 该行日志的本地挂钟时间，纳秒
+	uint64_t offset;    // 该行在日志文件中的字节偏移
+};
+
+// 公历日期转换为 1970-01-01 起的天数
+inline int64_t logDaysFromCivil(int year, int month, int day) {
+	year -= month <= 2 ? 1 : 0;
+	int64_t era = (year >= 0 ? year : year - 399) / 400;
+	int64_t yearOfEra = year - era * 400;
+	int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+	int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+	return era * 146097 + dayOfEra - 719468;
+}
+
+// 本地挂钟时间（秒），不含时区换算
+inline int64_t logWallSeconds(int year, int month, int day, int hour, int minute, int second) {
+	return logDaysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+}
+
+#endif // LOG_INDEX_H
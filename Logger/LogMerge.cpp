@@ -0,0 +1,155 @@
+#include "LogMerge.h"
+#include "LogReader.h"
+#include <queue>
+
+// 一个来源的读取位置：当前映射的日志文件和当前日志
+class LogMerger::Source {
+public:
+	Source(const std::vector<std::string>& segments, size_t order)
+		: segments_(segments), segmentIndex_(0), order_(order), pos_(nullptr), end_(nullptr),
+		record_(nullptr), length_(0), wallNanos_(0) {}
+
+	// 读取下一条日志，没有时返回 false
+	bool next() {
+		while (pos_ >= end_) {
+			if (!openNextSegment()) {
+				return false;
+			}
+		}
+
+		const char* begin = pos_;
+		const char* lineEnd = findLineEnd(begin);
+		LogLineInfo info;
+		if (parseLogLine(begin, lineEnd, info)) {
+			wallNanos_ = info.wallNanos;
+		}// 段开头的续行沿用上一条日志的时间
+
+		// 合并之后没有前缀的续行
+		const char* p = lineEnd < end_ ? lineEnd + 1 : end_;
+		while (p < end_) {
+			const char* nextEnd = findLineEnd(p);
+			if (parseLogLine(p, nextEnd, info)) {
+				break;
+			}
+			lineEnd = nextEnd;
+			p = nextEnd < end_ ? nextEnd + 1 : end_;
+		}
+
+		record_ = begin;
+		length_ = lineEnd - begin;
+		pos_ = p;
+		return true;
+	}
+
+	uint64_t wallNanos() const {
+		return wallNanos_;
+	}
+
+	size_t order() const {
+		return order_;
+	}
+
+	const char* record() const {
+		return record_;
+	}
+
+	size_t length() const {
+		return length_;
+	}
+
+private:
+	std::vector<std::string> segments_; // 按时间顺序排列的日志文件
+	size_t segmentIndex_;               // 下一个要打开的文件
+	size_t order_;                      // 来源序号，时间相同时按序号输出
+	LogMappedFile file_;                // 当前映射的日志文件
+	const char* pos_;                   // 下一条日志的位置
+	const char* end_;                   // 当前文件末尾
+	const char* record_;                // 当前日志
+	size_t length_;                     // 当前日志长度（不含最后的换行）
+	uint64_t wallNanos_;                // 当前日志时间
+
+	const char* findLineEnd(const char* begin) const {
+		const char* newline = static_cast<const char*>(memchr(begin, '\n', end_ - begin));
+		return newline != nullptr ? newline : end_;
+	}
+
+	bool openNextSegment() {
+		while (segmentIndex_ < segments_.size()) {
+			const std::string& path = segments_[segmentIndex_++];
+			if (!file_.open(path)) {
+				fprintf(stderr, "Failed to open file: %s\n", path.c_str());
+				continue;
+			}
+			pos_ = file_.data();
+			end_ = file_.data() + file_.size();
+			return true;
+		}
+		file_.close();
+		pos_ = end_ = nullptr;
+		return false;
+	}
+};
+
+LogMerger::LogMerger() {
+}
+
+LogMerger::~LogMerger() {
+	for (size_t i = 0; i < sources_.size(); ++i) {
+		delete sources_[i];
+	}
+}
+
+void LogMerger::addSource(const std::vector<std::string>& segments) {
+	sources_.push_back(new Source(segments, sources_.size()));
+}
+
+uint64_t LogMerger::merge(const std::function<void(const char* record, size_t len)>& output) {
+	struct Later {
+		bool operator()(const Source* a, const Source* b) const {
+			if (a->wallNanos() != b->wallNanos()) {
+				return a->wallNanos() > b->wallNanos();
+			}
+			return a->order() > b->order();
+		}
+	};
+	std::priority_queue<Source*, std::vector<Source*>, Later> heap;
+	for (size_t i = 0; i < sources_.size(); ++i) {
+		if (sources_[i]->next()) {
+			heap.push(sources_[i]);
+		}
+	}
+
+	uint64_t count = 0;
+	while (!heap.empty()) {
+		Source* source = heap.top();
+		heap.pop();
+		output(source->record(), source->length());
+		++count;
+		if (source->next()) {
+			heap.push(source);
+		}
+	}
+	return count;
+}
+
+uint64_t LogMerger::mergeTo(FILE* out) {
+	static const size_t bufferSize = 1024 * 1024;
+	std::vector<char> buffer;
+	buffer.reserve(bufferSize);
+	uint64_t count = merge([&](const char* record, size_t len) {
+		if (buffer.size() + len + 1 > bufferSize) {
+			fwrite(buffer.data(), 1, buffer.size(), out);
+			buffer.clear();
+		}
+		if (len + 1 > bufferSize) {// 超长日志直接输出
+			fwrite(record, 1, len, out);
+			fputc('\n', out);
+			return;
+		}
+		buffer.insert(buffer.end(), record, record + len);
+		buffer.push_back('\n');
+	});
+	fwrite(buffer.data(), 1, buffer.size(), out);
+	fflush(out);
+	return count;
+}
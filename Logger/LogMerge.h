@@ -0,0 +1,47 @@
+/******************************************************************************/
+/* File Name:    LogMerge.h                                                  */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Streaming k-way merge of log segments into one time-ordered */
+/*               stream, e.g. the _0/_1/... segments of several processes.   */
+/*----------------------------------------------------------------------------*/
+/* Details:                                                                  */
+/*   - A source is a list of segments that are already in time order, such  */
+/*     as all segments of one log folder. Sources are merged with a binary  */
+/*     heap keyed on the prefix timestamp; equal times keep source order.   */
+/*   - Only the current segment of every source is mapped, and output goes  */
+/*     through one fixed buffer, so memory use does not grow with input.    */
+/*   - Lines without a prefix stay attached to the record before them.      */
+/******************************************************************************/
+
+#ifndef LOG_MERGE_H
+#define LOG_MERGE_H
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+class LogMerger {
+public:
+	LogMerger();
+	~LogMerger();
+
+	// 添加一个来源：按时间顺序排列的日志文件
+	void addSource(const std::vector<std::string>& segments);
+
+	// 按时间归并所有来源，每条日志（含续行，不含最后的换行）回调一次，返回日志条数
+	uint64_t merge(const std::function<void(const char* record, size_t len)>& output);
+
+	// 归并输出到文件，返回日志条数
+	uint64_t mergeTo(FILE* out);
+
+private:
+	LogMerger(const LogMerger&);
+	LogMerger& operator=(const LogMerger&);
+
+	class Source;
+	std::vector<Source*> sources_;// 各来源的读取位置
+};
+
+#endif // LOG_MERGE_H
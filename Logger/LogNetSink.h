@@ -0,0 +1,508 @@
+/******************************************************************************/
+/* File Name:    LogNetSink.h                                                */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Network sink of the C11 Logger: formatted records are      */
+/*               batched in a bounded buffer and sent without blocking to  */
+/*               a local collector over a Unix domain socket, TCP or UDP.  */
+/*----------------------------------------------------------------------------*/
+/* Details:                                                                  */
+/*   - Endpoints: "unix:/path/to/socket", "tcp:host:port", "udp:host:port". */
+/*     The host is resolved once when the sink is opened.                    */
+/*   - Framing LENGTH_PREFIXED sends a 4-byte little-endian length before  */
+/*     every record (without line end); LINES sends the same bytes as the */
+/*     log file, each record followed by the line end.                     */
+/*   - append() copies into the buffer; flush() sends what the socket      */
+/*     takes without waiting and keeps the rest. append() never waits:    */
+/*     when the buffer is full it tries one non-blocking send, and if that */
+/*     frees no room it fails and the caller writes the record to its     */
+/*     file instead. The next append() or flush() retries the send.       */
+/*   - When the connection fails the socket is closed and reopened with    */
+/*     exponential backoff (100 ms to 5 s); records stay in the buffer     */
+/*     meanwhile. A partly sent record is sent again in full on the new    */
+/*     connection, so the collector must drop an incomplete trailing frame */
+/*     when a connection closes. Bytes already taken by the kernel are    */
+/*     lost if the collector exits before reading them.                     */
+/*   - UDP packs whole records into datagrams of up to 60000 bytes and     */
+/*     cannot tell whether the collector received them.                     */
+/*   - Not thread-safe: the Logger calls it under its file lock.           */
+/*   - Windows needs _WIN32_WINNT >= 0x0600 (WSAPoll) and ws2_32; MSVC     */
+/*     links it through #pragma comment, CMake for MinGW.                  */
+/******************************************************************************/
+
+#ifndef LOG_NET_SINK_H
+#define LOG_NET_SINK_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string>
+
+#ifdef _WIN32
+// WSAPoll 需要 Windows Vista 及以上
+#ifndef _WIN32_WINNT
+#define _WIN32_WINNT 0x0600
+#elif _WIN32_WINNT < 0x0600
+#error "LogNetSink.h requires _WIN32_WINNT >= 0x0600 (WSAPoll)"
+#endif
+// winsock2.h 必须先于 windows.h 包含
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "ws2_32.lib")
+#endif
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// 网络输出的记录格式
+enum class LogNetFraming {
+	LENGTH_PREFIXED, // 4 字节小端长度 + 记录（不含换行符）
+	LINES            // 与日志文件相同的字节，每条记录后接换行符
+};
+
+class LogNetSink {
+public:
+	LogNetSink() : transport_(Transport::NONE), framing_(LogNetFraming::LENGTH_PREFIXED), capacity_(0), addressLen_(0),
+		socket_(invalidSocket()), connecting_(false), sent_(0), frameStart_(0), backoffMillis_(0), reconnects_(0) {
+		memset(&address_, 0, sizeof(address_));
+	}
+
+	~LogNetSink() {
+		close();
+	}
+
+	// 解析端点并开始连接（不等待连接完成）；格式错误、主机无法解析或平台不支持时返回 false。
+	// bufferBytes 为待发送缓冲区上限
+	bool open(const std::string& endpoint, LogNetFraming framing, size_t bufferBytes) {
+		close();
+		if (!resolve(endpoint)) {
+			return false;
+		}
+		framing_ = framing;
+		capacity_ = bufferBytes;
+		backoffMillis_ = 0;
+		nextAttempt_ = std::chrono::steady_clock::time_point();
+		connect();
+		return true;
+	}
+
+	// 关闭连接并丢弃待发送的数据，需要保留时先调用 drain()
+	void close() {
+		closeSocket();
+		transport_ = Transport::NONE;
+		buffer_.clear();
+		frameEnds_.clear();
+		sent_ = 0;
+		frameStart_ = 0;
+	}
+
+	bool isOpen() const {
+		return transport_ != Transport::NONE;
+	}
+
+	// 是否已连接（TCP 连接建立中时为 false）
+	bool connected() const {
+		return socket_ != invalidSocket() && !connecting_;
+	}
+
+	// 加入一条记录（data 不含换行符），不等待：缓冲区满时先不等待地发送一次，仍放不下时返回 false
+	bool append(const char* data, size_t len, const char* lineEnd) {
+		size_t lineEndLen = strlen(lineEnd);
+		size_t frameLen = framing_ == LogNetFraming::LINES ? len + lineEndLen : len + 4;
+		if (frameLen > pendingLimit()) {
+			return false;
+		}
+		if (pendingBytes() + frameLen > capacity_) {
+			flush();
+			if (pendingBytes() + frameLen > capacity_) {
+				return false;
+			}
+		}
+		if (framing_ == LogNetFraming::LENGTH_PREFIXED) {
+			uint32_t size = static_cast<uint32_t>(len);
+			char prefix[4] = { static_cast<char>(size), static_cast<char>(size >> 8), static_cast<char>(size >> 16),
+				static_cast<char>(size >> 24) };
+			buffer_.append(prefix, 4);
+			buffer_.append(data, len);
+		}
+		else {
+			buffer_.append(data, len);
+			buffer_.append(lineEnd, lineEndLen);
+		}
+		frameEnds_.push_back(buffer_.size());
+		return true;
+	}
+
+	// 不等待地发送缓冲区中的记录；未连接且到了重试时间时先重新连接
+	void flush() {
+		if (!isOpen()) {
+			return;
+		}
+		if (socket_ == invalidSocket()) {
+			if (frameEnds_.empty() || std::chrono::steady_clock::now() < nextAttempt_) {
+				return;
+			}
+			connect();
+		}
+		if (connecting_ && !finishConnect()) {
+			return;
+		}
+		if (socket_ == invalidSocket()) {
+			return;
+		}
+		if (transport_ == Transport::UDP) {
+			sendDatagrams();
+		}
+		else if (!peerClosed()) {
+			sendStream();
+		}
+		compact();
+	}
+
+	// 取出所有未发送完的记录，按日志文件的格式（记录 + 换行符）交给 write(const char*, size_t)，然后清空缓冲区
+	template <typename Write>
+	void drain(const char* lineEnd, Write write) {
+		size_t begin = frameStart_;
+		for (size_t i = 0; i < frameEnds_.size(); ++i) {
+			size_t end = frameEnds_[i];
+			if (framing_ == LogNetFraming::LENGTH_PREFIXED) {
+				write(buffer_.data() + begin + 4, end - begin - 4);
+				write(lineEnd, strlen(lineEnd));
+			}
+			else {
+				write(buffer_.data() + begin, end - begin);
+			}
+			begin = end;
+		}
+		buffer_.clear();
+		frameEnds_.clear();
+		sent_ = 0;
+		frameStart_ = 0;
+	}
+
+	// 未发送完的记录条数
+	size_t pendingRecords() const {
+		return frameEnds_.size();
+	}
+
+	// 未发送完的字节数
+	size_t pendingBytes() const {
+		return buffer_.size() - frameStart_;
+	}
+
+	// 连接断开后重新连接的次数
+	uint64_t reconnects() const {
+		return reconnects_;
+	}
+
+private:
+	LogNetSink(const LogNetSink&);
+	LogNetSink& operator=(const LogNetSink&);
+
+	enum class Transport {
+		NONE,
+		UNIX,
+		TCP,
+		UDP
+	};
+
+#ifdef _WIN32
+	typedef SOCKET Socket;
+#else
+	typedef int Socket;
+#endif
+
+	static Socket invalidSocket() {
+#ifdef _WIN32
+		return INVALID_SOCKET;
+#else
+		return -1;
+#endif
+	}
+
+	// 单条记录的上限：UDP 受报文长度限制，其他不超过缓冲区
+	size_t pendingLimit() const {
+		return transport_ == Transport::UDP ? maxDatagram_ : capacity_;
+	}
+
+	static bool wouldBlock() {
+#ifdef _WIN32
+		int error = WSAGetLastError();
+		return error == WSAEWOULDBLOCK || error == WSAEINPROGRESS;
+#else
+		return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINPROGRESS || errno == EINTR;
+#endif
+	}
+
+	// 解析 "unix:/path"、"tcp:host:port"、"udp:host:port" 到 address_
+	bool resolve(const std::string& endpoint) {
+		size_t colon = endpoint.find(':');
+		if (colon == std::string::npos) {
+			return false;
+		}
+		std::string scheme = endpoint.substr(0, colon);
+		std::string rest = endpoint.substr(colon + 1);
+		memset(&address_, 0, sizeof(address_));
+		if (scheme == "unix") {
+#ifdef _WIN32
+			return false;
+#else
+			sockaddr_un* address = reinterpret_cast<sockaddr_un*>(&address_);
+			if (rest.empty() || rest.size() >= sizeof(address->sun_path)) {
+				return false;
+			}
+			address->sun_family = AF_UNIX;
+			memcpy(address->sun_path, rest.data(), rest.size());
+			addressLen_ = static_cast<int>(offsetof(sockaddr_un, sun_path) + rest.size() + 1);
+			transport_ = Transport::UNIX;
+			return true;
+#endif
+		}
+		if (scheme != "tcp" && scheme != "udp") {
+			return false;
+		}
+		// 端口在最后一个冒号之后，IPv6 地址可以写成 [::1]:port
+		size_t portColon = rest.rfind(':');
+		if (portColon == std::string::npos || portColon + 1 == rest.size()) {
+			return false;
+		}
+		std::string host = rest.substr(0, portColon);
+		std::string port = rest.substr(portColon + 1);
+		if (host.size() >= 2 && host[0] == '[' && host[host.size() - 1] == ']') {
+			host = host.substr(1, host.size() - 2);
+		}
+#ifdef _WIN32
+		static bool started = false;
+		if (!started) {
+			WSADATA data;
+			started = WSAStartup(MAKEWORD(2, 2), &data) == 0;
+		}
+#endif
+		addrinfo hints;
+		memset(&hints, 0, sizeof(hints));
+		hints.ai_family = AF_UNSPEC;
+		hints.ai_socktype = scheme == "tcp" ? SOCK_STREAM : SOCK_DGRAM;
+		addrinfo* result = nullptr;
+		if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &result) != 0 || result == nullptr) {
+			return false;
+		}
+		bool found = result->ai_addrlen <= sizeof(address_);
+		if (found) {
+			memcpy(&address_, result->ai_addr, result->ai_addrlen);
+			addressLen_ = static_cast<int>(result->ai_addrlen);
+			transport_ = scheme == "tcp" ? Transport::TCP : Transport::UDP;
+		}
+		freeaddrinfo(result);
+		return found;
+	}
+
+	// 创建非阻塞套接字并发起连接，失败时安排下一次重试
+	void connect() {
+		int family = reinterpret_cast<const sockaddr*>(&address_)->sa_family;
+		socket_ = ::socket(family, transport_ == Transport::UDP ? SOCK_DGRAM : SOCK_STREAM, 0);
+		if (socket_ == invalidSocket()) {
+			scheduleRetry();
+			return;
+		}
+#ifdef _WIN32
+		u_long nonBlocking = 1;
+		ioctlsocket(socket_, FIONBIO, &nonBlocking);
+#else
+		fcntl(socket_, F_SETFL, fcntl(socket_, F_GETFL, 0) | O_NONBLOCK);
+		fcntl(socket_, F_SETFD, FD_CLOEXEC);
+#ifdef SO_NOSIGPIPE
+		int one = 1;
+		setsockopt(socket_, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+#endif
+		if (transport_ == Transport::TCP) {
+			int noDelay = 1;
+			setsockopt(socket_, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+		}
+		if (::connect(socket_, reinterpret_cast<const sockaddr*>(&address_), addressLen_) == 0) {
+			connecting_ = false;
+			connectedNow();
+		}
+		else if (wouldBlock() && transport_ == Transport::TCP) {
+			connecting_ = true;
+		}
+		else {
+			failed();
+		}
+	}
+
+	// 检查进行中的 TCP 连接，建立后返回 true
+	bool finishConnect() {
+#ifdef _WIN32
+		WSAPOLLFD item = { socket_, POLLOUT, 0 };
+		int ready = WSAPoll(&item, 1, 0);
+#else
+		pollfd item = { socket_, POLLOUT, 0 };
+		int ready = ::poll(&item, 1, 0);
+#endif
+		if (ready == 0) {
+			return false;
+		}
+		int error = 0;
+		socklen_t errorLen = sizeof(error);
+		if (ready < 0 || getsockopt(socket_, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &errorLen) != 0
+			|| error != 0) {
+			failed();
+			return false;
+		}
+		connecting_ = false;
+		connectedNow();
+		return true;
+	}
+
+	// 收集器不回发数据，流套接字可读说明对端已关闭；在发送前发现可避免一批数据写入已关闭的连接
+	bool peerClosed() {
+#ifdef _WIN32
+		WSAPOLLFD item = { socket_, POLLIN, 0 };
+		int ready = WSAPoll(&item, 1, 0);
+#else
+		pollfd item = { socket_, POLLIN, 0 };
+		int ready = ::poll(&item, 1, 0);
+#endif
+		if (ready == 0) {
+			return false;
+		}
+		char byte;
+		if (ready > 0 && ::recv(socket_, &byte, 1, MSG_PEEK) > 0) {
+			return false;
+		}
+		failed();
+		return true;
+	}
+
+	void connectedNow() {
+		if (backoffMillis_ != 0) {
+			++reconnects_;
+		}
+		backoffMillis_ = 0;
+	}
+
+	// 连接失败或断开：关闭套接字，从未发送完的第一条记录开头重发
+	void failed() {
+		closeSocket();
+		sent_ = frameStart_;
+		scheduleRetry();
+	}
+
+	void scheduleRetry() {
+		backoffMillis_ = backoffMillis_ == 0 ? 100 : (backoffMillis_ * 2 > 5000 ? 5000 : backoffMillis_ * 2);
+		nextAttempt_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(backoffMillis_);
+	}
+
+	void closeSocket() {
+		if (socket_ != invalidSocket()) {
+#ifdef _WIN32
+			closesocket(socket_);
+#else
+			::close(socket_);
+#endif
+			socket_ = invalidSocket();
+		}
+		connecting_ = false;
+	}
+
+	// 非阻塞发送，返回发送的字节数，对端暂时收不下时返回 0，出错时返回 -1
+	long sendSome(const char* data, size_t len) {
+#ifdef _WIN32
+		int n = ::send(socket_, data, static_cast<int>(len > 0x7fffffff ? 0x7fffffff : len), 0);
+#elif defined(MSG_NOSIGNAL)
+		ssize_t n = ::send(socket_, data, len, MSG_NOSIGNAL);
+#else
+		ssize_t n = ::send(socket_, data, len, 0);
+#endif
+		if (n >= 0) {
+			return static_cast<long>(n);
+		}
+		return wouldBlock() ? 0 : -1;
+	}
+
+	void sendStream() {
+		while (sent_ < buffer_.size()) {
+			long n = sendSome(buffer_.data() + sent_, buffer_.size() - sent_);
+			if (n <= 0) {
+				if (n < 0) {
+					failed();
+				}
+				break;
+			}
+			sent_ += static_cast<size_t>(n);
+			}
+		while (!frameEnds_.empty() && frameEnds_.front() <= sent_) {
+			frameStart_ = frameEnds_.front();
+			frameEnds_.pop_front();
+		}
+	}
+
+	// 每个报文装入尽量多的整条记录
+	void sendDatagrams() {
+		while (!frameEnds_.empty()) {
+			size_t count = 1;
+			while (count < frameEnds_.size() && frameEnds_[count] - frameStart_ <= maxDatagram_) {
+				++count;
+			}
+			size_t end = frameEnds_[count - 1];
+			long n = sendSome(buffer_.data() + frameStart_, end - frameStart_);
+			if (n <= 0) {
+				if (n < 0) {
+					failed();
+				}
+				break;
+			}
+			frameStart_ = sent_ = end;
+				frameEnds_.erase(frameEnds_.begin(), frameEnds_.begin() + static_cast<std::ptrdiff_t>(count));
+		}
+	}
+
+	// 已发送的部分超过一半时移到缓冲区开头
+	void compact() {
+		if (frameStart_ == buffer_.size()) {
+			buffer_.clear();
+			sent_ = frameStart_ = 0;
+		}
+		else if (frameStart_ >= 64 * 1024 && frameStart_ * 2 >= buffer_.size()) {
+			buffer_.erase(0, frameStart_);
+			for (size_t i = 0; i < frameEnds_.size(); ++i) {
+				frameEnds_[i] -= frameStart_;
+			}
+			sent_ -= frameStart_;
+			frameStart_ = 0;
+		}
+	}
+
+	static const size_t maxDatagram_ = 60000; // 单个 UDP 报文的最大字节数
+
+	Transport transport_;                                   // 传输方式，NONE 表示未开启
+	LogNetFraming framing_;                                 // 记录格式
+	size_t capacity_;                                       // 待发送缓冲区上限
+	sockaddr_storage address_;                              // 对端地址
+	int addressLen_;                                        // 对端地址长度
+	Socket socket_;                                         // 套接字，未连接时无效
+	bool connecting_;                                       // TCP 连接建立中
+	std::string buffer_;                                    // 待发送的记录
+	std::deque<size_t> frameEnds_;                          // 未发送完的各条记录在 buffer_ 中的结束位置
+	size_t sent_;                                           // buffer_ 中已发送到的位置
+	size_t frameStart_;                                     // 第一条未发送完的记录的开头
+	uint32_t backoffMillis_;                                // 当前重试间隔，0 表示上次连接成功
+	std::chrono::steady_clock::time_point nextAttempt_;     // 下次重新连接的时间
+	uint64_t reconnects_;                                   // 断开后重新连接成功的次数
+};
+
+#endif // LOG_NET_SINK_H
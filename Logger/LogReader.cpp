@@ -0,0 +1,404 @@
+#include "LogReader.h"
+#include <algorithm>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+LogMappedFile::LogMappedFile()
+#ifdef _WIN32
+	: file_(INVALID_HANDLE_VALUE), mapping_(nullptr), data_(nullptr), size_(0) {
+#else
+	: fd_(-1), data_(nullptr), size_(0) {
+#endif
+}
+
+LogMappedFile::~LogMappedFile() {
+	close();
+}
+
+bool LogMappedFile::open(const std::string& path) {
+	close();
+#ifdef _WIN32
+	file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file_ == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file_, &fileSize)) {
+		close();
+		return false;
+	}
+	size_ = static_cast<size_t>(fileSize.QuadPart);
+	if (size_ == 0) {
+		return true;
+	}
+	mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping_ == nullptr) {
+		close();
+		return false;
+	}
+	data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+	if (data_ == nullptr) {
+		close();
+		return false;
+	}
+#else
+	fd_ = ::open(path.c_str(), O_RDONLY);
+	if (fd_ < 0) {
+		return false;
+	}
+	struct stat fileStat;
+	if (fstat(fd_, &fileStat) != 0) {
+		close();
+		return false;
+	}
+	size_ = static_cast<size_t>(fileStat.st_size);
+	if (size_ == 0) {
+		return true;
+	}
+	void* address = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+	if (address == MAP_FAILED) {
+		close();
+		return false;
+	}
+	madvise(address, size_, MADV_SEQUENTIAL);
+	data_ = static_cast<const char*>(address);
+#endif
+	return true;
+}
+
+void LogMappedFile::close() {
+#ifdef _WIN32
+	if (data_ != nullptr) {
+		UnmapViewOfFile(data_);
+	}
+	if (mapping_ != nullptr) {
+		CloseHandle(mapping_);
+		mapping_ = nullptr;
+	}
+	if (file_ != INVALID_HANDLE_VALUE) {
+		CloseHandle(file_);
+		file_ = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (data_ != nullptr) {
+		munmap(const_cast<char*>(data_), size_);
+	}
+	if (fd_ >= 0) {
+		::close(fd_);
+		fd_ = -1;
+	}
+#endif
+	data_ = nullptr;
+	size_ = 0;
+}
+
+// 读取固定位数的十进制数字
+static bool parseDigits(const char* p, int count, int& value) {
+	value = 0;
+	for (int i = 0; i < count; ++i) {
+		unsigned digit = static_cast<unsigned>(p[i] - '0');
+		if (digit > 9) {
+			return false;
+		}
+		value = value * 10 + static_cast<int>(digit);
+	}
+	return true;
+}
+
+const char* parseLogTime(const char* begin, const char* end, uint64_t& wallNanos) {
+	// YYYY-MM-DD HH:MM:SS
+	if (end - begin < 19 || begin[4] != '-' || begin[7] != '-' || begin[10] != ' ' || begin[13] != ':' || begin[16] != ':') {
+		return nullptr;
+	}
+	int year, month, day, hour, minute, second;
+	if (!parseDigits(begin, 4, year) || !parseDigits(begin + 5, 2, month) || !parseDigits(begin + 8, 2, day)
+		|| !parseDigits(begin + 11, 2, hour) || !parseDigits(begin + 14, 2, minute) || !parseDigits(begin + 17, 2, second)) {
+		return nullptr;
+	}
+	if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) {
+		return nullptr;
+	}
+
+	// 小数部分，0-9 位
+	const char* p = begin + 19;
+	uint64_t fraction = 0;
+	if (p < end && *p == '.') {
+		++p;
+		int digits = 0;
+		while (p < end && digits < 9 && static_cast<unsigned>(*p - '0') <= 9) {
+			fraction = fraction * 10 + static_cast<unsigned>(*p - '0');
+			++p;
+			++digits;
+		}
+		for (; digits < 9; ++digits) {
+			fraction *= 10;
+		}
+	}
+
+	wallNanos = static_cast<uint64_t>(logWallSeconds(year, month, day, hour, minute, second)) * 1000000000ull + fraction;
+	return p;
+}
+
+int parseLogLevel(const char* name, size_t len) {
+	static const char* names[] = { "DEBUG", "INFO", "WARNING", "ERROR" };
+	for (int i = 0; i < 4; ++i) {
+		if (strlen(names[i]) == len && memcmp(names[i], name, len) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+const char* logLevelName(int level) {
+	static const char* names[] = { "DEBUG", "INFO", "WARNING", "ERROR" };
+	return level >= 0 && level < 4 ? names[level] : "UNKNOWN";
+}
+
+bool parseLogLine(const char* begin, const char* end, LogLineInfo& info) {
+	if (begin >= end || *begin != '[') {
+		return false;
+	}
+	const char* p = parseLogTime(begin + 1, end, info.wallNanos);
+	if (p == nullptr || p >= end) {
+		return false;
+	}
+
+	// "[time LEVEL] " 或 "[time] [LEVEL] "
+	if (*p == ' ') {
+		++p;
+	}
+	else if (*p == ']' && end - p >= 3 && p[1] == ' ' && p[2] == '[') {
+		p += 3;
+	}
+	else {
+		return false;
+	}
+	const char* levelEnd = static_cast<const char*>(memchr(p, ']', end - p));
+	if (levelEnd == nullptr) {
+		return false;
+	}
+	info.level = parseLogLevel(p, levelEnd - p);
+	info.message = levelEnd + 1 < end && levelEnd[1] == ' ' ? levelEnd + 2 : levelEnd + 1;
+	return true;
+}
+
+std::string logIndexPath(const std::string& logPath) {
+	size_t pos = logPath.rfind(".log");
+	if (pos != std::string::npos && pos + 4 == logPath.size()) {
+		return logPath.substr(0, pos) + ".idx";
+	}
+	return logPath + ".idx";
+}
+
+bool readLogIndex(const std::string& indexPath, std::vector<LogIndexEntry>& entries) {
+	entries.clear();
+	FILE* file = fopen(indexPath.c_str(), "rb");
+	if (file == nullptr) {
+		return false;
+	}
+	char magic[sizeof(logIndexMagic)];
+	if (fread(magic, 1, sizeof(magic), file) != sizeof(magic) || memcmp(magic, logIndexMagic, sizeof(magic)) != 0) {
+		fclose(file);
+		return false;
+	}
+	LogIndexEntry entry;
+	while (fread(&entry, sizeof(entry), 1, file) == 1) {// 末尾不完整的项忽略
+		entries.push_back(entry);
+	}
+	fclose(file);
+	return true;
+}
+
+// 解析 "YYYYMMDD[HH]_N.log" 或分片文件 "YYYYMMDD[HH]_N.TID.log"，返回时间部分、编号和线程 ID（非分片文件为空）
+static bool parseSegmentName(const std::string& fileName, std::string& dateHour, int& sequence, std::string& threadId) {
+	size_t underscore = fileName.find('_');
+	if (underscore != 8 && underscore != 10) {
+		return false;
+	}
+	if (fileName.size() < underscore + 6 || fileName.compare(fileName.size() - 4, 4, ".log") != 0) {
+		return false;
+	}
+	for (size_t i = 0; i < underscore; ++i) {
+		if (static_cast<unsigned>(fileName[i] - '0') > 9) {
+			return false;
+		}
+	}
+	size_t stemEnd = fileName.size() - 4;
+	size_t dot = fileName.find('.', underscore);
+	threadId.clear();
+	if (dot < stemEnd) {
+		if (dot + 1 == stemEnd) {
+			return false;
+		}
+		for (size_t i = dot + 1; i < stemEnd; ++i) {
+			if (static_cast<unsigned>(fileName[i] - '0') > 9) {
+				return false;
+			}
+		}
+		threadId = fileName.substr(dot + 1, stemEnd - dot - 1);
+		stemEnd = dot;
+	}
+	if (stemEnd == underscore + 1) {
+		return false;
+	}
+	sequence = 0;
+	for (size_t i = underscore + 1; i < stemEnd; ++i) {
+		unsigned digit = static_cast<unsigned>(fileName[i] - '0');
+		if (digit > 9) {
+			return false;
+		}
+		sequence = sequence * 10 + static_cast<int>(digit);
+	}
+	dateHour = fileName.substr(0, underscore);
+	return true;
+}
+
+namespace {
+	struct SegmentName {
+		std::string dateHour;
+		int sequence;
+		std::string threadId;
+		std::string path;
+
+		bool operator<(const SegmentName& other) const {
+			if (threadId != other.threadId) {
+				return threadId < other.threadId;
+			}
+			if (dateHour != other.dateHour) {
+				return dateHour < other.dateHour;
+			}
+			return sequence < other.sequence;
+		}
+	};
+
+	// 文件夹中全部日志文件，按线程 ID、时间、编号排序
+	std::vector<SegmentName> collectSegments(const std::string& folder) {
+		std::vector<SegmentName> segments;
+
+#ifdef _WIN32
+		struct _finddata_t fileInfo;
+		intptr_t handle = _findfirst((folder + "\\*").c_str(), &fileInfo);
+		if (handle != -1) {
+			do {
+				SegmentName segment;
+				if (parseSegmentName(fileInfo.name, segment.dateHour, segment.sequence, segment.threadId)) {
+					segment.path = folder + "\\" + fileInfo.name;
+					segments.push_back(segment);
+				}
+			} while (_findnext(handle, &fileInfo) == 0);
+			_findclose(handle);
+		}
+#else
+		DIR* dir = opendir(folder.c_str());
+		if (dir != nullptr) {
+			struct dirent* entry;
+			while ((entry = readdir(dir)) != nullptr) {
+				SegmentName segment;
+				if (parseSegmentName(entry->d_name, segment.dateHour, segment.sequence, segment.threadId)) {
+					segment.path = folder + "/" + entry->d_name;
+					segments.push_back(segment);
+				}
+			}
+			closedir(dir);
+		}
+#endif
+
+		std::sort(segments.begin(), segments.end());
+		return segments;
+	}
+}
+
+std::vector<std::string> listLogSegments(const std::string& folder) {
+	std::vector<SegmentName> segments = collectSegments(folder);
+	std::vector<std::string> paths;
+	for (size_t i = 0; i < segments.size(); ++i) {
+		if (segments[i].threadId.empty()) {
+			paths.push_back(segments[i].path);
+		}
+	}
+	return paths;
+}
+
+std::vector<std::vector<std::string> > listLogSources(const std::string& folder) {
+	std::vector<SegmentName> segments = collectSegments(folder);
+	std::vector<std::vector<std::string> > sources;
+	for (size_t i = 0; i < segments.size(); ++i) {
+		if (i == 0 || segments[i].threadId != segments[i - 1].threadId) {
+			sources.push_back(std::vector<std::string>());
+		}
+		sources.back().push_back(segments[i].path);
+	}
+	return sources;
+}
+
+bool LogSegment::open(const std::string& logPath) {
+	path_ = logPath;
+	if (!file_.open(logPath)) {
+		return false;
+	}
+	readLogIndex(logIndexPath(logPath), index_);
+	// 索引可能比映射时的文件更新，去掉超出部分
+	while (!index_.empty() && index_.back().offset >= file_.size()) {
+		index_.pop_back();
+	}
+	return true;
+}
+
+void LogSegment::rangeOffsets(uint64_t from, uint64_t to, size_t& begin, size_t& end) const {
+	begin = 0;
+	end = size();
+	if (index_.empty()) {
+		return;
+	}
+
+	// 索引项按时间递增，二分查找；前后各多一个区块，容纳写入顺序与时间顺序的少量出入
+	// 第一个时间 >= from 的索引项之前的一个区块开始
+	std::vector<LogIndexEntry>::const_iterator first = std::lower_bound(index_.begin(), index_.end(), from,
+		[](const LogIndexEntry& entry, uint64_t time) { return entry.wallNanos < time; });
+	if (first != index_.begin()) {
+		begin = static_cast<size_t>((first - 1)->offset);
+	}
+
+	// 第一个时间 > to 的索引项之后的一个区块结束
+	std::vector<LogIndexEntry>::const_iterator last = std::upper_bound(first, index_.end(), to,
+		[](uint64_t time, const LogIndexEntry& entry) { return time < entry.wallNanos; });
+	if (last != index_.end() && last + 1 != index_.end()) {
+		end = static_cast<size_t>((last + 1)->offset);
+	}
+}
+
+size_t LogSegment::tailOffset(size_t lines, int minLevel, size_t& found) const {
+	found = 0;
+	if (lines == 0) {
+		return size();
+	}
+	const char* base = data();
+	size_t block = index_.size();
+	while (true) {
+		// 从最后一个区块开始，不够时每次向前扩展一个区块
+		size_t start = block > 0 ? static_cast<size_t>(index_[block - 1].offset) : 0;
+		std::vector<size_t> starts;// 满足等级的日志行首
+		forEachLogLine(base + start, base + size(), [&](const char* lineBegin, const char* lineEnd) {
+			LogLineInfo info;
+			if (parseLogLine(lineBegin, lineEnd, info) && info.level >= minLevel) {
+				starts.push_back(lineBegin - base);
+			}
+		});
+		if (starts.size() >= lines || start == 0) {
+			found = std::min(starts.size(), lines);
+			return starts.size() >= lines ? starts[starts.size() - lines] : start;
+		}
+		--block;
+	}
+}
@@ -0,0 +1,142 @@
+/******************************************************************************/
+/* File Name:    LogReader.h                                                 */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Read-side helpers for the files written by the C11 Logger:  */
+/*               memory-mapped segments, hand-rolled prefix parsing and      */
+/*               lookups through the sparse time index (LogIndex.h).        */
+/*----------------------------------------------------------------------------*/
+/* Details:                                                                  */
+/*   - Both prefix layouts are understood:                                   */
+/*       C11 version:     "[YYYY-MM-DD HH:MM:SS.fff LEVEL] message"          */
+/*       Windows version: "[YYYY-MM-DD HH:MM:SS.fff] [LEVEL] message"        */
+/*     The fraction may have 0-9 digits (see Logger::setTimePrecision).     */
+/*   - Lines without a prefix (multi-line messages) belong to the previous  */
+/*     record.                                                               */
+/******************************************************************************/
+
+#ifndef LOG_READER_H
+#define LOG_READER_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "LogIndex.h"
+
+// 只读内存映射文件
+class LogMappedFile {
+public:
+	LogMappedFile();
+	~LogMappedFile();
+
+	// 映射整个文件，空文件映射成功但 data() 为 nullptr
+	bool open(const std::string& path);
+
+	// 解除映射
+	void close();
+
+	const char* data() const {
+		return data_;
+	}
+
+	size_t size() const {
+		return size_;
+	}
+
+private:
+	LogMappedFile(const LogMappedFile&);
+	LogMappedFile& operator=(const LogMappedFile&);
+
+#ifdef _WIN32
+	void* file_;    // 文件句柄
+	void* mapping_; // 映射句柄
+#else
+	int fd_;        // 文件描述符
+#endif
+	const char* data_;
+	size_t size_;
+};
+
+// 一行日志的前缀信息
+struct LogLineInfo {
+	uint64_t wallNanos;  // 本地挂钟时间，纳秒，见 LogIndex.h
+	int level;           // 日志等级，与 Logger::LogLevel 顺序一致，-1 表示未知
+	const char* message; // 日志内容起始位置
+};
+
+// 解析 "YYYY-MM-DD HH:MM:SS[.fraction]"，成功返回时间之后的位置，失败返回 nullptr
+const char* parseLogTime(const char* begin, const char* end, uint64_t& wallNanos);
+
+// 解析一行日志的前缀，不是日志行首时返回 false
+bool parseLogLine(const char* begin, const char* end, LogLineInfo& info);
+
+// 日志等级名称转换为等级，未知时返回 -1
+int parseLogLevel(const char* name, size_t len);
+
+// 日志等级转换为名称
+const char* logLevelName(int level);
+
+// 日志文件对应的索引文件路径
+std::string logIndexPath(const std::string& logPath);
+
+// 读取索引文件，文件不存在或格式错误时返回 false
+bool readLogIndex(const std::string& indexPath, std::vector<LogIndexEntry>& entries);
+
+// 列出文件夹中的日志文件（YYYYMMDDHH_N.log，不含分片文件），按时间和编号排序
+std::vector<std::string> listLogSegments(const std::string& folder);
+
+// 按写入来源列出日志文件：非分片文件为一组，分片文件（YYYYMMDDHH_N.TID.log）每个线程一组，
+// 组内按时间和编号排序；每组内的行按时间有序，合并各组即得到完整的时间线
+std::vector<std::vector<std::string> > listLogSources(const std::string& folder);
+
+// 遍历 [begin, end) 内的行，回调参数为行首和行尾（不含换行），末尾不完整的行同样回调
+template <typename Func>
+void forEachLogLine(const char* begin, const char* end, Func func) {
+	while (begin < end) {
+		const char* newline = static_cast<const char*>(memchr(begin, '\n', end - begin));
+		const char* lineEnd = newline != nullptr ? newline : end;
+		const char* trimmed = lineEnd;
+		if (trimmed > begin && trimmed[-1] == '\r') {
+			--trimmed;
+		}
+		func(begin, trimmed);
+		begin = newline != nullptr ? newline + 1 : end;
+	}
+}
+
+// 日志文件及其时间索引
+class LogSegment {
+public:
+	// 映射日志文件并读取索引，索引可以不存在
+	bool open(const std::string& logPath);
+
+	const std::string& path() const {
+		return path_;
+	}
+
+	const char* data() const {
+		return file_.data();
+	}
+
+	size_t size() const {
+		return file_.size();
+	}
+
+	const std::vector<LogIndexEntry>& index() const {
+		return index_;
+	}
+
+	// 时间范围 [from, to] 需要扫描的字节区间（二分查找索引），前后各放宽一个索引区块
+	void rangeOffsets(uint64_t from, uint64_t to, size_t& begin, size_t& end) const;
+
+	// 满足 minLevel 的最后 lines 条日志的起始偏移，found 为找到的条数；不足 lines 条时返回 0，需向前一个文件继续查找
+	size_t tailOffset(size_t lines, int minLevel, size_t& found) const;
+
+private:
+	std::string path_;
+	LogMappedFile file_;
+	std::vector<LogIndexEntry> index_;
+};
+
+#endif // LOG_READER_H
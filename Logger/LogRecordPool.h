@@ -0,0 +1,289 @@
+/******************************************************************************/
+/* File Name:    LogRecordPool.h                                             */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Slab pool of fixed-size async log records with inline      */
+/*               message storage, and the intrusive queue that links them.  */
+/*----------------------------------------------------------------------------*/
+/* Details:                                                                  */
+/*   - A record holds up to LogPoolRecord::payloadSize bytes inline; longer */
+/*     messages continue in a chain of further records (spill chain).       */
+/*   - Records come from slabs of slabRecords records that are never freed;*/
+/*     the pool grows to the peak queue size and is then reused.            */
+/*   - Every thread keeps a small free-list cache and exchanges records     */
+/*     with the shared free list in batches, so acquiring and releasing a  */
+/*     record normally takes no lock. Records released by the writer thread */
+/*     flow back to the producers through the shared list.                  */
+/*   - The pool is shared by all loggers of the process and is never        */
+/*     destroyed, so thread caches may return records at any time.          */
+/******************************************************************************/
+
+#ifndef LOG_RECORD_POOL_H
+#define LOG_RECORD_POOL_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <string>
+
+// 池化的日志记录，也用作续块
+struct LogPoolRecord {
+	static const size_t payloadSize = 256;// 内联消息长度
+
+	LogPoolRecord* next;       // 队列或空闲链表中的下一条
+	LogPoolRecord* spill;      // 续块，消息超出内联长度时使用
+	uint64_t tick;             // 原始时钟值，见 LogClock
+	uint32_t length;           // 消息总长度
+	int32_t level;             // 日志等级
+	uint32_t contextLength;    // 消息开头的前缀长度（acquire 的 prefix，如线程上下文），其后为日志内容
+	char payload[payloadSize]; // 消息（前 payloadSize 字节）
+
+	// 消息复制到 out（覆盖原内容）
+	void copyMessage(std::string& out) const {
+		out.clear();
+		size_t remaining = length;
+		for (const LogPoolRecord* chunk = this; chunk != nullptr && remaining > 0; chunk = chunk->spill) {
+			size_t size = remaining < payloadSize ? remaining : payloadSize;
+			out.append(chunk->payload, size);
+			remaining -= size;
+		}
+	}
+};
+
+// 侵入式单向队列，不分配内存
+class LogRecordList {
+public:
+	LogRecordList() : head_(nullptr), tail_(nullptr), size_(0) {}
+
+	bool empty() const {
+		return head_ == nullptr;
+	}
+
+	size_t size() const {
+		return size_;
+	}
+
+	LogPoolRecord* front() const {
+		return head_;
+	}
+
+	void push_back(LogPoolRecord* record) {
+		record->next = nullptr;
+		if (tail_ != nullptr) {
+			tail_->next = record;
+		}
+		else {
+			head_ = record;
+		}
+		tail_ = record;
+		++size_;
+	}
+
+	LogPoolRecord* pop_front() {
+		LogPoolRecord* record = head_;
+		if (record != nullptr) {
+			head_ = record->next;
+			if (head_ == nullptr) {
+				tail_ = nullptr;
+			}
+			--size_;
+		}
+		return record;
+	}
+
+	// 将 other 的全部记录接到末尾，other 变为空
+	void append(LogRecordList& other) {
+		if (other.head_ == nullptr) {
+			return;
+		}
+		if (tail_ != nullptr) {
+			tail_->next = other.head_;
+		}
+		else {
+			head_ = other.head_;
+		}
+		tail_ = other.tail_;
+		size_ += other.size_;
+		other.head_ = nullptr;
+		other.tail_ = nullptr;
+		other.size_ = 0;
+	}
+
+	void swap(LogRecordList& other) {
+		std::swap(head_, other.head_);
+		std::swap(tail_, other.tail_);
+		std::swap(size_, other.size_);
+	}
+
+private:
+	LogPoolRecord* head_;
+	LogPoolRecord* tail_;
+	size_t size_;
+};
+
+class LogRecordPool {
+public:
+	static const size_t slabRecords = 1024;  // 每个 slab 的记录数
+	static const size_t cacheBatch = 64;     // 线程缓存与共享链表每次交换的记录数
+
+	// 进程内唯一的记录池，不析构
+	static LogRecordPool& instance() {
+		static LogRecordPool* pool = new LogRecordPool();
+		return *pool;
+	}
+
+	// 取记录并写入消息，超出内联长度的部分写入续块
+	LogPoolRecord* acquire(uint64_t tick, int level, const char* message, size_t len) {
+		return acquire(tick, level, nullptr, 0, message, len);
+	}
+
+	// 同上，消息为 prefix 与 message 相接（如线程上下文加日志内容），prefix 的长度记入 contextLength
+	LogPoolRecord* acquire(uint64_t tick, int level, const char* prefix, size_t prefixLen, const char* message, size_t len) {
+		LogPoolRecord* record = take();
+		record->next = nullptr;
+		record->tick = tick;
+		record->level = level;
+		record->length = static_cast<uint32_t>(prefixLen + len);
+		record->contextLength = static_cast<uint32_t>(prefixLen);
+		LogPoolRecord* chunk = record;
+		size_t used = 0;
+		append(chunk, used, prefix, prefixLen);
+		append(chunk, used, message, len);
+		chunk->spill = nullptr;
+		return record;
+	}
+
+	// 归还记录及其续块
+	void release(LogPoolRecord* record) {
+		while (record != nullptr) {
+			LogPoolRecord* spill = record->spill;
+			give(record);
+			record = spill;
+		}
+	}
+
+	// 已分配的内存（字节）
+	uint64_t allocatedBytes() {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return static_cast<uint64_t>(slabs_) * slabRecords * sizeof(LogPoolRecord);
+	}
+
+private:
+	// 线程缓存，线程退出时归还共享链表
+	struct ThreadCache {
+		LogPoolRecord* head;
+		size_t count;
+
+		ThreadCache() : head(nullptr), count(0) {}
+
+		~ThreadCache() {
+			if (head != nullptr) {
+				instance().pushShared(head, count);
+			}
+		}
+	};
+
+	std::mutex mutex_;        // 共享链表锁
+	LogPoolRecord* shared_;   // 共享空闲链表
+	size_t sharedCount_;      // 共享空闲链表长度
+	size_t slabs_;            // 已分配的 slab 数
+
+	LogRecordPool() : shared_(nullptr), sharedCount_(0), slabs_(0) {}
+
+	static ThreadCache& cache() {
+		static thread_local ThreadCache threadCache;
+		return threadCache;
+	}
+
+	// 追加到 chunk 的 used 位置，写满时接上新的续块
+	void append(LogPoolRecord*& chunk, size_t& used, const char* data, size_t len) {
+		while (len > 0) {
+			if (used == LogPoolRecord::payloadSize) {
+				LogPoolRecord* next = take();
+				chunk->spill = next;
+				chunk = next;
+				used = 0;
+			}
+			size_t size = LogPoolRecord::payloadSize - used;
+			size = len < size ? len : size;
+			memcpy(chunk->payload + used, data, size);
+			used += size;
+			data += size;
+			len -= size;
+		}
+	}
+
+	LogPoolRecord* take() {
+		ThreadCache& local = cache();
+		if (local.head == nullptr) {
+			refill(local);
+		}
+		LogPoolRecord* record = local.head;
+		local.head = record->next;
+		--local.count;
+		return record;
+	}
+
+	void give(LogPoolRecord* record) {
+		ThreadCache& local = cache();
+		record->next = local.head;
+		local.head = record;
+		// 缓存过多时归还一批，保留一批供本线程继续使用
+		if (++local.count >= cacheBatch * 2) {
+			LogPoolRecord* batch = local.head;
+			LogPoolRecord* last = batch;
+			for (size_t i = 1; i < cacheBatch; ++i) {
+				last = last->next;
+			}
+			local.head = last->next;
+			local.count -= cacheBatch;
+			last->next = nullptr;
+			pushShared(batch, cacheBatch);
+		}
+	}
+
+	// 链表 head（以 nullptr 结尾，共 count 条）放回共享链表
+	void pushShared(LogPoolRecord* head, size_t count) {
+		LogPoolRecord* last = head;
+		while (last->next != nullptr) {
+			last = last->next;
+		}
+		std::lock_guard<std::mutex> lock(mutex_);
+		last->next = shared_;
+		shared_ = head;
+		sharedCount_ += count;
+	}
+
+	// 从共享链表取一批，不足时分配新的 slab
+	void refill(ThreadCache& local) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (shared_ == nullptr) {
+			void* memory = std::malloc(slabRecords * sizeof(LogPoolRecord));
+			if (memory == nullptr) {
+				throw std::bad_alloc();
+			}
+			LogPoolRecord* slab = static_cast<LogPoolRecord*>(memory);
+			for (size_t i = 0; i < slabRecords; ++i) {
+				slab[i].next = i + 1 < slabRecords ? &slab[i + 1] : nullptr;
+			}
+			shared_ = slab;
+			sharedCount_ = slabRecords;
+			++slabs_;
+		}
+		LogPoolRecord* last = shared_;
+		size_t count = 1;
+		while (count < cacheBatch && last->next != nullptr) {
+			last = last->next;
+			++count;
+		}
+		local.head = shared_;
+		local.count = count;
+		shared_ = last->next;
+		sharedCount_ -= count;
+		last->next = nullptr;
+	}
+};
+
+#endif // LOG_RECORD_POOL_H
@@ -0,0 +1,496 @@
+/******************************************************************************/
+/* File Name:    LogRing.h                                                   */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Single-producer/single-consumer record ring in a shared   */
+/*               memory mapping. Client processes (Logger::setSharedRing)  */
+/*               append records; the writer daemon logger_ringd drains     */
+/*               every ring of a log folder into one set of rotated files. */
+/*----------------------------------------------------------------------------*/
+/* Details:                                                                  */
+/*   - One ring file per client logger, <pid>_<n>.ring in the ring         */
+/*     directory of the log folder (/dev/shm/logger-<hash> on Linux,       */
+/*     <folder>/.rings elsewhere). The mapping outlives the client, so     */
+/*     records published before a crash are still drained; the daemon     */
+/*     removes the file once the client has exited and the ring is empty.  */
+/*   - head (client) and tail (daemon) are byte positions that only grow;  */
+/*     a record is published by the release store of head after its bytes */
+/*     are written.                                                          */
+/*   - The client side must be serialized by the caller (one mutex per    */
+/*     ring); the daemon is the only reader.                                */
+/*   - The daemon does not trust the mapping: a record whose size or       */
+/*     length does not fit the ring makes it drop everything up to head   */
+/*     (counted in corrupted()).                                            */
+/******************************************************************************/
+
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#include <direct.h>
+#include <process.h>
+#else
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// 环形缓冲区满时客户端的处理方式
+enum class LogRingOverflow {
+	DROP,  // 丢弃并计数（LogRing::dropped），不阻塞调用方
+	BLOCK  // 等待写日志进程取走记录
+};
+
+// 映射区开头的控制块，位置计数各占一个缓存行
+struct LogRingHeader {
+	char magic[8];                      // "LOGRING1"，初始化完成后最后写入
+	uint64_t capacity;                  // 数据区字节数，2 的幂
+	uint64_t pid;                       // 客户端进程 ID
+	std::atomic<uint32_t> closed;       // 客户端已正常关闭
+	char pad0[64 - 28];
+	std::atomic<uint64_t> head;         // 写入位置，仅客户端修改
+	char pad1[64 - 8];
+	std::atomic<uint64_t> tail;         // 读取位置，仅写日志进程修改
+	char pad2[64 - 8];
+	std::atomic<uint64_t> dropped;      // 因缓冲区满丢弃的记录数
+	char pad3[64 - 8];
+};
+
+// 数据区中的一条记录，后接消息，整体按 8 字节对齐
+struct LogRingRecord {
+	uint32_t size;    // 记录总长度（含本结构和对齐）
+	int32_t level;    // 日志等级，skipLevel 表示跳到数据区开头
+	uint64_t nanos;   // 系统时钟时间戳（纳秒）
+	uint32_t length;  // 消息长度
+	uint32_t reserved;
+};
+
+// 写日志进程取出的一条记录，各字段已校验
+struct LogRingEntry {
+	uint64_t nanos;       // 系统时钟时间戳（纳秒）
+	int32_t level;        // 日志等级
+	const char* message;  // 消息，位于映射区中
+	size_t length;        // 消息长度
+};
+
+class LogRing {
+public:
+	static const int32_t skipLevel = -1;// 填充记录，数据区末尾放不下时使用
+
+	LogRing() : header_(nullptr), data_(nullptr), mask_(0), mappedSize_(0), next_(0), corrupted_(0) {
+#ifdef _WIN32
+		file_ = INVALID_HANDLE_VALUE;
+		mapping_ = nullptr;
+#endif
+	}
+
+	~LogRing() {
+		close();
+	}
+
+	// 客户端：在 directory 中新建环（<pid>_<n>.ring），capacity 为数据区字节数，向上取 2 的幂
+	bool create(const std::string& directory, size_t capacity) {
+		size_t size = 4096;
+		while (size < capacity) {
+			size <<= 1;
+		}
+		makeDirectory(directory);
+		uint64_t pid = currentPid();
+		for (int n = 0; n < 1000; ++n) {
+			std::string path = directory + "/" + std::to_string(pid) + "_" + std::to_string(n) + ".ring";
+			bool exists = false;
+			if (map(path, sizeof(LogRingHeader) + size, true, exists)) {
+				header_->capacity = size;
+				header_->pid = pid;
+				header_->closed.store(0, std::memory_order_relaxed);
+				header_->head.store(0, std::memory_order_relaxed);
+				header_->tail.store(0, std::memory_order_relaxed);
+				header_->dropped.store(0, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_release);
+				memcpy(header_->magic, "LOGRING1", 8);
+				data_ = reinterpret_cast<char*>(header_ + 1);
+				mask_ = size - 1;
+				path_ = path;
+				return true;
+			}
+			if (!exists) {
+				return false;
+			}
+		}
+		return false;
+	}
+
+	// 写日志进程：打开已有的环，客户端尚未初始化完成时返回 false
+	bool attach(const std::string& path) {
+		bool exists = false;
+		if (!map(path, 0, false, exists)) {
+			return false;
+		}
+		uint64_t capacity = header_->capacity;
+		if (memcmp(header_->magic, "LOGRING1", 8) != 0 || capacity == 0 || (capacity & (capacity - 1)) != 0
+			|| sizeof(LogRingHeader) + capacity > mappedSize_) {
+			close();
+			return false;
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		data_ = reinterpret_cast<char*>(header_ + 1);
+		mask_ = static_cast<size_t>(capacity - 1);
+		path_ = path;
+		next_ = 0;
+		corrupted_ = 0;
+		return true;
+	}
+
+	// 解除映射，remove 为 true 时同时删除环文件
+	void close(bool remove = false) {
+		if (header_ != nullptr) {
+#ifdef _WIN32
+			UnmapViewOfFile(header_);
+			CloseHandle(mapping_);
+			CloseHandle(file_);
+			mapping_ = nullptr;
+			file_ = INVALID_HANDLE_VALUE;
+#else
+			munmap(header_, mappedSize_);
+#endif
+			header_ = nullptr;
+			data_ = nullptr;
+			if (remove) {
+				std::remove(path_.c_str());
+			}
+		}
+	}
+
+	bool isOpen() const {
+		return header_ != nullptr;
+	}
+
+	// 客户端写入一条记录，消息为 context 与 message 相接，超过数据区 1/4 的部分截断；
+	// 丢弃时返回 false
+	bool push(uint64_t nanos, int level, const char* context, size_t contextLen, const char* message, size_t len,
+		LogRingOverflow overflow) {
+		size_t capacity = mask_ + 1;
+		size_t limit = capacity / 4 - sizeof(LogRingRecord);
+		if (contextLen > limit) {
+			contextLen = limit;
+		}
+		if (contextLen + len > limit) {
+			len = limit - contextLen;
+		}
+		size_t need = align(sizeof(LogRingRecord) + contextLen + len);
+		uint64_t head = header_->head.load(std::memory_order_relaxed);
+		size_t offset = static_cast<size_t>(head) & mask_;
+		size_t skip = capacity - offset < need ? capacity - offset : 0;
+		while (head + skip + need - header_->tail.load(std::memory_order_acquire) > capacity) {
+			if (overflow == LogRingOverflow::DROP) {
+				header_->dropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+		}
+		if (skip != 0) {
+			// 末尾不足一个记录头时不写填充记录，读取方同样直接跳过
+			if (skip >= sizeof(LogRingRecord)) {
+				LogRingRecord* filler = reinterpret_cast<LogRingRecord*>(data_ + offset);
+				filler->size = static_cast<uint32_t>(skip);
+				filler->level = skipLevel;
+			}
+			head += skip;
+			offset = 0;
+		}
+		LogRingRecord* record = reinterpret_cast<LogRingRecord*>(data_ + offset);
+		record->size = static_cast<uint32_t>(need);
+		record->level = level;
+		record->nanos = nanos;
+		record->length = static_cast<uint32_t>(contextLen + len);
+		record->reserved = 0;
+		memcpy(record + 1, context, contextLen);
+		memcpy(reinterpret_cast<char*>(record + 1) + contextLen, message, len);
+		header_->head.store(head + need, std::memory_order_release);
+		return true;
+	}
+
+	// 写日志进程：查看下一条记录但不取出，没有记录时返回 false。
+	// 映射区可被任何客户端改写，记录长度越界时丢弃到 head 为止的全部数据并计入 corrupted()
+	bool peek(LogRingEntry& entry) {
+		uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+		uint64_t head = header_->head.load(std::memory_order_acquire);
+		size_t capacity = mask_ + 1;
+		bool found = false;
+		while (tail != head) {
+			size_t offset = static_cast<size_t>(tail) & mask_;
+			size_t room = capacity - offset;
+			if (head - tail > capacity) {
+				tail = dropCorrupted(head);
+				break;
+			}
+			if (room < sizeof(LogRingRecord)) {
+				tail += room;
+				continue;
+			}
+			// 各字段只读一次，校验后使用读到的值
+			const LogRingRecord* record = reinterpret_cast<const LogRingRecord*>(data_ + offset);
+			size_t size = record->size;
+			int32_t level = record->level;
+			size_t length = record->length;
+			if (size < sizeof(LogRingRecord) || size > room || size > head - tail
+				|| (level != skipLevel && length > size - sizeof(LogRingRecord))) {
+				tail = dropCorrupted(head);
+				break;
+			}
+			if (level == skipLevel) {
+				tail += size;
+				continue;
+			}
+			entry.nanos = record->nanos;
+			entry.level = level;
+			entry.message = reinterpret_cast<const char*>(record + 1);
+			entry.length = length;
+			next_ = tail + size;
+			found = true;
+			break;
+		}
+		// 已跳过的填充和丢弃的数据
+		header_->tail.store(tail, std::memory_order_release);
+		return found;
+	}
+
+	// 写日志进程：取出 peek 返回的记录
+	void pop() {
+		header_->tail.store(next_, std::memory_order_release);
+	}
+
+	// 写日志进程：依次取出最多 maxRecords 条记录，回调参数为 (nanos, level, message, length)，返回条数
+	template <typename Func>
+	size_t drain(Func func, size_t maxRecords) {
+		size_t count = 0;
+		LogRingEntry entry;
+		while (count < maxRecords && peek(entry)) {
+			func(entry.nanos, entry.level, entry.message, entry.length);
+			pop();
+			++count;
+		}
+		return count;
+	}
+
+	// 是否没有待取的记录
+	bool empty() const {
+		return header_->tail.load(std::memory_order_relaxed) == header_->head.load(std::memory_order_acquire);
+	}
+
+	// 客户端正常关闭时标记，之后写日志进程取完即可删除
+	void markClosed() {
+		header_->closed.store(1, std::memory_order_release);
+	}
+
+	// 客户端已关闭或进程已退出
+	bool finished() const {
+		return header_->closed.load(std::memory_order_acquire) != 0 || !processAlive(header_->pid);
+	}
+
+	uint64_t pid() const {
+		return header_->pid;
+	}
+
+	uint64_t dropped() const {
+		return header_->dropped.load(std::memory_order_relaxed);
+	}
+
+	// 因记录损坏丢弃数据的次数（写日志进程本地计数）
+	uint64_t corrupted() const {
+		return corrupted_;
+	}
+
+	const std::string& path() const {
+		return path_;
+	}
+
+	// 日志文件夹对应的环目录：Linux 上位于 /dev/shm（按文件夹绝对路径取哈希），其他平台为 <folder>/.rings
+	static std::string directory(const std::string& folder) {
+#if defined(__linux__)
+		struct stat shmStat;
+		if (stat("/dev/shm", &shmStat) == 0 && S_ISDIR(shmStat.st_mode)) {
+			char resolved[PATH_MAX];
+			std::string path = realpath(folder.c_str(), resolved) != nullptr ? std::string(resolved) : folder;
+			uint64_t hash = 14695981039346656037ull;// FNV-1a
+			for (size_t i = 0; i < path.size(); ++i) {
+				hash = (hash ^ static_cast<unsigned char>(path[i])) * 1099511628211ull;
+			}
+			char name[48];
+			snprintf(name, sizeof(name), "/dev/shm/logger-%016llx", static_cast<unsigned long long>(hash));
+			return name;
+		}
+#endif
+		return folder + "/.rings";
+	}
+
+	// 目录中的环文件（完整路径）
+	static std::vector<std::string> list(const std::string& directory) {
+		std::vector<std::string> paths;
+#ifdef _WIN32
+		struct _finddata_t fileInfo;
+		intptr_t handle = _findfirst((directory + "\\*.ring").c_str(), &fileInfo);
+		if (handle != -1) {
+			do {
+				paths.push_back(directory + "/" + fileInfo.name);
+			} while (_findnext(handle, &fileInfo) == 0);
+			_findclose(handle);
+		}
+#else
+		DIR* dir = opendir(directory.c_str());
+		if (dir != nullptr) {
+			struct dirent* entry;
+			while ((entry = readdir(dir)) != nullptr) {
+				std::string name = entry->d_name;
+				if (name.size() > 5 && name.compare(name.size() - 5, 5, ".ring") == 0) {
+					paths.push_back(directory + "/" + name);
+				}
+			}
+			closedir(dir);
+		}
+#endif
+		return paths;
+	}
+
+	static void makeDirectory(const std::string& path) {
+#ifdef _WIN32
+		_mkdir(path.c_str());
+#else
+		mkdir(path.c_str(), 0777);
+#endif
+	}
+
+	static uint64_t currentPid() {
+#ifdef _WIN32
+		return static_cast<uint64_t>(_getpid());
+#else
+		return static_cast<uint64_t>(getpid());
+#endif
+	}
+
+	static bool processAlive(uint64_t pid) {
+#ifdef _WIN32
+		HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, static_cast<DWORD>(pid));
+		if (process == nullptr) {
+			return GetLastError() == ERROR_ACCESS_DENIED;
+		}
+		DWORD code = 0;
+		bool alive = GetExitCodeProcess(process, &code) && code == STILL_ACTIVE;
+		CloseHandle(process);
+		return alive;
+#else
+		return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+#endif
+	}
+
+private:
+	LogRing(const LogRing&);
+	LogRing& operator=(const LogRing&);
+
+	LogRingHeader* header_;  // 映射区开头
+	char* data_;             // 数据区
+	size_t mask_;            // 数据区字节数 - 1
+	size_t mappedSize_;      // 映射长度
+	std::string path_;       // 环文件路径
+	uint64_t next_;          // peek 返回的记录之后的读取位置
+	uint64_t corrupted_;     // 因记录损坏丢弃数据的次数
+#ifdef _WIN32
+	HANDLE file_;            // 环文件句柄
+	HANDLE mapping_;         // 文件映射句柄
+#endif
+
+	// 记录损坏：丢弃到 head 为止的数据，返回新的读取位置
+	uint64_t dropCorrupted(uint64_t head) {
+		++corrupted_;
+		return head;
+	}
+
+	static size_t align(size_t size) {
+		return (size + 7) & ~static_cast<size_t>(7);
+	}
+
+	// 映射 path：create 为 true 时新建（已存在时失败并置 exists），长度为 size；否则映射整个已有文件
+	bool map(const std::string& path, size_t size, bool create, bool& exists) {
+		exists = false;
+#ifdef _WIN32
+		file_ = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			nullptr, create ? CREATE_NEW : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file_ == INVALID_HANDLE_VALUE) {
+			exists = create && GetLastError() == ERROR_FILE_EXISTS;
+			return false;
+		}
+		if (!create) {
+			LARGE_INTEGER fileSize;
+			GetFileSizeEx(file_, &fileSize);
+			size = static_cast<size_t>(fileSize.QuadPart);
+		}
+		if (size < sizeof(LogRingHeader)) {
+			CloseHandle(file_);
+			file_ = INVALID_HANDLE_VALUE;
+			return false;
+		}
+		uint64_t size64 = size;
+		mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READWRITE, static_cast<DWORD>(size64 >> 32),
+			static_cast<DWORD>(size64 & 0xffffffffu), nullptr);
+		void* memory = mapping_ != nullptr ? MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, size) : nullptr;
+		if (memory == nullptr) {
+			if (mapping_ != nullptr) {
+				CloseHandle(mapping_);
+				mapping_ = nullptr;
+			}
+			CloseHandle(file_);
+			file_ = INVALID_HANDLE_VALUE;
+			return false;
+		}
+#else
+		int fd = open(path.c_str(), create ? O_RDWR | O_CREAT | O_EXCL : O_RDWR, 0666);
+		if (fd < 0) {
+			exists = create && errno == EEXIST;
+			return false;
+		}
+		if (create) {
+			if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+				::close(fd);
+				std::remove(path.c_str());
+				return false;
+			}
+		}
+		else {
+			struct stat fileStat;
+			size = fstat(fd, &fileStat) == 0 ? static_cast<size_t>(fileStat.st_size) : 0;
+		}
+		if (size < sizeof(LogRingHeader)) {
+			::close(fd);
+			return false;
+		}
+		void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		::close(fd);
+		if (memory == MAP_FAILED) {
+			return false;
+		}
+#endif
+		header_ = create ? new (memory) LogRingHeader() : static_cast<LogRingHeader*>(memory);
+		mappedSize_ = size;
+		return true;
+	}
+};
+
+#endif // LOG_RING_H
@@ -0,0 +1,153 @@
+/******************************************************************************/
+/* File Name:    LogSanitize.h                                               */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Escaping of untrusted text for log lines: control bytes   */
+/*               are escaped and UTF-8 is validated, with a SIMD scan      */
+/*               (LogSimd.h) that copies clean runs in bulk.               */
+/*----------------------------------------------------------------------------*/
+/* Details:                                                                  */
+/*   - Text: \n, \r, \t and other bytes below 0x20 or 0x7f become "\n",    */
+/*     "\r", "\t" or "\xHH"; bytes that are not part of valid UTF-8 become */
+/*     "\xHH". Backslashes are kept as they are.                           */
+/*   - JSON: quotes, backslashes and control bytes are escaped as JSON      */
+/*     requires; with validation, invalid UTF-8 bytes become \ufffd.          */
+/*   - Valid UTF-8 rejects overlong forms, surrogates and code points above */
+/*     U+10FFFF. Runs of non-ASCII characters are checked byte by byte.    */
+/******************************************************************************/
+
+#ifndef LOG_SANITIZE_H
+#define LOG_SANITIZE_H
+
+#include <cstddef>
+#include <string>
+#include "LogSimd.h"
+
+namespace LogSanitize {
+
+	// p 处多字节 UTF-8 序列的长度（2 到 4），不合法或不完整时返回 0
+	inline size_t utf8Length(const char* p, const char* end) {
+		const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+		unsigned char lead = u[0];
+		unsigned char low = 0x80;  // 第二个字节的下限
+		unsigned char high = 0xbf; // 第二个字节的上限
+		size_t len;
+		if (lead >= 0xc2 && lead <= 0xdf) {
+			len = 2;
+		}
+		else if (lead >= 0xe0 && lead <= 0xef) {
+			len = 3;
+			low = lead == 0xe0 ? 0xa0 : low;   // 排除过长编码
+			high = lead == 0xed ? 0x9f : high; // 排除代理区
+		}
+		else if (lead >= 0xf0 && lead <= 0xf4) {
+			len = 4;
+			low = lead == 0xf0 ? 0x90 : low;
+			high = lead == 0xf4 ? 0x8f : high; // 不超过 U+10FFFF
+		}
+		else {
+			return 0;
+		}
+		if (static_cast<size_t>(end - p) < len || u[1] < low || u[1] > high) {
+			return 0;
+		}
+		for (size_t i = 2; i < len; ++i) {
+			if ((u[i] & 0xc0) != 0x80) {
+				return 0;
+			}
+		}
+		return len;
+	}
+
+	// 从 p 开始连续的合法多字节 UTF-8 字符的总长度
+	inline size_t utf8Run(const char* p, const char* end) {
+		const char* start = p;
+		while (p < end && static_cast<unsigned char>(*p) >= 0x80) {
+			size_t len = utf8Length(p, end);
+			if (len == 0) {
+				break;
+			}
+			p += len;
+		}
+		return static_cast<size_t>(p - start);
+	}
+
+	inline void appendHex(std::string& out, const char* prefix, unsigned char c, size_t width) {
+		static const char hex[] = "0123456789abcdef";
+		out.append(prefix);
+		for (size_t i = width; i > 0; --i) {
+			out.push_back(hex[(c >> ((i - 1) * 4)) & 0x0f]);
+		}
+	}
+
+	// 追加文本，转义控制字符和非法 UTF-8 字节；合法的多字节字符不中断整段复制
+	inline void appendText(std::string& out, const char* text, size_t len) {
+		const char* copied = text; // 尚未复制的位置
+		const char* p = text;
+		const char* end = text + len;
+		while (true) {
+			const char* stop = logFindEscape(p, end, '\x7f', '\x7f', true);
+			if (stop == end) {
+				out.append(copied, end - copied);
+				return;
+			}
+			unsigned char c = static_cast<unsigned char>(*stop);
+			if (c >= 0x80) {
+				size_t run = utf8Run(stop, end);
+				if (run > 0) {
+					p = stop + run;
+					continue;
+				}
+			}
+			out.append(copied, stop - copied);
+			switch (c) {
+			case '\n': out.append("\\n", 2); break;
+			case '\r': out.append("\\r", 2); break;
+			case '\t': out.append("\\t", 2); break;
+			default: appendHex(out, "\\x", c, 2); break;
+			}
+			p = copied = stop + 1;
+		}
+	}
+
+	// 追加 JSON 字符串内容（不含引号）；validate 为 true 时非法 UTF-8 字节替换为 \ufffd，否则原样追加
+	inline void appendJson(std::string& out, const char* text, size_t len, bool validate) {
+		const char* copied = text;
+		const char* p = text;
+		const char* end = text + len;
+		while (true) {
+			const char* stop = logFindEscape(p, end, '"', '\\', validate);
+			if (stop == end) {
+				out.append(copied, end - copied);
+				return;
+			}
+			unsigned char c = static_cast<unsigned char>(*stop);
+			if (c >= 0x80) {
+				size_t run = utf8Run(stop, end);
+				if (run > 0) {
+					p = stop + run;
+					continue;
+				}
+			}
+			out.append(copied, stop - copied);
+			switch (c) {
+			case '"': out.append("\\\"", 2); break;
+			case '\\': out.append("\\\\", 2); break;
+			case '\n': out.append("\\n", 2); break;
+			case '\r': out.append("\\r", 2); break;
+			case '\t': out.append("\\t", 2); break;
+			default:
+				if (c >= 0x80) {
+					out.append("\\ufffd", 6);
+				}
+				else {
+					appendHex(out, "\\u", c, 4);
+				}
+				break;
+			}
+			p = copied = stop + 1;
+		}
+	}
+}
+
+#endif // LOG_SANITIZE_H
@@ -0,0 +1,230 @@
+#include "LogScan.h"
+#include "LogReader.h"
+#include "LogSimd.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+// 命令行时间补全后解析；isEnd 为 true 时取省略部分的最大值
+bool parseScanTime(const std::string& text, bool isEnd, uint64_t& wallNanos) {
+	std::string value = text;
+	uint64_t span = 0;
+	if (value.size() == 10) {
+		value += " 00:00:00";
+		span = 86400ull * 1000000000ull - 1;
+	}
+	else if (value.size() == 16) {
+		value += ":00";
+		span = 60ull * 1000000000ull - 1;
+	}
+	else if (value.size() == 19) {
+		span = 1000000000ull - 1;
+	}
+	const char* end = value.c_str() + value.size();
+	if (parseLogTime(value.c_str(), end, wallNanos) != end) {
+		return false;
+	}
+	if (isEnd) {
+		wallNanos += span;
+	}
+	return true;
+}
+
+// 按前缀快速取日志等级，不是日志行首时返回 -1
+// "[YYYY-MM-DD HH:MM:SS[.f] LEVEL]" 或 "[YYYY-MM-DD HH:MM:SS[.f]] [LEVEL]"
+int quickLevel(const char* begin, const char* end) {
+	if (end - begin < 23 || begin[0] != '[' || begin[5] != '-' || begin[11] != ' ' || begin[14] != ':') {
+		return -1;
+	}
+	const char* p = begin + 20;
+	if (*p == '.') {
+		++p;
+		while (p < end && *p >= '0' && *p <= '9') {
+			++p;
+		}
+	}
+	if (p < end && *p == ']') {
+		++p;
+	}
+	if (end - p < 2 || *p != ' ') {
+		return -1;
+	}
+	++p;
+	if (*p == '[') {
+		++p;
+	}
+	if (p >= end) {
+		return -1;
+	}
+	switch (*p) {
+	case 'D':
+		return 0;
+	case 'I':
+		return 1;
+	case 'W':
+		return 2;
+	case 'E':
+		return 3;
+	default:
+		return -1;
+	}
+}
+
+} // namespace
+
+LogScanner::LogScanner(const LogScanOptions& options)
+	: options_(options), valid_(true), fromNanos_(0), toNanos_(UINT64_MAX) {
+	if (!options_.from.empty()) {
+		valid_ = parseScanTime(options_.from, false, fromNanos_) && valid_;
+	}
+	if (!options_.to.empty()) {
+		valid_ = parseScanTime(options_.to, true, toNanos_) && valid_;
+	}
+}
+
+bool LogScanner::matchPrefix(const char* lineBegin, const char* lineEnd) const {
+	if (options_.minLevel > 0 && quickLevel(lineBegin, lineEnd) < options_.minLevel) {
+		return false;
+	}
+	// 时间按文本比较，字段定长，字典序即时间顺序
+	const std::string& from = options_.from;
+	if (!from.empty()) {
+		if (lineEnd - lineBegin < static_cast<ptrdiff_t>(from.size() + 1) || lineBegin[0] != '[' ||
+			memcmp(lineBegin + 1, from.data(), from.size()) < 0) {
+			return false;
+		}
+	}
+	const std::string& to = options_.to;
+	if (!to.empty()) {
+		if (lineEnd - lineBegin < static_cast<ptrdiff_t>(to.size() + 1) || lineBegin[0] != '[' ||
+			memcmp(lineBegin + 1, to.data(), to.size()) > 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+uint64_t LogScanner::scan(const char* begin, const char* end, std::string* out) const {
+	const std::string& pattern = options_.pattern;
+	bool checkPrefix = options_.minLevel > 0 || !options_.from.empty() || !options_.to.empty();
+	uint64_t count = 0;
+	const char* p = begin;
+	while (p < end) {
+		const char* lineBegin = p;
+		const char* lineEnd;
+		if (!pattern.empty()) {
+			// 整块查找子串，只回溯命中所在的行
+			const char* hit = logFindSubstring(p, end, pattern.data(), pattern.size());
+			if (hit == end) {
+				break;
+			}
+			lineBegin = hit;
+			while (lineBegin > p && lineBegin[-1] != '\n') {
+				--lineBegin;
+			}
+			lineEnd = logFindByte(hit + pattern.size(), end, '\n');
+		}
+		else {
+			lineEnd = logFindByte(p, end, '\n');
+		}
+		const char* next = lineEnd < end ? lineEnd + 1 : end;
+		if (!checkPrefix || matchPrefix(lineBegin, lineEnd)) {
+			++count;
+			if (out != nullptr) {
+				out->append(lineBegin, next - lineBegin);
+				if (lineEnd == end) {
+					out->push_back('\n');
+				}
+			}
+		}
+		p = next;
+	}
+	return count;
+}
+
+uint64_t LogScanner::scanFile(const std::string& path, std::string* out) const {
+	LogSegment segment;
+	if (!segment.open(path)) {
+		fprintf(stderr, "Failed to open file: %s\n", path.c_str());
+		return 0;
+	}
+	if (segment.size() == 0) {
+		return 0;
+	}
+	size_t begin = 0, end = segment.size();
+	if (!options_.from.empty() || !options_.to.empty()) {
+		segment.rangeOffsets(fromNanos_, toNanos_, begin, end);
+	}
+	return scan(segment.data() + begin, segment.data() + end, out);
+}
+
+uint64_t LogScanner::scanFiles(const std::vector<std::string>& paths, int threads, FILE* out) const {
+	// 每个文件的结果，按文件顺序输出；工作线程最多领先输出 2 * threads 个文件
+	struct FileResult {
+		std::string output;
+		uint64_t count;
+		bool done;
+	};
+	std::vector<FileResult> results(paths.size());
+	for (size_t i = 0; i < results.size(); ++i) {
+		results[i].count = 0;
+		results[i].done = false;
+	}
+	threads = std::max(1, std::min(threads, static_cast<int>(paths.size())));
+	size_t window = static_cast<size_t>(threads) * 2;
+	std::atomic<size_t> nextFile(0);
+	size_t written = 0;
+	std::mutex mutex;
+	std::condition_variable cond;
+
+	std::vector<std::thread> workers;
+	for (int t = 0; t < threads; ++t) {
+		workers.emplace_back([&]() {
+			while (true) {
+				size_t i = nextFile.fetch_add(1);
+				if (i >= paths.size()) {
+					return;
+				}
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					cond.wait(lock, [&]() { return i < written + window; });
+				}
+				std::string output;
+				uint64_t count = scanFile(paths[i], options_.countOnly ? nullptr : &output);
+				std::lock_guard<std::mutex> lock(mutex);
+				results[i].output.swap(output);
+				results[i].count = count;
+				results[i].done = true;
+				cond.notify_all();
+			}
+		});
+	}
+
+	uint64_t total = 0;
+	for (size_t i = 0; i < results.size(); ++i) {
+		std::string output;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			cond.wait(lock, [&]() { return results[i].done; });
+			output.swap(results[i].output);
+			total += results[i].count;
+		}
+		if (out != nullptr && !output.empty()) {
+			fwrite(output.data(), 1, output.size(), out);
+		}
+		std::lock_guard<std::mutex> lock(mutex);
+		written = i + 1;
+		cond.notify_all();
+	}
+	for (size_t i = 0; i < workers.size(); ++i) {
+		workers[i].join();
+	}
+	if (out != nullptr) {
+		fflush(out);
+	}
+	return total;
+}
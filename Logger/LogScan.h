@@ -0,0 +1,66 @@
+/******************************************************************************/
+/* File Name:    LogScan.h                                                   */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Literal substring / level / time filtering over mapped log */
+/*               segments with the SIMD kernels from LogSimd.h.              */
+/*----------------------------------------------------------------------------*/
+/* Details:                                                                  */
+/*   - With a pattern the whole mapping is searched at once and only the    */
+/*     lines around the hits are looked at; without one, lines are walked  */
+/*     with the vectorized newline search.                                  */
+/*   - Level and time filters read the fixed prefix layout directly: the    */
+/*     level is identified by its first letter, and the time is compared as */
+/*     text, which orders like time because every field has a fixed width. */
+/*   - The filter is line based like grep: continuation lines of a         */
+/*     multi-line record carry no prefix and never pass a level/time filter.*/
+/*   - Files are scanned by a thread pool; output keeps file order.         */
+/******************************************************************************/
+
+#ifndef LOG_SCAN_H
+#define LOG_SCAN_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// 扫描条件
+struct LogScanOptions {
+	std::string pattern; // 字面子串，空表示不按内容过滤
+	int minLevel;        // 最低日志等级，0 表示不过滤
+	std::string from;    // 起始时间（含），格式同日志前缀，可只写前面部分
+	std::string to;      // 结束时间（含），格式同日志前缀，可只写前面部分
+	bool countOnly;      // 只统计命中行数，不输出
+
+	LogScanOptions() : minLevel(0), countOnly(false) {}
+};
+
+class LogScanner {
+public:
+	explicit LogScanner(const LogScanOptions& options);
+
+	// 时间条件无法解析时返回 false
+	bool valid() const {
+		return valid_;
+	}
+
+	// 扫描 [begin, end)，命中的行（含换行）追加到 out，out 可为 nullptr，返回命中行数
+	uint64_t scan(const char* begin, const char* end, std::string* out) const;
+
+	// 扫描一个日志文件，有索引且指定时间范围时只扫描相关区块
+	uint64_t scanFile(const std::string& path, std::string* out) const;
+
+	// 用 threads 个线程扫描多个文件，按文件顺序输出到 out，返回命中行数
+	uint64_t scanFiles(const std::vector<std::string>& paths, int threads, FILE* out) const;
+
+private:
+	bool matchPrefix(const char* lineBegin, const char* lineEnd) const;
+
+	LogScanOptions options_;
+	bool valid_;         // 时间条件是否有效
+	uint64_t fromNanos_; // 起始时间，用于索引定位
+	uint64_t toNanos_;   // 结束时间，用于索引定位
+};
+
+#endif // LOG_SCAN_H
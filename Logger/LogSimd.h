@@ -0,0 +1,278 @@
+/******************************************************************************/
+/* File Name:    LogSimd.h                                                   */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Byte and substring search kernels (memchr/memmem style)     */
+/*               and an escape-byte classifier, with AVX2, SSE2 and scalar   */
+/*               implementations.                                            */
+/*----------------------------------------------------------------------------*/
+/* Details:                                                                  */
+/*   - The implementation is picked once at run time from CPUID; AVX2 code  */
+/*     is compiled through target attributes, so no global -mavx2 is        */
+/*     needed and the binary still runs on SSE2-only machines.              */
+/*   - Substring search compares the first and last needle byte for a whole */
+/*     vector at once and verifies only the candidate positions.            */
+/*   - The escape classifier needs one signed compare for control bytes    */
+/*     (and bytes >= 0x80, which are negative) plus two equality compares.  */
+/******************************************************************************/
+
+#ifndef LOG_SIMD_H
+#define LOG_SIMD_H
+
+#include <cstddef>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LOG_SIMD_X86 1
+#include <emmintrin.h>
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(LOG_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define LOG_SIMD_AVX2 __attribute__((target("avx2")))
+#else
+#define LOG_SIMD_AVX2
+#endif
+
+enum class LogSimdLevel {// 指令集
+	SCALAR,
+	SSE2,
+	AVX2
+};
+
+namespace logsimd {
+
+inline int countTrailingZeros(unsigned int mask) {
+#ifdef _MSC_VER
+	unsigned long index = 0;
+	_BitScanForward(&index, mask);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+inline LogSimdLevel detect() {
+#if !defined(LOG_SIMD_X86)
+	return LogSimdLevel::SCALAR;
+#elif defined(_MSC_VER)
+	int regs[4] = { 0 };
+	__cpuid(regs, 0);
+	if (regs[0] >= 7) {
+		__cpuidex(regs, 1, 0);
+		bool osSave = (regs[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+		__cpuidex(regs, 7, 0);
+		if (osSave && (regs[1] & (1 << 5)) != 0) {
+			return LogSimdLevel::AVX2;
+		}
+	}
+	return LogSimdLevel::SSE2;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") ? LogSimdLevel::AVX2 : LogSimdLevel::SSE2;
+#endif
+}
+
+inline const char* findByteScalar(const char* p, const char* end, char c) {
+	const void* hit = memchr(p, c, end - p);
+	return hit != nullptr ? static_cast<const char*>(hit) : end;
+}
+
+inline const char* findSubstringScalar(const char* p, const char* end, const char* needle, size_t len) {
+	while (end - p >= static_cast<ptrdiff_t>(len)) {
+		p = findByteScalar(p, end - len + 1, needle[0]);
+		if (p == end - len + 1) {
+			break;
+		}
+		if (memcmp(p, needle, len) == 0) {
+			return p;
+		}
+		++p;
+	}
+	return end;
+}
+
+inline bool isEscapeByte(char c, char a, char b, bool high) {
+	unsigned char u = static_cast<unsigned char>(c);
+	return u < 0x20 || c == a || c == b || (high && u >= 0x80);
+}
+
+inline const char* findEscapeScalar(const char* p, const char* end, char a, char b, bool high) {
+	for (; p < end; ++p) {
+		if (isEscapeByte(*p, a, b, high)) {
+			return p;
+		}
+	}
+	return end;
+}
+
+#ifdef LOG_SIMD_X86
+inline const char* findByteSse2(const char* p, const char* end, char c) {
+	__m128i target = _mm_set1_epi8(c);
+	while (end - p >= 16) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, target)));
+		if (mask != 0) {
+			return p + countTrailingZeros(mask);
+		}
+		p += 16;
+	}
+	for (; p < end; ++p) {
+		if (*p == c) {
+			return p;
+		}
+	}
+	return end;
+}
+
+inline const char* findSubstringSse2(const char* p, const char* end, const char* needle, size_t len) {
+	__m128i first = _mm_set1_epi8(needle[0]);
+	__m128i last = _mm_set1_epi8(needle[len - 1]);
+	while (end - p >= static_cast<ptrdiff_t>(len + 15)) {
+		__m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		__m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + len - 1));
+		unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(
+			_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last))));
+		while (mask != 0) {
+			int bit = countTrailingZeros(mask);
+			if (memcmp(p + bit + 1, needle + 1, len - 2) == 0) {
+				return p + bit;
+			}
+			mask &= mask - 1;
+		}
+		p += 16;
+	}
+	return findSubstringScalar(p, end, needle, len);
+}
+
+inline const char* findEscapeSse2(const char* p, const char* end, char a, char b, bool high) {
+	__m128i limit = _mm_set1_epi8(0x20);
+	__m128i negative = _mm_set1_epi8(-1);
+	__m128i first = _mm_set1_epi8(a);
+	__m128i second = _mm_set1_epi8(b);
+	while (end - p >= 16) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		// 有符号比较：0x80 以上的字节为负数，也小于 0x20
+		__m128i control = _mm_cmplt_epi8(block, limit);
+		if (!high) {
+			control = _mm_and_si128(control, _mm_cmpgt_epi8(block, negative));
+		}
+		__m128i hit = _mm_or_si128(control, _mm_or_si128(_mm_cmpeq_epi8(block, first), _mm_cmpeq_epi8(block, second)));
+		unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(hit));
+		if (mask != 0) {
+			return p + countTrailingZeros(mask);
+		}
+		p += 16;
+	}
+	return findEscapeScalar(p, end, a, b, high);
+}
+
+LOG_SIMD_AVX2 inline const char* findByteAvx2(const char* p, const char* end, char c) {
+	__m256i target = _mm256_set1_epi8(c);
+	while (end - p >= 32) {
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+		unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, target)));
+		if (mask != 0) {
+			return p + countTrailingZeros(mask);
+		}
+		p += 32;
+	}
+	return findByteSse2(p, end, c);
+}
+
+LOG_SIMD_AVX2 inline const char* findEscapeAvx2(const char* p, const char* end, char a, char b, bool high) {
+	__m256i limit = _mm256_set1_epi8(0x20);
+	__m256i negative = _mm256_set1_epi8(-1);
+	__m256i first = _mm256_set1_epi8(a);
+	__m256i second = _mm256_set1_epi8(b);
+	while (end - p >= 32) {
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+		__m256i control = _mm256_cmpgt_epi8(limit, block);
+		if (!high) {
+			control = _mm256_and_si256(control, _mm256_cmpgt_epi8(block, negative));
+		}
+		__m256i hit = _mm256_or_si256(control, _mm256_or_si256(_mm256_cmpeq_epi8(block, first), _mm256_cmpeq_epi8(block, second)));
+		unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(hit));
+		if (mask != 0) {
+			return p + countTrailingZeros(mask);
+		}
+		p += 32;
+	}
+	return findEscapeSse2(p, end, a, b, high);
+}
+
+LOG_SIMD_AVX2 inline const char* findSubstringAvx2(const char* p, const char* end, const char* needle, size_t len) {
+	__m256i first = _mm256_set1_epi8(needle[0]);
+	__m256i last = _mm256_set1_epi8(needle[len - 1]);
+	while (end - p >= static_cast<ptrdiff_t>(len + 31)) {
+		__m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+		__m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + len - 1));
+		unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(
+			_mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first), _mm256_cmpeq_epi8(blockLast, last))));
+		while (mask != 0) {
+			int bit = countTrailingZeros(mask);
+			if (memcmp(p + bit + 1, needle + 1, len - 2) == 0) {
+				return p + bit;
+			}
+			mask &= mask - 1;
+		}
+		p += 32;
+	}
+	return findSubstringSse2(p, end, needle, len);
+}
+#endif
+
+} // namespace logsimd
+
+// 当前机器使用的指令集
+inline LogSimdLevel logSimdLevel() {
+	static const LogSimdLevel level = logsimd::detect();
+	return level;
+}
+
+// 查找字节 c，未找到返回 end
+inline const char* logFindByte(const char* p, const char* end, char c) {
+#ifdef LOG_SIMD_X86
+	if (logSimdLevel() == LogSimdLevel::AVX2) {
+		return logsimd::findByteAvx2(p, end, c);
+	}
+	return logsimd::findByteSse2(p, end, c);
+#else
+	return logsimd::findByteScalar(p, end, c);
+#endif
+}
+
+// 查找子串，未找到返回 end
+inline const char* logFindSubstring(const char* p, const char* end, const char* needle, size_t len) {
+	if (len == 0) {
+		return p;
+	}
+	if (len == 1) {
+		return logFindByte(p, end, needle[0]);
+	}
+#ifdef LOG_SIMD_X86
+	if (logSimdLevel() == LogSimdLevel::AVX2) {
+		return logsimd::findSubstringAvx2(p, end, needle, len);
+	}
+	return logsimd::findSubstringSse2(p, end, needle, len);
+#else
+	return logsimd::findSubstringScalar(p, end, needle, len);
+#endif
+}
+
+// 查找第一个需要转义的字节：控制字符（< 0x20）、a 或 b，high 为 true 时还包括 0x80 以上的字节；未找到返回 end
+inline const char* logFindEscape(const char* p, const char* end, char a, char b, bool high) {
+#ifdef LOG_SIMD_X86
+	if (logSimdLevel() == LogSimdLevel::AVX2) {
+		return logsimd::findEscapeAvx2(p, end, a, b, high);
+	}
+	return logsimd::findEscapeSse2(p, end, a, b, high);
+#else
+	return logsimd::findEscapeScalar(p, end, a, b, high);
+#endif
+}
+
+#endif // LOG_SIMD_H
@@ -0,0 +1,178 @@
+/******************************************************************************/
+/* File Name:    LogStats.h                                                  */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Lock-free latency histogram used by the C11 Logger for its  */
+/*               self-metrics.                                               */
+/*----------------------------------------------------------------------------*/
+/* Details:                                                                  */
+/*   - Values are bucketed log-linearly: every power of two is split into   */
+/*     4 sub-buckets, so a reported percentile is within 25% of the real    */
+/*     value. 252 buckets cover the whole uint64_t range.                    */
+/*   - Recording is one relaxed fetch_add on the bucket plus one on the sum. */
+/******************************************************************************/
+
+#ifndef LOG_STATS_H
+#define LOG_STATS_H
+
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// 分桶规则：[0, 4) 每个值一个桶，之后每个 2 的幂区间 4 个子桶
+struct LogBuckets {
+	static const int subBucketBits_ = 2;
+	static const int subBucketCount_ = 1 << subBucketBits_;
+	static const int bucketCount_ = (63 - subBucketBits_ + 2) * subBucketCount_;
+
+	static int index(uint64_t value) {
+		if (value < static_cast<uint64_t>(subBucketCount_)) {
+			return static_cast<int>(value);
+		}
+		int msb = 63 - countLeadingZeros(value);
+		int sub = static_cast<int>((value >> (msb - subBucketBits_)) & (subBucketCount_ - 1));
+		return (msb - subBucketBits_ + 1) * subBucketCount_ + sub;
+	}
+
+	// 桶内最大值
+	static uint64_t upperBound(int index) {
+		if (index < subBucketCount_) {
+			return static_cast<uint64_t>(index);
+		}
+		int msb = index / subBucketCount_ + subBucketBits_ - 1;
+		int sub = index % subBucketCount_;
+		int shift = msb - subBucketBits_;
+		uint64_t lower = static_cast<uint64_t>(subBucketCount_ + sub) << shift;
+		return lower + ((1ull << shift) - 1);
+	}
+
+	static int countLeadingZeros(uint64_t value) {
+#if defined(_MSC_VER)
+		unsigned long bit = 0;
+#if defined(_WIN64)
+		_BitScanReverse64(&bit, value);
+		return 63 - static_cast<int>(bit);
+#else
+		if (value >> 32) {
+			_BitScanReverse(&bit, static_cast<unsigned long>(value >> 32));
+			return 31 - static_cast<int>(bit);
+		}
+		_BitScanReverse(&bit, static_cast<unsigned long>(value));
+		return 63 - static_cast<int>(bit);
+#endif
+#else
+		return __builtin_clzll(value);
+#endif
+	}
+};
+
+// 直方图快照
+struct LogHistogramSnapshot {
+	uint64_t count;                               // 样本数
+	uint64_t sum;                                 // 样本总和
+	uint64_t buckets[LogBuckets::bucketCount_];   // 各桶样本数
+
+	LogHistogramSnapshot() : count(0), sum(0) {
+		memset(buckets, 0, sizeof(buckets));
+	}
+
+	// 百分位数，p 取值 [0, 1]，返回所在桶的上界
+	uint64_t percentile(double p) const {
+		if (count == 0) {
+			return 0;
+		}
+		uint64_t rank = static_cast<uint64_t>(p * static_cast<double>(count - 1)) + 1;
+		uint64_t seen = 0;
+		for (int i = 0; i < LogBuckets::bucketCount_; ++i) {
+			seen += buckets[i];
+			if (seen >= rank) {
+				return LogBuckets::upperBound(i);
+			}
+		}
+		return maxValue();
+	}
+
+	// 最大值所在桶的上界
+	uint64_t maxValue() const {
+		for (int i = LogBuckets::bucketCount_ - 1; i >= 0; --i) {
+			if (buckets[i] != 0) {
+				return LogBuckets::upperBound(i);
+			}
+		}
+		return 0;
+	}
+
+	uint64_t mean() const {
+		return count == 0 ? 0 : sum / count;
+	}
+
+	// 相对于更早快照的增量
+	LogHistogramSnapshot since(const LogHistogramSnapshot& earlier) const {
+		LogHistogramSnapshot result;
+		result.count = count - earlier.count;
+		result.sum = sum - earlier.sum;
+		for (int i = 0; i < LogBuckets::bucketCount_; ++i) {
+			result.buckets[i] = buckets[i] - earlier.buckets[i];
+		}
+		return result;
+	}
+
+	// 合并另一个快照
+	void merge(const LogHistogramSnapshot& other) {
+		count += other.count;
+		sum += other.sum;
+		for (int i = 0; i < LogBuckets::bucketCount_; ++i) {
+			buckets[i] += other.buckets[i];
+		}
+	}
+};
+
+// 无锁延迟直方图，多线程并发记录
+class LogHistogram {
+public:
+	LogHistogram() : sum_(0) {
+		for (int i = 0; i < LogBuckets::bucketCount_; ++i) {
+			buckets_[i].store(0, std::memory_order_relaxed);
+		}
+	}
+
+	void record(uint64_t value) {
+		buckets_[LogBuckets::index(value)].fetch_add(1, std::memory_order_relaxed);
+		sum_.fetch_add(value, std::memory_order_relaxed);
+	}
+
+	// 只有一个线程记录时使用：不需要原子加，读取方仍可并发取快照
+	void recordLocal(uint64_t value) {
+		std::atomic<uint64_t>& bucket = buckets_[LogBuckets::index(value)];
+		bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		sum_.store(sum_.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+	}
+
+	// 读取快照，与 record 并发时各桶之间不保证一致
+	LogHistogramSnapshot snapshot() const {
+		LogHistogramSnapshot result;
+		for (int i = 0; i < LogBuckets::bucketCount_; ++i) {
+			result.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+			result.count += result.buckets[i];
+		}
+		result.sum = sum_.load(std::memory_order_relaxed);
+		return result;
+	}
+
+	// 单调时钟纳秒数，用于计时
+	static uint64_t now() {
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+private:
+	std::atomic<uint64_t> buckets_[LogBuckets::bucketCount_];
+	std::atomic<uint64_t> sum_;
+};
+
+#endif // LOG_STATS_H
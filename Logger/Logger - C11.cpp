@@ -7,81 +7,1467 @@
 #include <vector>
 #include <functional>
 #include <cstdarg>
+#include <cstring>
 #include <regex>
+#include <algorithm>
+#include <cctype>
 
 #ifdef _MSC_VER
 #include <windows.h>   // Windows API (VS2015 环境)
 #include <io.h>        // _unlink
+#include <sys/types.h>
+#include <sys/stat.h>  // 等级配置文件修改时间
+#include <process.h>   // _getpid
 #else
 #include <sys/stat.h>
 #include <dirent.h>  // POSIX 文件操作
+#include <unistd.h>  // getpid
 #endif
 
-Logger::Logger(const std::string& folderName, LogLevel level, bool daily, bool async, uint64_t logCycle, int retentionDays, size_t maxSize)
-	: folderName_(folderName), logLevel_(level), async_(async), logCycle_(logCycle),
-	daily_(daily), retentionDays_(retentionDays), maxSize_(maxSize), fileSize_(0), exit_(false),
-	currentFileIndex_(getMaxLogSequence() + 1) {
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <sys/syscall.h>
+#include <poll.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#endif
+
+#ifdef _WIN32
+const size_t Logger::lineEndSize_ = 2;
+const char* const Logger::lineEnd_ = "\r\n";
+#else
+const size_t Logger::lineEndSize_ = 1;
+const char* const Logger::lineEnd_ = "\n";
+#endif
+
+namespace {
+
+// 等级配置文件监视：Linux 上用 inotify 监视所在目录（编辑器常以改名方式保存），其他平台比较修改时间和大小
+class LevelConfigWatcher {
+public:
+	LevelConfigWatcher() : fd_(-1), modifyTime_(0), size_(0) {}
+
+	~LevelConfigWatcher() {
+		watch(std::string());
+	}
+
+	// 开始监视 path，空路径表示停止
+	void watch(const std::string& path) {
+#ifdef __linux__
+		if (fd_ >= 0) {
+			close(fd_);
+			fd_ = -1;
+		}
+#endif
+		path_ = path;
+		if (path_.empty()) {
+			return;
+		}
+		size_t slash = path_.find_last_of("/\\");
+		fileName_ = slash == std::string::npos ? path_ : path_.substr(slash + 1);
+#ifdef __linux__
+		std::string dir = slash == std::string::npos ? "." : path_.substr(0, slash + 1);
+		fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (fd_ >= 0 && inotify_add_watch(fd_, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+			close(fd_);
+			fd_ = -1;
+		}
+#endif
+		fileChanged();
+	}
+
+	// 最多等待 millis 毫秒，文件变化时返回 true
+	bool wait(int millis) {
+#ifdef __linux__
+		if (fd_ >= 0) {
+			struct pollfd pfd = { fd_, POLLIN, 0 };
+			if (poll(&pfd, 1, millis) <= 0) {
+				return false;
+			}
+			bool changed = false;
+			alignas(struct inotify_event) char buffer[4096];
+			ssize_t len;
+			while ((len = read(fd_, buffer, sizeof(buffer))) > 0) {
+				for (char* p = buffer; p < buffer + len;) {
+					struct inotify_event* event = reinterpret_cast<struct inotify_event*>(p);
+					if (event->len > 0 && fileName_ == event->name) {
+						changed = true;
+					}
+					p += sizeof(struct inotify_event) + event->len;
+				}
+			}
+			return changed;
+		}
+#endif
+		std::this_thread::sleep_for(std::chrono::milliseconds(millis));
+		return !path_.empty() && fileChanged();
+	}
+
+private:
+	int fd_;               // inotify 描述符，-1 表示使用修改时间
+	std::string path_;     // 配置文件路径
+	std::string fileName_; // 配置文件名（不含目录）
+	int64_t modifyTime_;   // 上次检查时的修改时间
+	int64_t size_;         // 上次检查时的文件大小
+
+	bool fileChanged() {
+		struct stat fileStat;
+		int64_t modifyTime = 0, size = -1;
+		if (stat(path_.c_str(), &fileStat) == 0) {
+			modifyTime = static_cast<int64_t>(fileStat.st_mtime);
+			size = static_cast<int64_t>(fileStat.st_size);
+		}
+		bool changed = modifyTime != modifyTime_ || size != size_;
+		modifyTime_ = modifyTime;
+		size_ = size;
+		return changed;
+	}
+};
+
+// 去掉首尾空白
+std::string trimText(const std::string& text) {
+	size_t begin = text.find_first_not_of(" \t\r");
+	if (begin == std::string::npos) {
+		return std::string();
+	}
+	size_t end = text.find_last_not_of(" \t\r");
+	return text.substr(begin, end - begin + 1);
+}
+
+// 等级名称（不区分大小写）转换为等级
+bool parseLevelName(const std::string& text, Logger::LogLevel& level) {
+	std::string name;
+	for (size_t i = 0; i < text.size(); ++i) {
+		name += static_cast<char>(toupper(static_cast<unsigned char>(text[i])));
+	}
+	if (name == "DEBUG") {
+		level = Logger::LogLevel::LOG_DEBUG;
+	}
+	else if (name == "INFO") {
+		level = Logger::LogLevel::LOG_INFO;
+	}
+	else if (name == "WARNING" || name == "WARN") {
+		level = Logger::LogLevel::LOG_WARNING;
+	}
+	else if (name == "ERROR") {
+		level = Logger::LogLevel::LOG_ERROR;
+	}
+	else {
+		return false;
+	}
+	return true;
+}
+
+// 当前线程的系统线程 ID，每个线程只查询一次
+uint64_t currentThreadId() {
+#if defined(_MSC_VER)
+	return GetCurrentThreadId();
+#elif defined(__linux__)
+	return static_cast<uint64_t>(syscall(SYS_gettid));
+#elif defined(__APPLE__)
+	uint64_t tid = 0;
+	pthread_threadid_np(nullptr, &tid);
+	return tid;
+#else
+	return std::hash<std::thread::id>()(std::this_thread::get_id());
+#endif
+}
+
+// 线程上下文：线程 ID、线程名和上下文字段，变化时重新生成前缀 "[tid name] [key=value ...] "
+struct ThreadContext {
+	uint64_t threadId;                                        // 系统线程 ID
+	std::string threadName;                                   // 线程名，可为空
+	std::vector<std::pair<std::string, std::string> > fields; // 上下文字段，按压入顺序
+	std::string prefix;                                       // 已生成的前缀
+	size_t fieldsOffset;                                      // 前缀中字段部分的起始位置（不输出线程 ID 时从此处开始）
+
+	ThreadContext() : threadId(currentThreadId()), fieldsOffset(0) {
+		render();
+	}
+
+	void render() {
+		prefix = "[" + std::to_string(threadId);
+		if (!threadName.empty()) {
+			prefix += " " + threadName;
+		}
+		prefix += "] ";
+		fieldsOffset = prefix.size();
+		if (!fields.empty()) {
+			prefix.push_back('[');
+			for (size_t i = 0; i < fields.size(); ++i) {
+				if (i > 0) {
+					prefix.push_back(' ');
+				}
+				prefix += fields[i].first + "=" + fields[i].second;
+			}
+			prefix += "] ";
+		}
+	}
+};
+
+ThreadContext& threadContext() {
+	static thread_local ThreadContext context;
+	return context;
+}
+
+std::atomic<uint64_t> nextLoggerId(1);// 日志器编号
+std::atomic<size_t> nextLatencyId(0);// 延迟指标编号
+
+// 当前线程的延迟直方图，按指标编号索引
+std::vector<std::shared_ptr<LogHistogram> >& threadLatencyShards() {
+	static thread_local std::vector<std::shared_ptr<LogHistogram> > shards;
+	return shards;
+}
+
+// recordLatency 的名称缓存，只对最近使用的日志器有效
+struct LatencyNameCache {
+	uint64_t loggerId;                                        // 缓存所属的日志器编号
+	std::map<std::string, Logger::LatencyMetric*> metrics;    // 名称到指标
+};
+
+LatencyNameCache& latencyNameCache() {
+	static thread_local LatencyNameCache cache = { 0, std::map<std::string, Logger::LatencyMetric*>() };
+	return cache;
+}
+
+} // namespace
+
+#ifndef _WIN32
+// POSIX 平台没有 localtime_s，使用线程安全的 localtime_r 代替
+static inline void localtime_s(std::tm* tm, const std::time_t* time) {
+	localtime_r(time, tm);
+}
+#endif
+
+Logger::Logger(const std::string& folderName, LogLevel level, bool daily, bool async, uint64_t logCycle, int retentionDays, size_t maxSize,
+	LogClockType clockType)
+	: folderName_(folderName), logLevel_(level), threadInfo_(false), async_(async), daily_(daily), exit_(false),
+	retentionDays_(retentionDays), maxSize_(maxSize), cacheMode_(LogCacheMode::NORMAL), priorityPending_(false),
+	priorityLevel_(static_cast<int>(LogLevel::LOG_ERROR) + 1), fileSize_(0), currentFileIndex_(getMaxLogSequence() + 1),
+	logCycle_(logCycle), clock_(clockType), timePrecision_(TimePrecision::MILLISECOND), currentDateHour_(getCurrentDateHour()),
+	queueHighWater_(0), recordsWritten_(0), bytesWritten_(0), rotations_(0), cleanRuns_(0), filesDeleted_(0), cleanFailures_(0),
+	statsInterval_(0), statsSeparateFile_(false), indexBytes_(64 * 1024), indexNanos_(1000000000ull), lastIndexOffset_(0),
+	lastIndexNanos_(0), indexNext_(true), writeSeq_(0), syncing_(false), syncedSeq_(0), consoleAsync_(false),
+	consoleEchoLevel_(static_cast<int>(LogLevel::LOG_ERROR) + 1), layout_(Layout::TEXT), sanitize_(false), tracing_(false),
+	traceFirstEvent_(true), traceEpoch_(0), sharded_(false), shardIndex_(0), shardEpoch_(0), ringClient_(false),
+	ringOverflow_(LogRingOverflow::DROP), liveBytes_(1024 * 1024), netRecords_(0), netSpilled_(0), flushPending_(false),
+	normalEnqueued_(0), priorityEnqueued_(0), normalWritten_(0), priorityWritten_(0), instanceId_(nextLoggerId.fetch_add(1)),
+	latencyInterval_(0), levelConfigChanged_(false) {
+
+	for (int i = 0; i < 4; ++i) {
+		recordCounts_[i].store(0, std::memory_order_relaxed);
+		durability_[i].store(static_cast<int>(Durability::PAGE_CACHE), std::memory_order_relaxed);
+	}
+
+	if (async_) {
+		logThread_ = std::thread(&Logger::logThreadFunction, this);
+	}
+
+#ifdef _MSC_VER
+	tracePid_ = std::to_string(_getpid());
+#else
+	tracePid_ = std::to_string(getpid());
+#endif
+	checkThread_ = std::thread(&Logger::checkThreadFunction, this);
+}
+
+Logger::~Logger() {
+	exit_ = true;
+	if (async_ && logThread_.joinable()) {
+		logThread_.join();
+	}
+	if (checkThread_.joinable()) {
+		checkThread_.join();
+	}
+	for (auto it = categories_.begin(); it != categories_.end(); ++it) {
+		delete it->second;
+	}
+	for (auto it = latencies_.begin(); it != latencies_.end(); ++it) {
+		delete it->second;
+	}
+	flushShards(false, true);
+	// 最后发送一次，仍未发出的记录写入日志文件
+	{
+		std::lock_guard<std::mutex> lock(logMutex_);
+		netSink_.flush();
+		spillNetLocked();
+		netSink_.close();
+		logFile_.flush();
+		for (size_t i = 0; i < closedFiles_.size(); ++i) {
+			LogFile::closeHandle(closedFiles_[i].fd);
+		}
+		closedFiles_.clear();
+	}
+	// 标记后由写日志进程取完剩余记录并删除环
+	if (ring_.isOpen()) {
+		ring_.markClosed();
+		ring_.close();
+	}
+	closeTraceFile();
+}
+
+void Logger::setLogLevel(LogLevel level) {
+	std::lock_guard<std::mutex> lock(categoryMutex_);
+	logLevel_.store(level, std::memory_order_relaxed);
+	updateCategoryLevels();
+}
+
+Logger::Category::Category(Logger& logger, const std::string& name, LogLevel level)
+	: logger_(logger), name_(name), level_(static_cast<int>(level)) {
+}
+
+void Logger::Category::log(const std::string& message, LogLevel level) {
+	if (!enabled(level)) return;
+
+	std::string text;
+	text.reserve(name_.size() + 3 + message.size());
+	text += '[';
+	text += name_;
+	text += "] ";
+	text += message;
+	logger_.countRecord(level);
+	logger_.submit(logger_.clock_.now(), level, text.data(), text.size());
+}
+
+Logger::Category& Logger::category(const std::string& name) {
+	std::lock_guard<std::mutex> lock(categoryMutex_);
+	auto it = categories_.find(name);
+	if (it != categories_.end()) {
+		return *it->second;
+	}
+	Category* category = new Category(*this, name, effectiveLevel(name));
+	categories_[name] = category;
+	return *category;
+}
+
+void Logger::setCategoryLevel(const std::string& name, LogLevel level) {
+	std::lock_guard<std::mutex> lock(categoryMutex_);
+	categoryLevels_[name] = level;
+	updateCategoryLevels();
+}
+
+void Logger::clearCategoryLevel(const std::string& name) {
+	std::lock_guard<std::mutex> lock(categoryMutex_);
+	categoryLevels_.erase(name);
+	updateCategoryLevels();
+}
+
+Logger::LogLevel Logger::effectiveLevel(const std::string& name) const {
+	std::string current = name;
+	while (true) {
+		auto it = categoryLevels_.find(current);
+		if (it != categoryLevels_.end()) {
+			return it->second;
+		}
+		size_t dot = current.rfind('.');
+		if (dot == std::string::npos) {
+			return logLevel_.load(std::memory_order_relaxed);
+		}
+		current.erase(dot);
+	}
+}
+
+void Logger::updateCategoryLevels() {
+	for (auto it = categories_.begin(); it != categories_.end(); ++it) {
+		it->second->level_.store(static_cast<int>(effectiveLevel(it->first)), std::memory_order_relaxed);
+	}
+}
+
+bool Logger::loadLevelConfig(const std::string& path) {
+	std::ifstream file(path);
+	if (!file.is_open()) {
+		return false;
+	}
+	std::map<std::string, LogLevel> levels;
+	bool hasRoot = false;
+	LogLevel rootLevel = LogLevel::LOG_INFO;
+	std::string line;
+	while (std::getline(file, line)) {
+		line = trimText(line);
+		size_t equal = line.find('=');
+		if (line.empty() || line[0] == '#' || equal == std::string::npos) {
+			continue;
+		}
+		std::string name = trimText(line.substr(0, equal));
+		LogLevel level;
+		if (name.empty() || !parseLevelName(trimText(line.substr(equal + 1)), level)) {
+			continue;
+		}
+		if (name == "root") {
+			hasRoot = true;
+			rootLevel = level;
+		}
+		else {
+			levels[name] = level;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(categoryMutex_);
+	if (hasRoot) {
+		logLevel_.store(rootLevel, std::memory_order_relaxed);
+	}
+	categoryLevels_.swap(levels);
+	updateCategoryLevels();
+	return true;
+}
+
+void Logger::watchLevelConfig(const std::string& path) {
+	if (!path.empty()) {
+		loadLevelConfig(path);
+	}
+	std::lock_guard<std::mutex> lock(categoryMutex_);
+	levelConfigPath_ = path;
+	levelConfigChanged_ = true;
+}
+
+void Logger::setTimePrecision(TimePrecision precision) {
+	std::lock_guard<std::mutex> lock(logMutex_);
+	timePrecision_ = precision;
+}
+
+Logger::LatencyMetric::LatencyMetric(const std::string& name)
+	: name_(name), id_(nextLatencyId.fetch_add(1)) {}
+
+void Logger::LatencyMetric::record(uint64_t nanos) {
+	std::vector<std::shared_ptr<LogHistogram> >& shards = threadLatencyShards();
+	if (id_ >= shards.size()) {
+		shards.resize(id_ + 1);
+	}
+	if (!shards[id_]) {
+		// 本线程第一次记录该指标：创建直方图并登记，供检测线程合并
+		shards[id_] = std::make_shared<LogHistogram>();
+		std::lock_guard<std::mutex> lock(shardMutex_);
+		shards_.push_back(shards[id_]);
+	}
+	shards[id_]->recordLocal(nanos);
+}
+
+LogHistogramSnapshot Logger::LatencyMetric::snapshot() {
+	LogHistogramSnapshot result;
+	std::lock_guard<std::mutex> lock(shardMutex_);
+	for (size_t i = 0; i < shards_.size(); ++i) {
+		result.merge(shards_[i]->snapshot());
+	}
+	return result;
+}
+
+Logger::LatencyMetric& Logger::latency(const std::string& name) {
+	std::lock_guard<std::mutex> lock(latencyMutex_);
+	LatencyMetric*& metric = latencies_[name];
+	if (metric == nullptr) {
+		metric = new LatencyMetric(name);
+	}
+	return *metric;
+}
+
+void Logger::recordLatency(const std::string& name, uint64_t nanos) {
+	LatencyNameCache& cache = latencyNameCache();
+	if (cache.loggerId != instanceId_) {
+		cache.metrics.clear();
+		cache.loggerId = instanceId_;
+	}
+	LatencyMetric*& metric = cache.metrics[name];
+	if (metric == nullptr) {
+		metric = &latency(name);
+	}
+	metric->record(nanos);
+}
+
+void Logger::setLatencyOutput(uint64_t interval) {
+	latencyInterval_ = interval;
+}
+
+void Logger::writeLatencies() {
+	std::vector<LatencyMetric*> metrics;
+	{
+		std::lock_guard<std::mutex> lock(latencyMutex_);
+		for (auto it = latencies_.begin(); it != latencies_.end(); ++it) {
+			metrics.push_back(it->second);
+		}
+	}
+	for (size_t i = 0; i < metrics.size(); ++i) {
+		LatencyMetric& metric = *metrics[i];
+		LogHistogramSnapshot total = metric.snapshot();
+		LogHistogramSnapshot interval = total.since(metric.last_);
+		metric.last_ = total;
+		if (interval.count == 0) {
+			continue;
+		}
+		char line[256];
+		int length = snprintf(line, sizeof(line), "latency name=%s count=%llu p50_us=%.3f p99_us=%.3f max_us=%.3f mean_us=%.3f",
+			metric.name().c_str(), static_cast<unsigned long long>(interval.count),
+			static_cast<double>(interval.percentile(0.50)) / 1e3, static_cast<double>(interval.percentile(0.99)) / 1e3,
+			static_cast<double>(interval.maxValue()) / 1e3, static_cast<double>(interval.mean()) / 1e3);
+		if (length > 0) {
+			submit(clock_.now(), LogLevel::LOG_INFO, line, std::min(static_cast<size_t>(length), sizeof(line) - 1));
+		}
+	}
+}
+
+void Logger::setSharded(bool enable) {
+	if (enable) {
+		std::lock_guard<std::mutex> lock(shardMutex_);
+		if (!sharded_) {
+			shardDateHour_ = getCurrentDateHour();
+			shardIndex_ = getMaxLogSequence() + 1;
+			shardPrefix_ = folderName_ + "/" + shardDateHour_ + "_" + std::to_string(shardIndex_);
+			shardEpoch_.fetch_add(1, std::memory_order_release);
+			sharded_ = true;
+		}
+	}
+	else {
+		sharded_ = false;
+		flushShards(false, true);
+	}
+	// 追踪文件改为按新的模式命名
+	std::lock_guard<std::mutex> lock(logMutex_);
+	closeTraceFile();
+}
+
+Logger::Shard& Logger::localShard() {
+	// 每个线程在各日志器中的分片，按日志器编号查找；日志器析构后其分片只剩这里的引用，顺便移除
+	static thread_local std::vector<std::pair<uint64_t, std::shared_ptr<Shard> > > localShards;
+	for (size_t i = 0; i < localShards.size(); ++i) {
+		if (localShards[i].first == instanceId_) {
+			return *localShards[i].second;
+		}
+	}
+	for (size_t i = localShards.size(); i > 0; --i) {
+		if (localShards[i - 1].second.use_count() == 1) {
+			localShards.erase(localShards.begin() + (i - 1));
+		}
+	}
+	std::shared_ptr<Shard> shard = std::make_shared<Shard>();
+	shard->threadId = threadContext().threadId;
+	{
+		std::lock_guard<std::mutex> lock(shardMutex_);
+		shards_.push_back(shard);
+	}
+	localShards.push_back(std::make_pair(instanceId_, shard));
+	return *shard;
+}
+
+void Logger::writeToShard(uint64_t tick, LogLevel level, const char* context, size_t contextLen, const char* message, size_t len,
+	bool structured) {
+	Shard& shard = localShard();
+	std::unique_lock<std::mutex> lock(shard.mutex);
+	if (shard.epoch != shardEpoch_.load(std::memory_order_acquire) || !shard.file.is_open()) {
+		std::string prefix;
+		{
+			std::lock_guard<std::mutex> shardLock(shardMutex_);
+			prefix = shardPrefix_;
+			shard.epoch = shardEpoch_.load(std::memory_order_relaxed);
+		}
+		shard.file.close();
+		shard.file.setCacheMode(cacheMode_.load(std::memory_order_relaxed));
+		if (!shard.file.open(prefix + "." + std::to_string(shard.threadId) + ".log")) {
+			return;
+		}
+	}
+
+	// TSC 的换算不是线程安全的，分片模式下改用系统时钟
+	uint64_t nanos = clock_.wallNanos(tick);
+	std::string& out = shard.line;
+	formatLine(nanos, shard.timeCache, level, context, contextLen, message, len, structured, out);
+	// 控制台可能阻塞，复制一份在释放分片锁后回显
+	std::string echo;
+	if (static_cast<int>(level) >= consoleEchoLevel_.load(std::memory_order_relaxed)) {
+		echo = out;
+	}
+	out += lineEnd_;
+	shard.file.write(out.data(), out.size());
+
+	// 只有所属线程修改，不需要原子加
+	std::atomic<uint64_t>& count = shard.records[static_cast<int>(level)];
+	count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	shard.bytes.store(shard.bytes.load(std::memory_order_relaxed) + out.size(), std::memory_order_relaxed);
+
+	// 与同步模式相同，逐条写入内核
+	Durability durability = static_cast<Durability>(durability_[static_cast<int>(level)].load(std::memory_order_relaxed));
+	if (durability == Durability::SYNC) {
+		shard.file.sync();
+	}
+	else if (durability != Durability::NONE) {
+		shard.file.flush();
+	}
+	if (shard.file.size() >= maxSize_) {
+		rotateShards(shard.epoch);
+	}
+	lock.unlock();
+	if (!echo.empty()) {
+		echoConsole(level, echo);
+	}
+}
+
+void Logger::rotateShards(uint64_t epoch) {
+	std::lock_guard<std::mutex> lock(shardMutex_);
+	if (shardEpoch_.load(std::memory_order_relaxed) != epoch) {
+		return;
+	}
+	std::string dateHour = getCurrentDateHour();
+	if (dateHour != shardDateHour_) {
+		shardDateHour_ = dateHour;
+		shardIndex_ = 0;
+	}
+	else {
+		++shardIndex_;
+	}
+	shardPrefix_ = folderName_ + "/" + shardDateHour_ + "_" + std::to_string(shardIndex_);
+	shardEpoch_.fetch_add(1, std::memory_order_release);
+	rotations_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Logger::flushShards(bool sync, bool closeAll) {
+	std::vector<std::shared_ptr<Shard> > shards;
+	{
+		std::lock_guard<std::mutex> lock(shardMutex_);
+		shards = shards_;
+	}
+	uint64_t epoch = shardEpoch_.load(std::memory_order_acquire);
+	for (size_t i = 0; i < shards.size(); ++i) {
+		Shard& shard = *shards[i];
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		if (!shard.file.is_open()) {
+			continue;
+		}
+		if (closeAll || shard.epoch != epoch) {
+			// 整组切换后仍未写入的线程，由这里关闭其旧文件
+			if (sync) {
+				shard.file.sync();
+			}
+			shard.file.close();
+		}
+		else if (sync) {
+			shard.file.sync();
+		}
+		else {
+			shard.file.flush();
+		}
+	}
+}
+
+bool Logger::setSharedRing(bool enable, LogRingOverflow overflow, size_t ringBytes) {
+	std::lock_guard<std::mutex> lock(ringMutex_);
+	ringOverflow_ = overflow;
+	if (enable && !ring_.isOpen() && !ring_.create(LogRing::directory(folderName_), ringBytes)) {
+		std::cerr << "Failed to create shared ring for: " << folderName_ << std::endl;
+		return false;
+	}
+	ringClient_ = enable;
+	return true;
+}
+
+bool Logger::setNetworkSink(const std::string& endpoint, LogNetFraming framing, size_t bufferBytes) {
+	std::lock_guard<std::mutex> lock(logMutex_);
+	// 更换或关闭前发出已缓冲的记录，发不出的写入日志文件
+	netSink_.flush();
+	spillNetLocked();
+	netSink_.close();
+	if (endpoint.empty()) {
+		return true;
+	}
+	if (!netSink_.open(endpoint, framing, bufferBytes)) {
+		std::cerr << "Failed to open network sink: " << endpoint << std::endl;
+		return false;
+	}
+	return true;
+}
+
+void Logger::writeRecord(uint64_t nanos, LogLevel level, const char* context, size_t contextLen, const char* message, size_t len) {
+	countRecord(level);
+	// 保留记录产生时的时间，不换成本进程的时钟
+	submit(clock_.fromNanos(nanos), level, context, contextLen, message, len);
+}
+
+void Logger::setTracing(bool enable) {
+	tracing_ = enable;
+}
+
+void Logger::submitSpan(uint64_t beginTick, uint64_t endTick, const char* name, size_t len) {
+	// 环中只有日志记录，客户端模式下不支持追踪
+	if (ringClient_.load(std::memory_order_relaxed)) {
+		return;
+	}
+	// 二进制格式：开始时钟值、线程 ID，之后为名称；结束时钟值存于记录本身
+	uint64_t header[2] = { beginTick, threadContext().threadId };
+	if (async_) {
+		LogPoolRecord* record = LogRecordPool::instance().acquire(endTick, spanRecordLevel_,
+			reinterpret_cast<const char*>(header), sizeof(header), name, len);
+		std::lock_guard<std::mutex> lock(logQueueMutex_);
+		logQueue_.push_back(record);
+		++normalEnqueued_;
+		if (logQueue_.size() > queueHighWater_) {
+			queueHighWater_ = logQueue_.size();
+		}
+	}
+	else {
+		std::lock_guard<std::mutex> lock(logMutex_);
+		writeSpan(beginTick, endTick, header[1], name, len);
+	}
+}
+
+void Logger::writeSpan(uint64_t beginTick, uint64_t endTick, uint64_t threadId, const char* name, size_t len) {
+	if (sharded_.load(std::memory_order_relaxed)) {
+		// 分片模式下追踪文件与当前分片组同名，随分片组切换
+		if (traceFile_.is_open() && traceEpoch_ != shardEpoch_.load(std::memory_order_acquire)) {
+			closeTraceFile();
+		}
+	}
+	else if (!logFile_.is_open()) {
+		openLogFile();
+	}
+	if (!traceFile_.is_open()) {
+		// 追踪文件与当前日志文件同名，随日志文件切换
+		std::string prefix;
+		if (sharded_.load(std::memory_order_relaxed)) {
+			std::lock_guard<std::mutex> lock(shardMutex_);
+			prefix = shardPrefix_;
+			traceEpoch_ = shardEpoch_.load(std::memory_order_relaxed);
+		}
+		else {
+			prefix = getLogFilePrefix();
+		}
+		if (!traceFile_.open(prefix + ".trace.json")) {
+			return;
+		}
+		traceFirstEvent_ = traceFile_.size() == 0;
+		if (traceFirstEvent_) {
+			traceFile_.write("[\n", 2);
+		}
+	}
+	uint64_t beginNanos = clock_.toNanos(beginTick);
+	uint64_t endNanos = clock_.toNanos(endTick);
+	uint64_t duration = endNanos > beginNanos ? endNanos - beginNanos : 0;
+
+	std::string& out = traceBuffer_;
+	out.clear();
+	if (!traceFirstEvent_) {
+		out.append(",\n", 2);
+	}
+	traceFirstEvent_ = false;
+	out.append("{\"name\":\"", 9);
+	for (size_t i = 0; i < len; ++i) {
+		unsigned char c = static_cast<unsigned char>(name[i]);
+		if (c == '"' || c == '\\') {
+			out.push_back('\\');
+			out.push_back(static_cast<char>(c));
+		}
+		else if (c < 0x20) {
+			char escaped[8];
+			snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+			out.append(escaped, 6);
+		}
+		else {
+			out.push_back(static_cast<char>(c));
+		}
+	}
+	// ts、dur 单位为微秒，保留纳秒精度
+	char fields[160];
+	int length = snprintf(fields, sizeof(fields), "\",\"ph\":\"X\",\"ts\":%llu.%03u,\"dur\":%llu.%03u,\"pid\":%s,\"tid\":%llu}",
+		static_cast<unsigned long long>(beginNanos / 1000), static_cast<unsigned int>(beginNanos % 1000),
+		static_cast<unsigned long long>(duration / 1000), static_cast<unsigned int>(duration % 1000),
+		tracePid_.c_str(), static_cast<unsigned long long>(threadId));
+	if (length > 0) {
+		out.append(fields, std::min(static_cast<size_t>(length), sizeof(fields) - 1));
+	}
+	traceFile_.write(out.data(), out.size());
+}
+
+void Logger::closeTraceFile() {
+	if (traceFile_.is_open()) {
+		traceFile_.write("\n]\n", 3);
+		traceFile_.close();
+	}
+}
+
+void Logger::setThreadInfo(bool enable) {
+	threadInfo_ = enable;
+}
+
+void Logger::setThreadName(const std::string& name) {
+	ThreadContext& context = threadContext();
+	context.threadName = name;
+	context.render();
+}
+
+void Logger::pushContext(const std::string& key, const std::string& value) {
+	ThreadContext& context = threadContext();
+	context.fields.push_back(std::make_pair(key, value));
+	context.render();
+}
+
+void Logger::popContext() {
+	ThreadContext& context = threadContext();
+	if (!context.fields.empty()) {
+		context.fields.pop_back();
+		context.render();
+	}
+}
+
+Logger::Stats Logger::getStats() {
+	Stats stats;
+	for (int i = 0; i < 4; ++i) {
+		stats.records[i] = recordCounts_[i].load(std::memory_order_relaxed);
+	}
+	stats.recordsWritten = recordsWritten_.load(std::memory_order_relaxed);
+	stats.bytesWritten = bytesWritten_.load(std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> lock(shardMutex_);
+		for (size_t s = 0; s < shards_.size(); ++s) {
+			for (int i = 0; i < 4; ++i) {
+				uint64_t count = shards_[s]->records[i].load(std::memory_order_relaxed);
+				stats.records[i] += count;
+				stats.recordsWritten += count;
+			}
+			stats.bytesWritten += shards_[s]->bytes.load(std::memory_order_relaxed);
+		}
+	}
+	{
+		std::lock_guard<std::mutex> lock(logQueueMutex_);
+		stats.queueDepth = logQueue_.size();
+		stats.queueHighWater = queueHighWater_;
+	}
+	stats.rotations = rotations_.load(std::memory_order_relaxed);
+	stats.cleanRuns = cleanRuns_.load(std::memory_order_relaxed);
+	stats.filesDeleted = filesDeleted_.load(std::memory_order_relaxed);
+	stats.cleanFailures = cleanFailures_.load(std::memory_order_relaxed);
+	stats.backpressureWait = backpressureHistogram_.snapshot();
+	stats.writeBatch = writeBatchHistogram_.snapshot();
+	stats.writeBatchSize = writeBatchSizeHistogram_.snapshot();
+	stats.rotation = rotationHistogram_.snapshot();
+	stats.clean = cleanHistogram_.snapshot();
+	{
+		std::lock_guard<std::mutex> lock(priorityQueueMutex_);
+		stats.priorityQueueDepth = priorityQueue_.size();
+	}
+	stats.priorityLatency = priorityLatencyHistogram_.snapshot();
+	stats.sync = syncHistogram_.snapshot();
+	stats.poolBytes = LogRecordPool::instance().allocatedBytes();
+	stats.consoleDropped = console_.dropped();
+	{
+		std::lock_guard<std::mutex> lock(ringMutex_);
+		stats.ringDropped = ring_.isOpen() ? ring_.dropped() : 0;
+	}
+	stats.netRecords = netRecords_.load(std::memory_order_relaxed);
+	stats.netSpilled = netSpilled_.load(std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> lock(logMutex_);
+		stats.netReconnects = netSink_.reconnects();
+		stats.netPending = netSink_.pendingRecords();
+	}
+	return stats;
+}
+
+void Logger::setPriorityLane(bool enable, LogLevel level) {
+	priorityLevel_.store(enable ? static_cast<int>(level) : static_cast<int>(LogLevel::LOG_ERROR) + 1, std::memory_order_relaxed);
+}
+
+void Logger::setDurability(LogLevel level, Durability durability) {
+	durability_[static_cast<int>(level)].store(static_cast<int>(durability), std::memory_order_relaxed);
+}
+
+void Logger::flush() {
+	flushAsync().wait();
+}
+
+std::future<void> Logger::flushAsync() {
+	FlushRequest request;
+	std::future<void> future = request.promise.get_future();
+	flushBarrier(request);
+	return future;
+}
+
+void Logger::flushAsync(const std::function<void()>& done) {
+	FlushRequest request;
+	request.callback = done;
+	flushBarrier(request);
+}
+
+void Logger::flushBarrier(FlushRequest& request) {
+	flushShards(true);
+	if (!async_) {
+		uint64_t target;
+		{
+			std::lock_guard<std::mutex> lock(logMutex_);
+			flushLocked();
+			target = writeSeq_;
+		}
+		syncTo(target);
+		request.promise.set_value();
+		if (request.callback) {
+			request.callback();
+		}
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(logQueueMutex_);
+		request.normalTarget = normalEnqueued_;
+	}
+	{
+		std::lock_guard<std::mutex> lock(priorityQueueMutex_);
+		request.priorityTarget = priorityEnqueued_;
+	}
+	{
+		std::lock_guard<std::mutex> lock(flushMutex_);
+		flushRequests_.push_back(std::move(request));
+		flushPending_.store(true, std::memory_order_release);
+	}
+	std::lock_guard<std::mutex> lock(priorityQueueMutex_);
+	priorityQueueCond_.notify_one();
+}
+
+void Logger::syncTo(uint64_t target) {
+	std::unique_lock<std::mutex> lock(syncMutex_);
+	while (syncedSeq_ < target) {
+		if (syncing_) {
+			syncCond_.wait(lock);
+			continue;
+		}
+		syncing_ = true;
+		lock.unlock();
+
+		// 复制描述符后在写锁外落盘，期间其他线程可以继续写入，由下一次落盘覆盖；
+		// 此前切换时关闭的旧文件一并落盘
+		uint64_t covered;
+		int fd;
+		std::vector<ClosedFile> closed;
+		{
+			std::lock_guard<std::mutex> fileLock(logMutex_);
+			logFile_.flush();
+			covered = writeSeq_;
+			fd = logFile_.duplicateHandle();
+			closed.swap(closedFiles_);
+		}
+		uint64_t syncStart = LogHistogram::now();
+		for (size_t i = 0; i < closed.size(); ++i) {
+			LogFile::syncHandle(closed[i].fd);
+			if (closed[i].drop) {
+				LogFile::dropHandle(closed[i].fd);
+			}
+			LogFile::closeHandle(closed[i].fd);
+		}
+		if (fd >= 0) {
+			LogFile::syncHandle(fd);
+			LogFile::closeHandle(fd);
+		}
+		if (fd >= 0 || !closed.empty()) {
+			syncHistogram_.record(LogHistogram::now() - syncStart);
+		}
+
+		lock.lock();
+		syncing_ = false;
+		if (covered > syncedSeq_) {
+			syncedSeq_ = covered;
+		}
+		syncCond_.notify_all();
+	}
+}
+
+void Logger::completeBatch(uint64_t syncTarget) {
+	{
+		std::lock_guard<std::mutex> lock(logMutex_);
+		flushLocked();
+		traceFile_.flush();
+	}
+
+	std::vector<FlushRequest> ready;
+	if (flushPending_.load(std::memory_order_acquire)) {
+		std::lock_guard<std::mutex> lock(flushMutex_);
+		std::vector<FlushRequest> waiting;
+		for (size_t i = 0; i < flushRequests_.size(); ++i) {
+			FlushRequest& request = flushRequests_[i];
+			if (request.normalTarget <= normalWritten_ && request.priorityTarget <= priorityWritten_) {
+				ready.push_back(std::move(request));
+			}
+			else {
+				waiting.push_back(std::move(request));
+			}
+		}
+		flushRequests_.swap(waiting);
+		flushPending_.store(!flushRequests_.empty(), std::memory_order_relaxed);
+	}
+	if (!ready.empty()) {
+		std::lock_guard<std::mutex> lock(logMutex_);
+		syncTarget = writeSeq_;
+	}
+	if (syncTarget != 0) {
+		syncTo(syncTarget);
+	}
+	for (size_t i = 0; i < ready.size(); ++i) {
+		ready[i].promise.set_value();
+		if (ready[i].callback) {
+			ready[i].callback();
+		}
+	}
+}
 
-	if (async_) {
-		logThread_ = std::thread(&Logger::logThreadFunction, this);
+void Logger::setStatsOutput(uint64_t interval, bool separateFile) {
+	statsSeparateFile_ = separateFile;
+	statsInterval_ = interval;
+}
+
+void Logger::writeStats(Stats& last, uint64_t elapsedMillis) {
+	Stats stats = getStats();
+	double seconds = elapsedMillis > 0 ? static_cast<double>(elapsedMillis) / 1000.0 : 1.0;
+	LogHistogramSnapshot backpressure = stats.backpressureWait.since(last.backpressureWait);
+	LogHistogramSnapshot batch = stats.writeBatch.since(last.writeBatch);
+	LogHistogramSnapshot rotation = stats.rotation.since(last.rotation);
+	uint64_t records = 0;
+	for (int i = 0; i < 4; ++i) {
+		records += stats.records[i];
 	}
 
-	checkThread_ = std::thread(&Logger::checkThreadFunction, this);
+	char line[512];
+	snprintf(line, sizeof(line), "logger stats: records=%llu written=%llu bytes=%llu bytes_per_sec=%.0f queue=%llu queue_max=%llu "
+		"backpressure_waits=%llu backpressure_max_us=%.1f batches=%llu batch_p99_us=%.1f rotations=%llu rotation_max_us=%.1f "
+		"clean_runs=%llu files_deleted=%llu clean_failures=%llu clean_max_ms=%.1f",
+		static_cast<unsigned long long>(records), static_cast<unsigned long long>(stats.recordsWritten),
+		static_cast<unsigned long long>(stats.bytesWritten), static_cast<double>(stats.bytesWritten - last.bytesWritten) / seconds,
+		static_cast<unsigned long long>(stats.queueDepth), static_cast<unsigned long long>(stats.queueHighWater),
+		static_cast<unsigned long long>(backpressure.count), static_cast<double>(backpressure.maxValue()) / 1e3,
+		static_cast<unsigned long long>(batch.count), static_cast<double>(batch.percentile(0.99)) / 1e3,
+		static_cast<unsigned long long>(rotation.count), static_cast<double>(rotation.maxValue()) / 1e3,
+		static_cast<unsigned long long>(stats.cleanRuns), static_cast<unsigned long long>(stats.filesDeleted),
+		static_cast<unsigned long long>(stats.cleanFailures), static_cast<double>(stats.clean.maxValue()) / 1e6);
+
+	if (statsSeparateFile_) {
+		std::string text;
+		{
+			std::lock_guard<std::mutex> lock(logMutex_);
+			formatRecord(clock_.now(), LogLevel::LOG_INFO, nullptr, 0, line, strlen(line), text);
+		}
+		if (!statsFile_.is_open()) {
+			statsFile_.open(folderName_ + "/logger_stats.log", std::ios::out | std::ios::app);
+		}
+		statsFile_ << text << std::endl;
+	}
+	else {
+		submit(clock_.now(), LogLevel::LOG_INFO, line, strlen(line));
+	}
+	last = stats;
 }
 
-Logger::~Logger() {
-	exit_ = true;
-	if (async_ && logThread_.joinable()) {
-		logThread_.join();
+void Logger::log(const std::string& message, LogLevel level) {
+	log(message.data(), message.size(), level);
+}
+
+void Logger::log(const char* message, LogLevel level) {
+	if (message == nullptr) return;
+	log(message, strlen(message), level);
+}
+
+void Logger::log(const char* message, size_t len, LogLevel level) {
+	if (!enabled(level) || message == nullptr) return;
+
+	countRecord(level);
+	submit(clock_.now(), level, message, len);
+}
+
+void Logger::log(std::string&& message, LogLevel level) {
+	if (!enabled(level)) return;
+
+	countRecord(level);
+	submit(clock_.now(), level, message.data(), message.size());
+}
+
+void Logger::logFields(LogLevel level, const char* message, size_t len, const LogField* fields, size_t count) {
+	if (!enabled(level) || message == nullptr) return;
+
+	// 编码缓冲区按线程复用，只复制不格式化
+	static thread_local std::string encoded;
+	encoded.clear();
+	LogFieldCodec::encode(encoded, message, len, fields, count);
+	countRecord(level);
+	submit(clock_.now(), level, encoded.data(), encoded.size(), true);
+}
+
+void Logger::LogBatch::add(LogLevel level, const char* message, size_t len) {
+	if (!logger_.enabled(level) || message == nullptr) return;
+
+	append(level, message, len, false);
+}
+
+void Logger::LogBatch::addFields(LogLevel level, const char* message, size_t len, const LogField* fields, size_t count) {
+	if (message == nullptr) return;
+
+	static thread_local std::string encoded;
+	encoded.clear();
+	LogFieldCodec::encode(encoded, message, len, fields, count);
+	append(level, encoded.data(), encoded.size(), true);
+}
+
+void Logger::LogBatch::append(LogLevel level, const char* message, size_t len, bool structured) {
+	if (tick_ == 0) {
+		tick_ = logger_.clock_.now();
 	}
-	if (checkThread_.joinable()) {
-		checkThread_.join();
+	const ThreadContext& thread = threadContext();
+	size_t contextOffset = logger_.threadInfo_.load(std::memory_order_relaxed) ? 0 : thread.fieldsOffset;
+	records_.push_back(LogRecordPool::instance().acquire(tick_, static_cast<int>(level) | (structured ? structuredRecordFlag_ : 0),
+		thread.prefix.data() + contextOffset, thread.prefix.size() - contextOffset, message, len));
+	logger_.countRecord(level);
+}
+
+void Logger::LogBatch::commit() {
+	if (!records_.empty()) {
+		logger_.submitBatch(tick_, records_);
 	}
+	tick_ = 0;
 }
 
-void Logger::setLogLevel(LogLevel level) {
-	logLevel_ = level;
+Logger::Subscription::Subscription(Logger& logger, LogLevel level, bool fromOldest)
+	: reader_(logger.liveRing(), fromOldest), level_(static_cast<int>(level)) {
 }
 
-void Logger::log(const std::string& message, LogLevel level) {
-	log(message.c_str(), level);
+bool Logger::Subscription::next(std::string& line, LogLevel* level) {
+	int recordLevel;
+	if (!reader_.next(line, recordLevel, level_)) {
+		return false;
+	}
+	if (level != nullptr) {
+		*level = static_cast<LogLevel>(recordLevel);
+	}
+	return true;
 }
 
-void Logger::log(const char* message, LogLevel level) {
-	if (level < logLevel_ || message == nullptr) return;
+LogCacheMode Logger::setCacheMode(LogCacheMode mode) {
+	cacheMode_.store(mode, std::memory_order_relaxed);
+	std::lock_guard<std::mutex> lock(logMutex_);
+	return logFile_.setCacheMode(mode);
+}
+
+void Logger::setLiveBuffer(size_t bytes) {
+	std::lock_guard<std::mutex> lock(logMutex_);
+	liveBytes_ = bytes;
+}
+
+LogBroadcast& Logger::liveRing() {
+	std::lock_guard<std::mutex> lock(logMutex_);
+	if (!live_) {
+		live_.reset(new LogBroadcast(liveBytes_));
+	}
+	return *live_;
+}
+
+bool Logger::tryLog(const char* message, size_t len, LogLevel level, bool force) {
+	if (!enabled(level) || message == nullptr) return true;
+
+	// 高优先级等级走单独的队列，不受普通队列上限影响
+	if (async_ && !force && !ringClient_.load(std::memory_order_relaxed) && !sharded_.load(std::memory_order_relaxed)
+		&& static_cast<int>(level) < priorityLevel_.load(std::memory_order_relaxed)) {
+		std::lock_guard<std::mutex> lock(logQueueMutex_);
+		if (logQueue_.size() >= maxQueueSize_) {
+			return false;
+		}
+	}
+	countRecord(level);
+	submit(clock_.now(), level, message, len, false, false);
+	return true;
+}
+
+bool Logger::waitQueueSpace(const std::function<void()>& ready) {
+	if (!async_ || exit_) {
+		return false;
+	}
+	std::lock_guard<std::mutex> lock(logQueueMutex_);
+	if (logQueue_.size() < maxQueueSize_) {
+		return false;
+	}
+	spaceWaiters_.push_back(ready);
+	return true;
+}
+
+void Logger::setLayout(Layout layout) {
+	layout_.store(layout, std::memory_order_relaxed);
+}
+
+void Logger::setSanitize(bool enable) {
+	sanitize_.store(enable, std::memory_order_relaxed);
+}
 
-	std::stringstream logStream;
-	logStream << "[" << getCurrentTime() << " " << logLevelToString(level) << "] " << message;
+void Logger::submit(uint64_t tick, LogLevel level, const char* message, size_t len, bool structured, bool wait) {
+	// 线程上下文前缀已预先生成，这里只取其位置
+	const ThreadContext& thread = threadContext();
+	size_t contextOffset = threadInfo_.load(std::memory_order_relaxed) ? 0 : thread.fieldsOffset;
+	submit(tick, level, thread.prefix.data() + contextOffset, thread.prefix.size() - contextOffset, message, len, structured,
+		wait);
+}
 
+void Logger::submit(uint64_t tick, LogLevel level, const char* context, size_t contextLen, const char* message, size_t len,
+	bool structured, bool wait) {
+	if (ringClient_.load(std::memory_order_relaxed)) {
+		// TSC 的换算不是线程安全的，改用系统时钟
+		uint64_t nanos = clock_.wallNanos(tick);
+		if (structured) {
+			// 环中只有文本记录，结构化字段在这里展开为 key=value
+			static thread_local std::string text;
+			text.clear();
+			LogFieldCodec::renderText(text, message, len);
+			message = text.data();
+			len = text.size();
+		}
+		std::lock_guard<std::mutex> lock(ringMutex_);
+		ring_.push(nanos, static_cast<int>(level), context, contextLen, message, len, ringOverflow_);
+		return;
+	}
+	if (sharded_.load(std::memory_order_relaxed)) {
+		writeToShard(tick, level, context, contextLen, message, len, structured);
+		return;
+	}
 	if (async_) {
+		// 在锁外复制消息，队列锁内只链接记录；结构化记录在等级上加标记，由写日志线程展开
+		LogPoolRecord* record = LogRecordPool::instance().acquire(tick,
+			static_cast<int>(level) | (structured ? structuredRecordFlag_ : 0), context, contextLen, message, len);
+		// 高优先级队列满时退回普通队列，由普通队列限流
+		if (static_cast<int>(level) >= priorityLevel_.load(std::memory_order_relaxed)) {
+			std::lock_guard<std::mutex> lock(priorityQueueMutex_);
+			if (priorityQueue_.size() < maxQueueSize_) {
+				priorityQueue_.push_back(record);
+				++priorityEnqueued_;
+				priorityPending_.store(true, std::memory_order_release);
+				priorityQueueCond_.notify_one();
+				return;
+			}
+		}
+		bool full;
 		{
 			std::lock_guard<std::mutex> lock(logQueueMutex_);
-			logQueue_.push_back(logStream.str());
-			if (logQueue_.size() >= maxQueueSize_) {
-				std::this_thread::sleep_for(std::chrono::milliseconds(1));// 等待日志打印，防止累积
+			logQueue_.push_back(record);
+			++normalEnqueued_;
+			if (logQueue_.size() > queueHighWater_) {
+				queueHighWater_ = logQueue_.size();
 			}
+			full = wait && logQueue_.size() >= maxQueueSize_;
+		}
+		// 释放队列锁后再等待，写日志线程才能取走记录
+		if (full) {
+			uint64_t waitStart = LogHistogram::now();
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));// 等待日志打印，防止累积
+			backpressureHistogram_.record(LogHistogram::now() - waitStart);
 		}
 	}
 	else {
-		writeToFile(logStream.str());
+		uint64_t syncTarget = writeToFile(tick, level, context, contextLen, message, len, structured);
+		if (syncTarget != 0) {
+			syncTo(syncTarget);
+		}
 	}
 }
 
+void Logger::submitBatch(uint64_t tick, LogRecordList& records) {
+	LogRecordPool& pool = LogRecordPool::instance();
+	if (async_ && !ringClient_.load(std::memory_order_relaxed) && !sharded_.load(std::memory_order_relaxed)) {
+		// 高优先级记录放得下时分到高优先级队列，否则整批按原顺序进入普通队列
+		int priorityLevel = priorityLevel_.load(std::memory_order_relaxed);
+		size_t priorityCount = 0;
+		for (LogPoolRecord* record = records.front(); record != nullptr; record = record->next) {
+			priorityCount += (record->level & ~structuredRecordFlag_) >= priorityLevel ? 1 : 0;
+		}
+		if (priorityCount != 0) {
+			std::lock_guard<std::mutex> lock(priorityQueueMutex_);
+			if (priorityQueue_.size() + priorityCount <= maxQueueSize_) {
+				LogRecordList normal;
+				while (LogPoolRecord* record = records.pop_front()) {
+					if ((record->level & ~structuredRecordFlag_) >= priorityLevel) {
+						priorityQueue_.push_back(record);
+					}
+					else {
+						normal.push_back(record);
+					}
+				}
+				records.swap(normal);
+				priorityEnqueued_ += priorityCount;
+				priorityPending_.store(true, std::memory_order_release);
+				priorityQueueCond_.notify_one();
+			}
+		}
+		if (records.empty()) {
+			return;
+		}
+		bool full;
+		{
+			std::lock_guard<std::mutex> lock(logQueueMutex_);
+			normalEnqueued_ += records.size();
+			logQueue_.append(records);
+			if (logQueue_.size() > queueHighWater_) {
+				queueHighWater_ = logQueue_.size();
+			}
+			full = logQueue_.size() >= maxQueueSize_;
+		}
+		// 释放队列锁后再等待，写日志线程才能取走记录
+		if (full) {
+			uint64_t waitStart = LogHistogram::now();
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));// 等待日志打印，防止累积
+			backpressureHistogram_.record(LogHistogram::now() - waitStart);
+		}
+		return;
+	}
 
-std::string Logger::getCurrentTime() const {
-	auto now = std::chrono::system_clock::now();
-	auto now_ms = std::chrono::time_point_cast<std::chrono::milliseconds>(now);
-	auto duration = now_ms.time_since_epoch();
-	auto seconds = std::chrono::duration_cast<std::chrono::seconds>(duration);
-	auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(duration) - std::chrono::duration_cast<std::chrono::seconds>(duration);
+	static thread_local std::string joined;
+	if (ringClient_.load(std::memory_order_relaxed) || sharded_.load(std::memory_order_relaxed)) {
+		// 客户端和分片模式逐条提交，各自的锁只在单条写入内持有
+		while (LogPoolRecord* record = records.pop_front()) {
+			record->copyMessage(joined);
+			size_t contextLen = std::min(static_cast<size_t>(record->contextLength), joined.size());
+			submit(tick, static_cast<LogLevel>(record->level & ~structuredRecordFlag_), joined.data(), contextLen,
+				joined.data() + contextLen, joined.size() - contextLen, (record->level & structuredRecordFlag_) != 0);
+			pool.release(record);
+		}
+		return;
+	}
 
-	std::time_t currentTime = std::chrono::system_clock::to_time_t(now);
-	std::stringstream ss;
-	std::tm time;
-	localtime_s(&time, &currentTime);
-	ss << std::put_time(&time, "%Y-%m-%d %H:%M:%S");
-	ss << '.' << std::setw(3) << std::setfill('0') << milliseconds.count();
-	return ss.str();
+	// 同步模式：一次加锁写入整批，最后只写入内核一次
+	uint64_t syncTarget = 0;
+	std::vector<EchoLine> echo;
+	{
+		std::lock_guard<std::mutex> lock(logMutex_);
+		bool flush = false;
+		while (LogPoolRecord* record = records.pop_front()) {
+			LogLevel level = static_cast<LogLevel>(record->level & ~structuredRecordFlag_);
+			Durability durability = static_cast<Durability>(durability_[static_cast<int>(level)].load(std::memory_order_relaxed));
+			const char* data = record->payload;
+			size_t len = record->length;
+			if (record->spill != nullptr) {
+				record->copyMessage(joined);
+				data = joined.data();
+				len = joined.size();
+			}
+			// 线程上下文前缀与消息分开传入，结构化记录的编码从消息处开始
+			size_t contextLen = std::min(static_cast<size_t>(record->contextLength), len);
+			syncTarget = std::max(syncTarget, writeLocked(tick, level, durability, data, contextLen, data + contextLen,
+				len - contextLen, (record->level & structuredRecordFlag_) != 0));
+			flush = flush || durability != Durability::NONE;
+			pool.release(record);
+		}
+		if (flush) {
+			flushLocked();
+		}
+		if (!echoPending_.empty()) {
+			echo.swap(echoPending_);
+		}
+	}
+	echoLines(echo);
+	if (syncTarget != 0) {
+		syncTo(syncTarget);
+	}
+}
+
+uint64_t Logger::appendTime(std::string& out, uint64_t nanos, TimeCache& cache) {
+	// 秒级部分每秒只格式化一次
+	int64_t second = static_cast<int64_t>(nanos / 1000000000ull);
+	if (second != cache.second) {
+		std::time_t currentTime = static_cast<std::time_t>(second);
+		std::tm time;
+		localtime_s(&time, &currentTime);
+		strftime(cache.text, sizeof(cache.text), "%Y-%m-%d %H:%M:%S", &time);
+		cache.wallSecond = logWallSeconds(time.tm_year + 1900, time.tm_mon + 1, time.tm_mday, time.tm_hour, time.tm_min, time.tm_sec);
+		cache.second = second;
+	}
+	out.append(cache.text);
+
+	uint64_t fraction = nanos % 1000000000ull;
+	TimePrecision precision = timePrecision_.load(std::memory_order_relaxed);
+	int width = 3;
+	uint64_t unit = 1000000;// 输出精度对应的纳秒数
+	if (precision == TimePrecision::NANOSECOND) {
+		width = 9;
+		unit = 1;
+	}
+	else if (precision == TimePrecision::MICROSECOND) {
+		width = 6;
+		unit = 1000;
+	}
+	fraction /= unit;
+	// 返回值截断到输出精度，与文本中的时间相同，索引可直接与解析出的时间比较
+	uint64_t wallNanos = static_cast<uint64_t>(cache.wallSecond) * 1000000000ull + fraction * unit;
+	char digits[10];
+	digits[0] = '.';
+	for (int i = width; i > 0; --i) {
+		digits[i] = static_cast<char>('0' + fraction % 10);
+		fraction /= 10;
+	}
+	out.append(digits, width + 1);
+	return wallNanos;
+}
+
+uint64_t Logger::formatRecord(uint64_t tick, LogLevel level, const char* context, size_t contextLen,
+	const char* message, size_t len, std::string& out, bool structured) {
+	return formatLine(clock_.toNanos(tick), timeCache_, level, context, contextLen, message, len, structured, out);
+}
+
+uint64_t Logger::formatLine(uint64_t nanos, TimeCache& cache, LogLevel level, const char* context, size_t contextLen,
+	const char* message, size_t len, bool structured, std::string& out) {
+	out.clear();
+	bool sanitize = sanitize_.load(std::memory_order_relaxed);
+	if (layout_.load(std::memory_order_relaxed) == Layout::JSON_LINES) {
+		out.append("{\"time\":\"", 9);
+		uint64_t wallNanos = appendTime(out, nanos, cache);
+		out.append("\",\"level\":\"", 11);
+		out.append(logLevelToString(level));
+		out.append("\",", 2);
+		// 上下文前缀去掉末尾空格后作为一个字符串
+		while (contextLen > 0 && context[contextLen - 1] == ' ') {
+			--contextLen;
+		}
+		if (contextLen > 0) {
+			out.append("\"context\":\"", 11);
+			LogSanitize::appendJson(out, context, contextLen, sanitize);
+			out.append("\",", 2);
+		}
+		if (structured) {
+			LogFieldCodec::renderJson(out, message, len, sanitize);
+		}
+		else {
+			out.append("\"msg\":\"", 7);
+			LogSanitize::appendJson(out, message, len, sanitize);
+			out.push_back('"');
+		}
+		out.push_back('}');
+		return wallNanos;
+	}
+	out.push_back('[');
+	uint64_t wallNanos = appendTime(out, nanos, cache);
+	out.push_back(' ');
+	out.append(logLevelToString(level));
+	out.append("] ", 2);
+	if (sanitize) {
+		LogSanitize::appendText(out, context, contextLen);
+	}
+	else {
+		out.append(context, contextLen);
+	}
+	if (structured) {
+		LogFieldCodec::renderText(out, message, len, sanitize);
+	}
+	else if (sanitize) {
+		LogSanitize::appendText(out, message, len);
+	}
+	else {
+		out.append(message, len);
+	}
+	return wallNanos;
+}
+
+void Logger::echoConsole(LogLevel level, const std::string& line) {
+	if (static_cast<int>(level) < consoleEchoLevel_.load(std::memory_order_relaxed)) {
+		return;
+	}
+	if (layout_.load(std::memory_order_relaxed) == Layout::JSON_LINES) {
+		console_.writeLine(line.data(), line.size());
+		return;
+	}
+	// 等级位于时间之后的第一个 ']' 之前
+	size_t levelEnd = line.find(']');
+	size_t levelLen = strlen(logLevelToString(level));
+	console_.writeLine(line.data(), line.size(), static_cast<int>(level),
+		levelEnd != std::string::npos && levelEnd >= levelLen ? levelEnd - levelLen : 0, levelEnd != std::string::npos ? levelEnd : 0);
+}
+
+void Logger::echoLines(std::vector<EchoLine>& lines) {
+	for (size_t i = 0; i < lines.size(); ++i) {
+		echoConsole(lines[i].level, lines[i].line);
+	}
+	lines.clear();
 }
 
 std::string Logger::getCurrentDateHour() const {
@@ -99,32 +1485,215 @@ std::string Logger::getCurrentDateHour() const {
 	return ss.str();
 }
 
-std::string Logger::getLogFileName() const {
+std::string Logger::getLogFilePrefix() const {
 	std::stringstream fileName;
-	fileName << folderName_ << "/" << getCurrentDateHour() << "_" << currentFileIndex_ << ".log";
+	fileName << folderName_ << "/" << currentDateHour_ << "_" << currentFileIndex_;
 	return fileName.str();
 }
 
-void Logger::writeToFile(const std::string& message) {
+std::string Logger::getLogFileName() const {
+	return getLogFilePrefix() + ".log";
+}
+
+void Logger::openLogFile() {
+	std::string prefix = getLogFilePrefix();
+	if (!logFile_.open(prefix + ".log")) {
+		return;
+	}
+	// 续写已有文件时以实际长度为准，保证索引偏移准确
+	fileSize_ = static_cast<size_t>(logFile_.size());
+
+	if (indexBytes_ != 0 || indexNanos_ != 0) {
+		indexFile_.open(prefix + ".idx", std::ios::out | std::ios::app | std::ios::binary);
+		indexFile_.seekp(0, std::ios::end);
+		if (indexFile_.is_open() && indexFile_.tellp() <= 0) {
+			indexFile_.write(logIndexMagic, sizeof(logIndexMagic));
+		}
+		indexNext_ = true;
+	}
+}
+
+void Logger::closeLogFile() {
+	// 不在写锁内落盘：保留描述符副本，由下一次落盘（SYNC 等级、flush 或检测线程）在锁外一并落盘
+	if (logFile_.is_open()) {
+		logFile_.flush();
+		ClosedFile closed;
+		closed.fd = logFile_.duplicateHandle();
+		closed.drop = logFile_.cacheMode() != LogCacheMode::NORMAL;
+		if (closed.fd >= 0) {
+			closedFiles_.push_back(closed);
+		}
+	}
+	logFile_.close();
+	indexFile_.close();
+	closeTraceFile();
+	fileSize_ = 0;
+}
+
+void Logger::writeIndexEntry(uint64_t wallNanos) {
+	LogIndexEntry entry;
+	entry.wallNanos = wallNanos;
+	entry.offset = fileSize_;
+	indexFile_.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+	indexFile_.flush();
+	lastIndexOffset_ = fileSize_;
+	lastIndexNanos_ = wallNanos;
+	indexNext_ = false;
+}
+
+void Logger::setIndexInterval(size_t bytes, uint64_t millis) {
 	std::lock_guard<std::mutex> lock(logMutex_);
+	indexBytes_ = bytes;
+	indexNanos_ = millis * 1000000;
+}
+
+void Logger::setConsoleAsync(bool enable, LogConsoleOverflow overflow, size_t bufferBytes) {
+	if (enable) {
+		console_.start(overflow, bufferBytes);
+		consoleAsync_ = true;
+	}
+	else {
+		consoleAsync_ = false;
+		console_.stop();
+	}
+}
+
+void Logger::setConsoleEcho(bool enable, LogLevel level, bool color) {
+	console_.setColor(color);
+	consoleEchoLevel_ = enable ? static_cast<int>(level) : static_cast<int>(LogLevel::LOG_ERROR) + 1;
+}
+
+uint64_t Logger::writeToFile(uint64_t tick, LogLevel level, const char* context, size_t contextLen, const char* message, size_t len,
+	bool structured) {
+	Durability durability = static_cast<Durability>(durability_[static_cast<int>(level)].load(std::memory_order_relaxed));
+	uint64_t syncTarget;
+	std::vector<EchoLine> echo;
+	{
+		std::lock_guard<std::mutex> lock(logMutex_);
+		syncTarget = writeLocked(tick, level, durability, context, contextLen, message, len, structured);
+		// 同步模式逐条写入内核；异步模式由写日志线程每批写入一次
+		if (!async_ && durability != Durability::NONE) {
+			flushLocked();
+		}
+		if (!echoPending_.empty()) {
+			echo.swap(echoPending_);
+		}
+	}
+	echoLines(echo);
+	return syncTarget;
+}
+
+uint64_t Logger::writeLocked(uint64_t tick, LogLevel level, Durability durability, const char* context, size_t contextLen,
+	const char* message, size_t len, bool structured) {
+	uint64_t wallNanos = formatRecord(tick, level, context, contextLen, message, len, lineBuffer_, structured);
+	// 控制台可能阻塞，这里只收集，由调用方释放 logMutex_ 后回显
+	if (static_cast<int>(level) >= consoleEchoLevel_.load(std::memory_order_relaxed)) {
+		EchoLine echo;
+		echo.level = level;
+		echo.line = lineBuffer_;
+		echoPending_.push_back(std::move(echo));
+	}
+	if (live_) {
+		live_->publish(static_cast<int>(level), lineBuffer_.data(), lineBuffer_.size());
+	}
+	// 开启网络输出时交给网络，缓冲区满时仍写入文件
+	if (netSink_.isOpen()) {
+		if (netSink_.append(lineBuffer_.data(), lineBuffer_.size(), lineEnd_)) {
+			netRecords_.fetch_add(1, std::memory_order_relaxed);
+			return 0;
+		}
+		netSpilled_.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	if (!logFile_.is_open()) {
+		openLogFile();
+	}
 	if (!logFile_.is_open()) {
-		logFile_.open(getLogFileName(), std::ios::out | std::ios::app);
+		return 0;
+	}
+	if (indexFile_.is_open() && (indexNext_ || (indexBytes_ != 0 && fileSize_ - lastIndexOffset_ >= indexBytes_)
+		|| (indexNanos_ != 0 && wallNanos >= lastIndexNanos_ + indexNanos_))) {
+		writeIndexEntry(wallNanos);
 	}
+	lineBuffer_ += lineEnd_;
+	logFile_.write(lineBuffer_.data(), lineBuffer_.size());
+	fileSize_ += lineBuffer_.size();
+	writeSeq_ += lineBuffer_.size();
+	recordsWritten_.fetch_add(1, std::memory_order_relaxed);
+	bytesWritten_.fetch_add(lineBuffer_.size(), std::memory_order_relaxed);
+	uint64_t syncTarget = durability == Durability::SYNC ? writeSeq_ : 0;
 
-	if (logFile_.is_open()) {
-		logFile_ << message << std::endl;
-		fileSize_ += message.size() + 2;
+	if (fileSize_ >= maxSize_) {
+		uint64_t rotateStart = LogHistogram::now();
+		closeLogFile();
+		currentFileIndex_++;
+		openLogFile();
+		rotations_.fetch_add(1, std::memory_order_relaxed);
+		rotationHistogram_.record(LogHistogram::now() - rotateStart);
+	}
+	return syncTarget;
+}
+
+void Logger::flushLocked() {
+	logFile_.flush();
+	netSink_.flush();
+}
+
+void Logger::spillNetLocked() {
+	if (netSink_.pendingRecords() == 0) {
+		return;
+	}
+	if (!logFile_.is_open()) {
+		openLogFile();
+	}
+	if (!logFile_.is_open()) {
+		return;
+	}
+	netSpilled_.fetch_add(netSink_.pendingRecords(), std::memory_order_relaxed);
+	recordsWritten_.fetch_add(netSink_.pendingRecords(), std::memory_order_relaxed);
+	netSink_.drain(lineEnd_, [this](const char* data, size_t len) {
+		logFile_.write(data, len);
+		fileSize_ += len;
+		writeSeq_ += len;
+		bytesWritten_.fetch_add(len, std::memory_order_relaxed);
+	});
+}
 
-		if (fileSize_ >= maxSize_) {
-			logFile_.close();
-			currentFileIndex_++;
-			fileSize_ = 0;
-			logFile_.open(getLogFileName(), std::ios::out | std::ios::app);
+uint64_t Logger::writeToFile(const LogPoolRecord& record) {
+	const char* data = record.payload;
+	size_t len = record.length;
+	if (record.spill != nullptr) {
+		record.copyMessage(spillBuffer_);
+		data = spillBuffer_.data();
+		len = spillBuffer_.size();
+	}
+	if (record.level == spanRecordLevel_) {
+		uint64_t header[2];
+		if (len < sizeof(header)) {
+			return 0;
 		}
+		memcpy(header, data, sizeof(header));
+		std::lock_guard<std::mutex> lock(logMutex_);
+		writeSpan(header[0], record.tick, header[1], data + sizeof(header), len - sizeof(header));
+		return 0;
 	}
+	// 线程上下文前缀与消息分开传入，结构化记录的编码从消息处开始
+	size_t contextLen = std::min(static_cast<size_t>(record.contextLength), len);
+	return writeToFile(record.tick, static_cast<LogLevel>(record.level & ~structuredRecordFlag_), data, contextLen,
+		data + contextLen, len - contextLen, (record.level & structuredRecordFlag_) != 0);
+}
+
+bool Logger::isLogFile(const std::string& fileName) {
+	// 包含 "_" 且为 ".log" 日志、".idx" 索引或 ".trace.json" 追踪文件
+	return fileName.find("_") != std::string::npos
+		&& (fileName.find(".log") != std::string::npos || fileName.find(".idx") != std::string::npos
+		|| fileName.find(".trace.json") != std::string::npos);
 }
 
-void Logger::cleanOldLogs() const {
+int Logger::cleanOldLogs() const {
+	// 先收集日志相关文件及修改时间；同一文件名主干（YYYYMMDDHH_N）的文件作为一组，
+	// 如分片模式下各线程的文件及其索引，按组内最新的修改时间整体保留或删除
+	std::vector<std::pair<std::string, std::time_t> > files;
 #ifdef _MSC_VER
 	// 添加通配符以匹配所有文件
 	std::string searchPath = folderName_ + "\\*";
@@ -134,65 +1703,82 @@ void Logger::cleanOldLogs() const {
 
 	if (handle == -1) {
 		std::cerr << "Unable to open directory: " << folderName_ << std::endl;
-		return;
+		return 0;
 	}
 
 	do {
 		std::string fileName = fileInfo.name;
 
-		// 过滤文件名，检查是否符合条件：包含 "_" 且以 ".log" 结尾
-		if (fileName.find("_") != std::string::npos && fileName.find(".log") != std::string::npos) {
+		// 过滤文件名，只处理日志和索引文件
+		if (isLogFile(fileName)) {
 			std::string fullPath = folderName_ + "\\" + fileName;
 
 			struct _stat fileStat;
 			if (_stat(fullPath.c_str(), &fileStat) == 0) {
 				// 获取文件最后修改时间
-				std::time_t lastModifiedTime = fileStat.st_mtime;
-				std::chrono::system_clock::time_point fileTimePoint = std::chrono::system_clock::from_time_t(lastModifiedTime);
-				auto duration = std::chrono::system_clock::now() - fileTimePoint;
-				int daysOld = std::chrono::duration_cast<std::chrono::hours>(duration).count() / 24;
-
-				// 如果文件超出保留天数，删除文件
-				if (daysOld > retentionDays_) {
-					std::cout << "Deleting old log file: " << fullPath << std::endl;
-					if (remove(fullPath.c_str()) != 0) {
-						std::cerr << "Failed to delete file: " << fullPath << std::endl;
-					}
-				}
+				files.push_back(std::make_pair(fullPath, static_cast<std::time_t>(fileStat.st_mtime)));
 			}
 		}
 	} while (_findnext(handle, &fileInfo) == 0);  // 查找下一个文件
 
 	// 关闭句柄
 	_findclose(handle);
+	const size_t nameOffset = folderName_.size() + 1;
 #else
 	DIR* dir = opendir(folderName_.c_str());
 	if (dir == nullptr) {
 		std::cerr << "Unable to open directory: " << folderName_ << std::endl;
-		return;
+		return 0;
 	}
 	struct dirent* entry;
 	while ((entry = readdir(dir)) != nullptr) {
 		std::string fileName = entry->d_name;
-		if (fileName.find("_") != std::string::npos && fileName.find(".log") != std::string::npos) {
+		if (isLogFile(fileName)) {
 			std::string fullPath = folderName_ + "/" + fileName;
 
 			struct stat fileStat;
 			if (stat(fullPath.c_str(), &fileStat) == 0) {
-				std::time_t lastModifiedTime = fileStat.st_mtime;
-				std::chrono::system_clock::time_point fileTimePoint = std::chrono::system_clock::from_time_t(lastModifiedTime);
-				auto duration = std::chrono::system_clock::now() - fileTimePoint;
-				int daysOld = std::chrono::duration_cast<std::chrono::hours>(duration).count() / 24;
-
-				if (daysOld > retentionDays_) {
-					std::cout << "Deleting old log file: " << fullPath << std::endl;
-					remove(fullPath.c_str());
-				}
+				files.push_back(std::make_pair(fullPath, fileStat.st_mtime));
 			}
 		}
 	}
 	closedir(dir);
+	const size_t nameOffset = folderName_.size() + 1;
 #endif
+
+	// 每组最新的修改时间
+	std::map<std::string, std::time_t> newest;
+	for (size_t i = 0; i < files.size(); ++i) {
+		std::string stem = files[i].first.substr(nameOffset);
+		stem = stem.substr(0, stem.find('.'));
+		std::map<std::string, std::time_t>::iterator it = newest.find(stem);
+		if (it == newest.end() || it->second < files[i].second) {
+			newest[stem] = files[i].second;
+		}
+	}
+
+	int deleted = 0;
+	for (size_t i = 0; i < files.size(); ++i) {
+		const std::string& fullPath = files[i].first;
+		std::string stem = fullPath.substr(nameOffset);
+		stem = stem.substr(0, stem.find('.'));
+		std::chrono::system_clock::time_point fileTimePoint = std::chrono::system_clock::from_time_t(newest[stem]);
+		auto duration = std::chrono::system_clock::now() - fileTimePoint;
+		int daysOld = std::chrono::duration_cast<std::chrono::hours>(duration).count() / 24;
+
+		// 如果文件超出保留天数，删除文件
+		if (daysOld > retentionDays_) {
+			std::cout << "Deleting old log file: " << fullPath << std::endl;
+			if (remove(fullPath.c_str()) != 0) {
+				std::cerr << "Failed to delete file: " << fullPath << std::endl;
+				cleanFailures_.fetch_add(1, std::memory_order_relaxed);
+			}
+			else {
+				deleted++;
+			}
+		}
+	}
+	return deleted;
 }
 
 int Logger::getMaxLogSequence() {
@@ -211,7 +1797,7 @@ int Logger::getMaxLogSequence() {
 	}
 
 	// 使用正则表达式匹配文件名
-	std::regex pattern(currentDateHour + R"(_(\d+)\.log)"); // 日期+_+序号.log
+	std::regex pattern(currentDateHour + R"(_(\d+)(\.\d+)?\.log)"); // 日期+_+序号[.线程ID].log
 	std::smatch match;
 
 	do {
@@ -236,7 +1822,7 @@ int Logger::getMaxLogSequence() {
 	}
 	struct dirent* entry;
 
-	std::regex pattern(currentDateHour + R"(_(\d+)\.log)");  // 正则表达式：日期+_+序号.log
+	std::regex pattern(currentDateHour + R"(_(\d+)(\.\d+)?\.log)");  // 正则表达式：日期+_+序号[.线程ID].log
 
 	// 遍历目录中的所有文件
 	while ((entry = readdir(dir)) != nullptr) {
@@ -257,72 +1843,224 @@ int Logger::getMaxLogSequence() {
 }
 
 void Logger::resetFileIndex() {
-	static std::string lastDateHour = getCurrentDateHour();
-	if (lastDateHour != getCurrentDateHour()) {
-		std::lock_guard<std::mutex> lock(logMutex_);
+	std::string dateHour = getCurrentDateHour();
+	std::lock_guard<std::mutex> lock(logMutex_);
+	if (currentDateHour_ != dateHour) {
+		currentDateHour_ = dateHour;
 		currentFileIndex_ = 0;
-		if (!logFile_.is_open()) {
-			logFile_.open(getLogFileName(), std::ios::out | std::ios::app);
+		if (logFile_.is_open()) {
+			closeLogFile();
 		}
-		else {
-			logFile_.close();
-			fileSize_ = 0;
-			logFile_.open(getLogFileName(), std::ios::out | std::ios::app);
+		// 客户端模式下由写日志进程写文件，分片模式下各线程随分片组切换，都不创建共用的日志文件
+		if (!ringClient_.load(std::memory_order_relaxed) && !sharded_.load(std::memory_order_relaxed)) {
+			openLogFile();
 		}
-		lastDateHour = getCurrentDateHour();
 	}
 }
 
 void Logger::logThreadFunction() {
-	static auto lastWriteTime = std::chrono::system_clock::now();
+	auto lastWriteTime = std::chrono::system_clock::now();
 	while (!exit_) {
-		std::this_thread::sleep_for(std::chrono::milliseconds(1));
-		std::deque<std::string> logsToWrite;
+		{
+			std::unique_lock<std::mutex> lock(priorityQueueMutex_);
+			priorityQueueCond_.wait_for(lock, std::chrono::milliseconds(1), [this]() {
+				return !priorityQueue_.empty() || flushPending_.load(std::memory_order_relaxed);
+			});
+		}
+		writePriorityLogs();
+
+		// 有等待中的 flush 请求时不等待 logCycle_
+		bool flushPending = flushPending_.load(std::memory_order_acquire);
+		LogRecordList logsToWrite;
+		std::vector<std::function<void()> > waiters;
 		{
 			auto currentTime = std::chrono::system_clock::now();
 			std::lock_guard<std::mutex> lock(logQueueMutex_);
-            if(logQueue_.empty()){
-                continue;
-            }
-			if (logQueue_.size() >= maxQueueSize_ || currentTime > lastWriteTime + logCycle_) {
+			if (!logQueue_.empty() && (logQueue_.size() >= maxQueueSize_ || currentTime > lastWriteTime + logCycle_ || flushPending)) {
 				logQueue_.swap(logsToWrite);
+				spaceWaiters_.swap(waiters);
 				lastWriteTime = currentTime;
 			}
 		}
+		// 队列已取空，在锁外通知等待空位的生产者
+		for (size_t i = 0; i < waiters.size(); ++i) {
+			waiters[i]();
+		}
 
-		while (!logsToWrite.empty()) {
-			writeToFile(logsToWrite.front());
-			logsToWrite.pop_front();
+		if (logsToWrite.empty()) {
+			if (flushPending) {
+				completeBatch(0);
+			}
+			continue;
+		}
+		uint64_t batchStart = LogHistogram::now();
+		writeBatchSizeHistogram_.record(logsToWrite.size());
+		uint64_t syncTarget = 0;
+		LogRecordPool& pool = LogRecordPool::instance();
+		while (LogPoolRecord* record = logsToWrite.pop_front()) {
+			syncTarget = std::max(syncTarget, writeToFile(*record));
+			pool.release(record);
+			++normalWritten_;
+			// 大批量写入期间插入高优先级日志
+			if (priorityPending_.load(std::memory_order_acquire)) {
+				writePriorityLogs();
+			}
 		}
+		completeBatch(syncTarget);
+		writeBatchHistogram_.record(LogHistogram::now() - batchStart);
 	}
 
 	flushRemainingLogs();
 }
 
+void Logger::writePriorityLogs() {
+	LogRecordList logsToWrite;
+	{
+		std::lock_guard<std::mutex> lock(priorityQueueMutex_);
+		if (priorityQueue_.empty()) {
+			return;
+		}
+		priorityQueue_.swap(logsToWrite);
+		priorityPending_.store(false, std::memory_order_relaxed);
+	}
+
+	uint64_t syncTarget = 0;
+	for (LogPoolRecord* record = logsToWrite.front(); record != nullptr; record = record->next) {
+		syncTarget = std::max(syncTarget, writeToFile(*record));
+		++priorityWritten_;
+	}
+	// 立即写入内核，不等待普通批次
+	completeBatch(syncTarget);
+
+	uint64_t nowNanos = LogClock::systemNanos();
+	LogRecordPool& pool = LogRecordPool::instance();
+	std::lock_guard<std::mutex> lock(logMutex_);
+	while (LogPoolRecord* record = logsToWrite.pop_front()) {
+		uint64_t createdNanos = clock_.toNanos(record->tick);
+		priorityLatencyHistogram_.record(nowNanos > createdNanos ? nowNanos - createdNanos : 0);
+		pool.release(record);
+	}
+}
+
 void Logger::flushRemainingLogs() {
-	std::deque<std::string> logsToWrite;
+	writePriorityLogs();
+
+	LogRecordList logsToWrite;
+	std::vector<std::function<void()> > waiters;
 	{
-		std::lock_guard<std::mutex> lock(logMutex_);
+		std::lock_guard<std::mutex> lock(logQueueMutex_);
 		logQueue_.swap(logsToWrite);
+		spaceWaiters_.swap(waiters);
 	}
+	for (size_t i = 0; i < waiters.size(); ++i) {
+		waiters[i]();
+	}
+
+	uint64_t syncTarget = 0;
+	LogRecordPool& pool = LogRecordPool::instance();
+	while (LogPoolRecord* record = logsToWrite.pop_front()) {
+		syncTarget = std::max(syncTarget, writeToFile(*record));
+		pool.release(record);
+		++normalWritten_;
+	}
+	completeBatch(syncTarget);
 
-	while (!logsToWrite.empty()) {
-		writeToFile(logsToWrite.front());
-		logsToWrite.pop_front();
+	// 退出时仍未满足的请求（之后入队的日志不再写入）直接完成
+	std::lock_guard<std::mutex> lock(flushMutex_);
+	for (size_t i = 0; i < flushRequests_.size(); ++i) {
+		flushRequests_[i].promise.set_value();
+		if (flushRequests_[i].callback) {
+			flushRequests_[i].callback();
+		}
 	}
+	flushRequests_.clear();
+	flushPending_ = false;
 }
 
 void Logger::checkThreadFunction() {
-	cleanOldLogs();
+	auto clean = [this]() {
+		uint64_t cleanStart = LogHistogram::now();
+		filesDeleted_.fetch_add(cleanOldLogs(), std::memory_order_relaxed);
+		cleanRuns_.fetch_add(1, std::memory_order_relaxed);
+		cleanHistogram_.record(LogHistogram::now() - cleanStart);
+	};
+	clean();
 	auto lastCleanTime = getCurrentTimeMillis();
+	uint64_t lastStatsTime = 0;
+	uint64_t lastLatencyTime = 0;
+	Stats lastStats;
+	LevelConfigWatcher configWatcher;
+	std::string configPath;
 	while (!exit_) {
-		std::this_thread::sleep_for(std::chrono::milliseconds(500));
+		// 等待期间监视等级配置文件，变化后立即重新读取
+		if (levelConfigChanged_.exchange(false)) {
+			std::lock_guard<std::mutex> lock(categoryMutex_);
+			configPath = levelConfigPath_;
+			configWatcher.watch(configPath);
+		}
+		if (configWatcher.wait(500) && !configPath.empty()) {
+			loadLevelConfig(configPath);
+		}
 		resetFileIndex();
-		ExecuteTaskPeriodically(lastCleanTime, 24 * 60 * 60 * 1000, std::bind(&Logger::cleanOldLogs, this));
+		// 同步模式下 NONE 等级的日志留在缓冲区，定期写入内核；网络输出同时重试连接
+		uint64_t closedTarget = 0;
+		{
+			std::lock_guard<std::mutex> lock(logMutex_);
+			flushLocked();
+			traceFile_.flush();
+			closedTarget = closedFiles_.empty() ? 0 : writeSeq_;
+		}
+		// 切换后关闭的旧文件在这里落盘并释放描述符，不占用生产者
+		if (closedTarget != 0) {
+			syncTo(closedTarget);
+		}
+		if (sharded_) {
+			// 跨小时时整组切换到新的文件名
+			uint64_t epoch = shardEpoch_.load(std::memory_order_acquire);
+			bool hourChanged;
+			{
+				std::lock_guard<std::mutex> lock(shardMutex_);
+				hourChanged = getCurrentDateHour() != shardDateHour_;
+			}
+			if (hourChanged) {
+				rotateShards(epoch);
+			}
+		}
+		flushShards(false);
+		ExecuteTaskPeriodically(lastCleanTime, 24 * 60 * 60 * 1000, clean);
+
+		// 周期输出延迟汇总
+		uint64_t latencyInterval = latencyInterval_.load(std::memory_order_relaxed);
+		if (latencyInterval != 0) {
+			uint64_t nowTime = getCurrentTimeMillis();
+			if (lastLatencyTime == 0) {
+				lastLatencyTime = nowTime;
+			}
+			else if (nowTime >= lastLatencyTime + latencyInterval * 1000) {
+				writeLatencies();
+				lastLatencyTime = nowTime;
+			}
+		}
+
+		// 周期输出运行指标
+		uint64_t statsInterval = statsInterval_.load(std::memory_order_relaxed);
+		if (statsInterval == 0) {
+			lastStatsTime = 0;
+			continue;
+		}
+		uint64_t nowTime = getCurrentTimeMillis();
+		if (lastStatsTime == 0) {
+			lastStats = getStats();
+			lastStatsTime = nowTime;
+		}
+		else if (nowTime >= lastStatsTime + statsInterval * 1000) {
+			writeStats(lastStats, nowTime - lastStatsTime);
+			lastStatsTime = nowTime;
+		}
 	}
 }
 
-std::string Logger::logLevelToString(LogLevel level) const {
+const char* Logger::logLevelToString(LogLevel level) {
 	switch (level) {
 	case LogLevel::LOG_DEBUG:
 		return "DEBUG";
@@ -27,6 +27,8 @@
 #define LOGGER_H
 
 #include <string>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -34,9 +36,28 @@
 #include <ctime>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <vector>
-#include <deque>
+#include <map>
+#include <memory>
 #include <atomic>
+#include <functional>
+#include <future>
+#include "LogClock.h"
+#include "LogStats.h"
+#include "LogIndex.h"
+#include "LogFile.h"
+#include "LogRecordPool.h"
+#include "LogConsole.h"
+#include "LogNetSink.h"
+#include "LogBroadcast.h"
+#include "LogRing.h"
+#include "LogFields.h"
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <string_view>
+#define LOGGER_HAS_STRING_VIEW 1
+#endif
 
 class Logger {
 public:
@@ -47,49 +68,557 @@ public:
 		LOG_ERROR
 	};
 
+	enum class TimePrecision {// 日志时间精度
+		MILLISECOND,
+		MICROSECOND,
+		NANOSECOND
+	};
+
+	enum class Layout {// 日志行格式
+		TEXT,       // "[时间 等级] 上下文 消息 key=value"
+		JSON_LINES  // 每行一个 JSON 对象：{"time":...,"level":...,"context":...,"msg":...,"key":value}
+	};
+
+	enum class Durability {// 日志写入后的持久化程度
+		NONE,       // 留在用户态缓冲区，缓冲区满、批量写完或检测线程定期写入内核
+		PAGE_CACHE, // 写入内核页缓存，进程崩溃不丢失
+		SYNC        // 等待落盘（fdatasync），多条日志合并为一次落盘
+	};
+
+	// 日志器自身运行指标快照
+	struct Stats {
+		uint64_t records[4];                    // 各等级进入日志路径的条数，按 LogLevel 索引
+		uint64_t recordsWritten;                // 已写入文件的条数
+		uint64_t bytesWritten;                  // 已写入文件的字节数
+		uint64_t queueDepth;                    // 当前异步队列长度
+		uint64_t queueHighWater;                // 异步队列长度峰值
+		uint64_t rotations;                     // 文件切换次数
+		uint64_t cleanRuns;                     // 清理旧日志次数
+		uint64_t filesDeleted;                  // 已删除的旧日志数
+		uint64_t cleanFailures;                 // 删除失败的旧日志数
+		LogHistogramSnapshot backpressureWait;  // 异步队列满时生产者等待耗时，单位ns
+		LogHistogramSnapshot writeBatch;        // 异步线程每批写入耗时，单位ns
+		LogHistogramSnapshot writeBatchSize;    // 异步线程每批写入条数
+		LogHistogramSnapshot rotation;          // 文件切换耗时，单位ns
+		LogHistogramSnapshot clean;             // 清理旧日志耗时，单位ns
+		uint64_t priorityQueueDepth;            // 当前高优先级队列长度
+		LogHistogramSnapshot priorityLatency;   // 高优先级日志从产生到写入文件的耗时，单位ns
+		LogHistogramSnapshot sync;              // 每次落盘耗时，单位ns，count 为落盘次数
+		uint64_t poolBytes;                     // 异步记录池已分配的内存（进程内所有日志器共享）
+		uint64_t consoleDropped;                // 异步控制台缓冲区满时丢弃的行数
+		uint64_t ringDropped;                   // 共享内存环满时丢弃的记录数（客户端模式）
+		uint64_t netRecords;                    // 交给网络输出的条数
+		uint64_t netSpilled;                    // 网络输出缓冲区满时改写入文件的条数
+		uint64_t netReconnects;                 // 网络输出断开后重新连接的次数
+		uint64_t netPending;                    // 网络输出缓冲区中尚未发出的条数
+	};
+
+	// 命名分类，名称按 '.' 分级（如 "net.http"），未单独设置等级时继承最近的上级，顶层继承日志器等级。
+	// 有效等级缓存在原子变量中，判断是否输出只需一次 relaxed 读取；由 Logger::category() 创建，生命周期与日志器相同
+	class Category {
+	public:
+		const std::string& name() const {
+			return name_;
+		}
+
+		// 该等级是否输出
+		bool enabled(LogLevel level) const {
+			return static_cast<int>(level) >= level_.load(std::memory_order_relaxed);
+		}
+
+		template <typename... Args>
+		void debug(const std::string& format, Args... args) {
+			if (enabled(LogLevel::LOG_DEBUG)) {
+				log(formatString(format, args...), LogLevel::LOG_DEBUG);
+			}
+		}
+
+		template <typename... Args>
+		void info(const std::string& format, Args... args) {
+			if (enabled(LogLevel::LOG_INFO)) {
+				log(formatString(format, args...), LogLevel::LOG_INFO);
+			}
+		}
+
+		template <typename... Args>
+		void warn(const std::string& format, Args... args) {
+			if (enabled(LogLevel::LOG_WARNING)) {
+				log(formatString(format, args...), LogLevel::LOG_WARNING);
+			}
+		}
+
+		template <typename... Args>
+		void error(const std::string& format, Args... args) {
+			if (enabled(LogLevel::LOG_ERROR)) {
+				log(formatString(format, args...), LogLevel::LOG_ERROR);
+			}
+		}
+
+		// 输出一条日志，内容前加 "[name] "
+		void log(const std::string& message, LogLevel level = LogLevel::LOG_INFO);
+
+	private:
+		friend class Logger;
+		Category(Logger& logger, const std::string& name, LogLevel level);
+		Category(const Category&);
+		Category& operator=(const Category&);
+
+		Logger& logger_;        // 所属日志器
+		std::string name_;      // 分类名称
+		std::atomic<int> level_;// 有效等级
+	};
+
+	// 命名延迟指标：样本记录到当前线程自己的直方图（无竞争），检测线程周期合并各线程的直方图，
+	// 每个周期每个指标输出一行汇总（见 setLatencyOutput）。由 Logger::latency() 创建，生命周期与日志器相同
+	class LatencyMetric {
+	public:
+		const std::string& name() const {
+			return name_;
+		}
+
+		// 记录一个样本，单位ns
+		void record(uint64_t nanos);
+
+		// 合并所有线程的直方图（累计值）
+		LogHistogramSnapshot snapshot();
+
+	private:
+		friend class Logger;
+		LatencyMetric(const std::string& name);
+		LatencyMetric(const LatencyMetric&);
+		LatencyMetric& operator=(const LatencyMetric&);
+
+		std::string name_;                                 // 指标名称
+		size_t id_;                                        // 进程内唯一编号，作为线程本地直方图数组的下标
+		std::mutex shardMutex_;                            // 保护 shards_
+		std::vector<std::shared_ptr<LogHistogram> > shards_;// 各线程的直方图，线程退出后保留
+		LogHistogramSnapshot last_;                        // 上次输出汇总时的累计值，仅检测线程使用
+	};
+
+	// 作用域计时：析构时把经过的时间（steady_clock）记录到指标
+	class ScopedTimer {
+	public:
+		explicit ScopedTimer(LatencyMetric& metric) : metric_(metric), start_(LogHistogram::now()) {}
+
+		~ScopedTimer() {
+			metric_.record(LogHistogram::now() - start_);
+		}
+
+	private:
+		ScopedTimer(const ScopedTimer&);
+		ScopedTimer& operator=(const ScopedTimer&);
+
+		LatencyMetric& metric_; // 记录到的指标
+		uint64_t start_;        // 开始时间，单位ns
+	};
+
+	// 追踪区间：构造时记录开始时间，析构时提交一条区间记录（开始、结束时间、线程 ID、名称），
+	// 与普通日志走同一队列，由写日志线程写入与当前日志文件同名的 .trace.json（Chrome trace-event 格式）。
+	// 未开启追踪（setTracing）时不读取时钟；const char* 名称不复制，须在区间结束前保持有效
+	class Span {
+	public:
+		Span(Logger& logger, const char* name)
+			: logger_(logger), name_(name), nameLen_(strlen(name)), begin_(logger.tracing() ? logger.clock_.now() : 0) {}
+
+		Span(Logger& logger, const std::string& name)
+			: logger_(logger), owned_(name), name_(owned_.c_str()), nameLen_(owned_.size()),
+			begin_(logger.tracing() ? logger.clock_.now() : 0) {}
+
+		~Span() {
+			if (begin_ != 0) {
+				logger_.submitSpan(begin_, logger_.clock_.now(), name_, nameLen_);
+			}
+		}
+
+	private:
+		Span(const Span&);
+		Span& operator=(const Span&);
+
+		Logger& logger_;     // 所属日志器
+		std::string owned_;  // 以 std::string 构造时的名称副本
+		const char* name_;   // 区间名称
+		size_t nameLen_;     // 名称长度
+		uint64_t begin_;     // 开始时的时钟值，0 表示不记录
+	};
+
+	// 线程上下文字段的作用域：构造时压入 key=value，析构时弹出，用法 Logger::ContextScope scope("request", id);
+	class ContextScope {
+	public:
+		ContextScope(const std::string& key, const std::string& value) {
+			pushContext(key, value);
+		}
+
+		~ContextScope() {
+			popContext();
+		}
+
+	private:
+		ContextScope(const ContextScope&);
+		ContextScope& operator=(const ContextScope&);
+	};
+
+	// 批量日志：在调用线程上收集记录（复制到池化记录，不加锁），commit() 或析构时整批提交。
+	// 批内记录共用第一条加入时读取的时钟值；异步时整批在一次加锁内接入队列，同步时一次加锁写入并只写入内核一次。
+	// 适合每个工作单元输出大量日志的场景，应按工作单元提交，不要跨越较长时间；只能在创建它的线程上使用
+	class LogBatch {
+	public:
+		explicit LogBatch(Logger& logger) : logger_(logger), tick_(0) {}
+
+		~LogBatch() {
+			commit();
+		}
+
+		// 加入一条日志，未启用的等级直接忽略；message 不需要以 '\0' 结尾
+		void add(LogLevel level, const char* message, size_t len);
+		void add(LogLevel level, const std::string& message) { add(level, message.data(), message.size()); }
+
+		// 加入一条结构化日志：batch.add(LogLevel::LOG_INFO, "row", kv("id", id))
+		template <typename... Fields>
+		void add(LogLevel level, const char* message, const LogField& field, const Fields&... fields) {
+			if (!logger_.enabled(level)) return;
+			const LogField list[] = { field, fields... };
+			addFields(level, message, strlen(message), list, 1 + sizeof...(fields));
+		}
+
+		void debug(const char* message) { add(LogLevel::LOG_DEBUG, message, strlen(message)); }
+		void debug(const std::string& message) { add(LogLevel::LOG_DEBUG, message); }
+		void info(const char* message) { add(LogLevel::LOG_INFO, message, strlen(message)); }
+		void info(const std::string& message) { add(LogLevel::LOG_INFO, message); }
+		void warn(const char* message) { add(LogLevel::LOG_WARNING, message, strlen(message)); }
+		void warn(const std::string& message) { add(LogLevel::LOG_WARNING, message); }
+		void error(const char* message) { add(LogLevel::LOG_ERROR, message, strlen(message)); }
+		void error(const std::string& message) { add(LogLevel::LOG_ERROR, message); }
+
+		// 尚未提交的条数
+		size_t size() const {
+			return records_.size();
+		}
+
+		// 提交已收集的记录，之后可继续加入（下一批重新读取时钟）
+		void commit();
+
+	private:
+		LogBatch(const LogBatch&);
+		LogBatch& operator=(const LogBatch&);
+
+		void addFields(LogLevel level, const char* message, size_t len, const LogField* fields, size_t count);
+
+		// 复制一条记录（含线程上下文前缀）到 records_
+		void append(LogLevel level, const char* message, size_t len, bool structured);
+
+		Logger& logger_;        // 所属日志器
+		LogRecordList records_; // 已收集的记录
+		uint64_t tick_;         // 本批的时钟值，0 表示尚未读取
+	};
+
+	// 实时订阅：读取日志器写入的日志行（与写入文件的是同一份格式化结果，不含换行符），供管理接口、健康检查等使用。
+	// 每条日志写入时发布到无锁广播环（LogBroadcast.h，首个订阅创建时分配），各订阅持有自己的游标，不拖慢写入；
+	// 读取过慢被覆盖的记录跳过并计入 lost()。next() 不阻塞；只能在一个线程上使用，生命周期不能超过日志器。
+	// 分片和客户端模式的日志不经过广播环
+	class Subscription {
+	public:
+		// 订阅不低于 level 的日志；fromOldest 为 true 时先读取环中仍保留的记录，否则只读取之后写入的
+		explicit Subscription(Logger& logger, LogLevel level = LogLevel::LOG_DEBUG, bool fromOldest = false);
+
+		// 取出下一条日志行，没有新日志时返回 false
+		bool next(std::string& line, LogLevel* level = nullptr);
+
+		// 因读取过慢而跳过的条数
+		uint64_t lost() const {
+			return reader_.lost();
+		}
+
+	private:
+		Subscription(const Subscription&);
+		Subscription& operator=(const Subscription&);
+
+		LogBroadcastReader reader_; // 广播环中的游标
+		int level_;                 // 最低等级
+	};
+
 	// 构造函数
 	Logger(const std::string& folderName, LogLevel level = LogLevel::LOG_INFO, bool daily = false,
-           bool async = false, uint64_t logCycle = 10, int retentionDays = 30, size_t maxSize = 50 * 1024 * 1024);
+           bool async = false, uint64_t logCycle = 10, int retentionDays = 30, size_t maxSize = 50 * 1024 * 1024,
+           LogClockType clockType = LogClockType::SYSTEM);
 
 	// 析构函数
 	~Logger();
 
-	// 设置日志级别
+	// 设置日志级别，未单独设置等级的分类随之变化
 	void setLogLevel(LogLevel level);
 
+	// 该等级是否输出
+	bool enabled(LogLevel level) const {
+		return level >= logLevel_.load(std::memory_order_relaxed);
+	}
+
+	// 获取命名分类，不存在时创建；返回的引用在日志器析构前一直有效
+	Category& category(const std::string& name);
+
+	// 设置分类等级，下级分类未单独设置时继承
+	void setCategoryLevel(const std::string& name, LogLevel level);
+
+	// 取消分类等级，改为继承上级
+	void clearCategoryLevel(const std::string& name);
+
+	// 从配置文件读取等级，每行 "名称 = 等级"，名称 root 表示日志器等级，# 开头为注释；
+	// 文件中未出现的分类恢复继承，未出现 root 时日志器等级不变。文件无法读取时返回 false
+	bool loadLevelConfig(const std::string& path);
+
+	// 读取配置文件并在文件变化后自动重新读取（Linux 使用 inotify，其他平台检查修改时间），空路径表示停止
+	void watchLevelConfig(const std::string& path);
+
+	// 获取命名延迟指标，不存在时创建；返回的引用在日志器析构前一直有效，热路径上应保存该引用
+	LatencyMetric& latency(const std::string& name);
+
+	// 记录一个延迟样本（ns）到命名指标；名称经线程本地缓存查找，比直接使用 latency() 的引用稍慢
+	void recordLatency(const std::string& name, uint64_t nanos);
+
+	// 周期输出延迟汇总，interval 单位s，0 表示关闭（默认）：每个周期内有样本的指标输出一行 INFO
+	// "latency name=... count=... p50_us=... p99_us=... max_us=..."，百分位数误差在 25% 以内
+	void setLatencyOutput(uint64_t interval);
+
+	// 分片模式：每个生产线程直接写自己的缓冲文件 YYYYMMDDHH_N.<线程ID>.log，不经过队列、写日志线程和共享锁，
+	// 写入吞吐随线程数增长。同一组分片（相同的 YYYYMMDDHH_N）作为整体切换和清理：任一分片超过 maxSize 或整点时整组切换。
+	// 持久性与同步模式相同（NONE 留在分片缓冲区，由检测线程约每 0.5s 写入内核）；
+	// 不生成索引。读取时用 listLogSources + LogMerger（或 logger_merge）按时间归并
+	void setSharded(bool enable);
+
+	// 客户端模式：日志写入本进程的共享内存环（LogRing.h），由写日志进程 logger_ringd 统一写入文件夹，
+	// 本进程不再打开日志文件。多个进程使用同一文件夹时不会争用文件名；进程崩溃时已写入环的记录仍会被写出。
+	// 环满时按 overflow 处理，默认丢弃并计数（Stats::ringDropped）。创建环失败时返回 false，仍写本地文件
+	bool setSharedRing(bool enable, LogRingOverflow overflow = LogRingOverflow::DROP, size_t ringBytes = 4 * 1024 * 1024);
+
+	// 网络输出：日志行按批以非阻塞方式发往本机收集器，不再写入日志文件。endpoint 为 "unix:/path"、"tcp:host:port"
+	// 或 "udp:host:port"，为空时关闭。framing 为 LENGTH_PREFIXED 时每条前加 4 字节小端长度，LINES 时发送与文件相同的字节。
+	// 收集器不可用时记录留在 bufferBytes 的缓冲区中，按 100ms 到 5s 退避重连；缓冲区满时若连接正常最多等待 50ms 让收集器读取，
+	// 仍放不下则改写入日志文件（Stats::netSpilled），
+	// 关闭或析构时未发出的记录也写入文件，因此网络与文件之间不保证顺序。发送时机与写入内核相同（同步模式每次写入、
+	// 异步模式每批、检测线程约每 0.5s），持久化设置不作用于已交给网络的记录；分片和客户端模式不经过网络输出。
+	// 端点格式错误或无法解析时返回 false
+	bool setNetworkSink(const std::string& endpoint, LogNetFraming framing = LogNetFraming::LENGTH_PREFIXED,
+		size_t bufferBytes = 4 * 1024 * 1024);
+
+	// 写入一条来自其他进程的记录（logger_ringd 使用）：nanos 为记录产生时的系统时钟（纳秒），context 为前缀
+	void writeRecord(uint64_t nanos, LogLevel level, const char* context, size_t contextLen, const char* message, size_t len);
+
+	// 开启或关闭区间追踪（Span），默认关闭。客户端模式（setSharedRing）下不支持，区间被丢弃
+	void setTracing(bool enable);
+
+	// 是否记录区间
+	bool tracing() const {
+		return tracing_.load(std::memory_order_relaxed);
+	}
+
+	// 设置日志时间精度，默认精确到毫秒
+	void setTimePrecision(TimePrecision precision);
+
+	// 设置日志行格式，默认 TEXT。JSON_LINES 的文件不能用 logger_query/logger_merge/logger_scan 按前缀解析
+	void setLayout(Layout layout);
+
+	// 消息来自不可信输入时开启，默认关闭：消息、上下文和结构化字符串值中的控制字符（含 \n、\r）转义为 \n、\r、\t 或 \xHH，
+	// 非法 UTF-8 字节转义为 \xHH（JSON 中替换为 \ufffd），一条日志不会被拆成多行。在写入时处理，不需要转义时整段复制
+	void setSanitize(bool enable);
+
+	// 是否在日志前缀中输出线程 ID（及线程名），默认关闭
+	void setThreadInfo(bool enable);
+
+	// 设置当前线程的名称，setThreadInfo(true) 时随线程 ID 输出，进程内所有日志器共用
+	static void setThreadName(const std::string& name);
+
+	// 当前线程的上下文字段（如请求 ID、租户）：压入后该线程的日志前缀带上 [key=value ...]，直到弹出。
+	// 前缀只在上下文变化时生成一次，之后每条日志直接复制；进程内所有日志器共用
+	static void pushContext(const std::string& key, const std::string& value);
+
+	// 弹出最近压入的上下文字段，没有字段时不做任何事
+	static void popContext();
+
+	// 获取运行指标快照
+	Stats getStats();
+
+	// 周期输出运行指标，interval 单位s，0 表示关闭；separateFile 为 true 时写入单独的 logger_stats.log
+	void setStatsOutput(uint64_t interval, bool separateFile = false);
+
+	// 异步模式的高优先级通道：不低于 level 的日志进入单独队列，写日志线程优先写入，不等待 logCycle_。
+	// 各通道内部保持顺序；高优先级日志可能写在更早产生、仍在普通队列中的日志之前，文件不再严格按时间排序
+	// （logger_query、logger_merge 和 logger_scan 假定文件按时间排序）。默认关闭
+	void setPriorityLane(bool enable, LogLevel level = LogLevel::LOG_WARNING);
+
+	// 设置某一等级的持久化程度，默认均为 PAGE_CACHE。
+	// 同步模式下 SYNC 等级的调用在日志落盘后返回，并发调用合并为一次落盘；
+	// 异步模式下写日志线程每批写完后落盘一次，需要等待时调用 flush()。
+	// 文件切换时不落盘，旧文件由之后的落盘（SYNC 等级、flush 或检测线程）在写锁外完成
+	void setDurability(LogLevel level, Durability durability);
+
+	// 阻塞直到调用前提交的所有日志落盘
+	void flush();
+
+	// 同 flush()，不阻塞，调用前提交的所有日志落盘后 future 就绪
+	std::future<void> flushAsync();
+
+	// 同 flush()，不阻塞，落盘后在写日志线程（同步模式下为调用线程）中调用 done
+	void flushAsync(const std::function<void()>& done);
+
+	// 非阻塞提交：异步队列已满时不入队也不等待，返回 false；force 为 true 时总是入队（可超出上限，不等待）。
+	// 同步模式、高优先级等级和未开启的等级返回 true。协程接口见 LogCoroutine.h
+	bool tryLog(const char* message, size_t len, LogLevel level, bool force = false);
+
+	// 异步队列已满时登记 ready 并返回 true，写日志线程取走队列后（或退出时）在写日志线程中调用 ready；
+	// 队列未满或同步模式时不登记，返回 false
+	bool waitQueueSpace(const std::function<void()>& ready);
+
+	// 设置时间索引（.idx）间隔：每写入 bytes 字节或经过 millis 毫秒记录一项，均为 0 时不生成索引
+	void setIndexInterval(size_t bytes, uint64_t millis);
+
+	// 异步控制台：console() 与回显的行先进入最多 bufferBytes 字节的缓冲区，由后台线程每批一次 write 输出到 stdout。
+	// 缓冲区满时按 overflow 处理，默认丢弃并计数（Stats::consoleDropped），慢终端不会阻塞调用线程。关闭时写出剩余内容
+	void setConsoleAsync(bool enable, LogConsoleOverflow overflow = LogConsoleOverflow::DROP, size_t bufferBytes = 1024 * 1024);
+
+	// 不低于 level 的日志同时输出到控制台，color 为 true 时等级按 ANSI 颜色显示；
+	// 未开启异步控制台时在写文件的线程中直接输出。输出在释放文件锁之后，控制台阻塞时不影响其他线程写文件
+	void setConsoleEcho(bool enable, LogLevel level = LogLevel::LOG_WARNING, bool color = false);
+
+	// 日志文件对页缓存的使用方式，默认 NORMAL。写入量大且与缓存敏感的应用同机时使用，避免日志挤出应用的页缓存：
+	// DIRECT 在 Linux 上以 O_DIRECT 写入完整的 4KB 块，日志不留在页缓存（末尾不完整的块按实际长度经普通描述符写出，
+	// 文件内容和 maxSize 切换与 NORMAL 完全相同；同步模式下每写满一块都要等待设备，宜配合异步模式）；
+	// 文件系统不支持时退回 DONTNEED：经页缓存写入，写回后丢弃。立即作用于当前文件，分片文件在下次打开时生效。
+	// 返回当前文件实际生效的方式（尚未打开文件时为请求的方式）
+	LogCacheMode setCacheMode(LogCacheMode mode);
+
+	// 实时订阅广播环的大小，默认 1MB；只在首个 Subscription 创建前生效
+	void setLiveBuffer(size_t bytes);
+
     // 打印调试日志
     template <typename... Args>
     void debug(const std::string& format, Args... args) {
+        if (!enabled(LogLevel::LOG_DEBUG)) return;
         std::string formattedString = formatString(format, args...);
-        log(formattedString,  LogLevel::LOG_DEBUG);
+        log(std::move(formattedString),  LogLevel::LOG_DEBUG);
+    }
+
+    // 打印调试日志，消息原样输出（不解析 {}），异步时复制一次到池化记录
+    void debug(const char* msg) { log(msg, LogLevel::LOG_DEBUG); }
+    void debug(const std::string& msg) { log(msg.data(), msg.size(), LogLevel::LOG_DEBUG); }
+    void debug(std::string&& msg) { log(std::move(msg), LogLevel::LOG_DEBUG); }
+#ifdef LOGGER_HAS_STRING_VIEW
+    void debug(std::string_view msg) { log(msg.data(), msg.size(), LogLevel::LOG_DEBUG); }
+#endif
+
+    // 打印结构化调试日志：debug("cache miss", kv("key", key), kv("size", n))。字段按类型二进制编码，
+    // 不做字符串格式化，写入时按 setLayout 展开为 key=value 或 JSON 成员
+    template <typename... Fields>
+    void debug(const char* message, const LogField& field, const Fields&... fields) {
+        if (!enabled(LogLevel::LOG_DEBUG)) return;
+        const LogField list[] = { field, fields... };
+        logFields(LogLevel::LOG_DEBUG, message, strlen(message), list, 1 + sizeof...(fields));
+    }
+    template <typename... Fields>
+    void debug(const std::string& message, const LogField& field, const Fields&... fields) {
+        if (!enabled(LogLevel::LOG_DEBUG)) return;
+        const LogField list[] = { field, fields... };
+        logFields(LogLevel::LOG_DEBUG, message.data(), message.size(), list, 1 + sizeof...(fields));
     }
 
     // 打印信息日志
     template <typename... Args>
     void info(const std::string& format, Args... args) {
+        if (!enabled(LogLevel::LOG_INFO)) return;
         std::string formattedString = formatString(format, args...);
-        log(formattedString,  LogLevel::LOG_INFO);
+        log(std::move(formattedString),  LogLevel::LOG_INFO);
+    }
+
+    // 打印信息日志，消息原样输出（不解析 {}），异步时复制一次到池化记录
+    void info(const char* msg) { log(msg, LogLevel::LOG_INFO); }
+    void info(const std::string& msg) { log(msg.data(), msg.size(), LogLevel::LOG_INFO); }
+    void info(std::string&& msg) { log(std::move(msg), LogLevel::LOG_INFO); }
+#ifdef LOGGER_HAS_STRING_VIEW
+    void info(std::string_view msg) { log(msg.data(), msg.size(), LogLevel::LOG_INFO); }
+#endif
+
+    // 打印结构化信息日志，见 debug
+    template <typename... Fields>
+    void info(const char* message, const LogField& field, const Fields&... fields) {
+        if (!enabled(LogLevel::LOG_INFO)) return;
+        const LogField list[] = { field, fields... };
+        logFields(LogLevel::LOG_INFO, message, strlen(message), list, 1 + sizeof...(fields));
+    }
+    template <typename... Fields>
+    void info(const std::string& message, const LogField& field, const Fields&... fields) {
+        if (!enabled(LogLevel::LOG_INFO)) return;
+        const LogField list[] = { field, fields... };
+        logFields(LogLevel::LOG_INFO, message.data(), message.size(), list, 1 + sizeof...(fields));
     }
 
     // 打印告警日志
     template <typename... Args>
     void warn(const std::string& format, Args... args) {
+        if (!enabled(LogLevel::LOG_WARNING)) return;
         std::string formattedString = formatString(format, args...);
-        log(formattedString,  LogLevel::LOG_WARNING);
+        log(std::move(formattedString),  LogLevel::LOG_WARNING);
+    }
+
+    // 打印告警日志，消息原样输出（不解析 {}），异步时复制一次到池化记录
+    void warn(const char* msg) { log(msg, LogLevel::LOG_WARNING); }
+    void warn(const std::string& msg) { log(msg.data(), msg.size(), LogLevel::LOG_WARNING); }
+    void warn(std::string&& msg) { log(std::move(msg), LogLevel::LOG_WARNING); }
+#ifdef LOGGER_HAS_STRING_VIEW
+    void warn(std::string_view msg) { log(msg.data(), msg.size(), LogLevel::LOG_WARNING); }
+#endif
+
+    // 打印结构化告警日志，见 debug
+    template <typename... Fields>
+    void warn(const char* message, const LogField& field, const Fields&... fields) {
+        if (!enabled(LogLevel::LOG_WARNING)) return;
+        const LogField list[] = { field, fields... };
+        logFields(LogLevel::LOG_WARNING, message, strlen(message), list, 1 + sizeof...(fields));
+    }
+    template <typename... Fields>
+    void warn(const std::string& message, const LogField& field, const Fields&... fields) {
+        if (!enabled(LogLevel::LOG_WARNING)) return;
+        const LogField list[] = { field, fields... };
+        logFields(LogLevel::LOG_WARNING, message.data(), message.size(), list, 1 + sizeof...(fields));
     }
 
     // 打印错误日志
     template <typename... Args>
     void error(const std::string& format, Args... args) {
+        if (!enabled(LogLevel::LOG_ERROR)) return;
         std::string formattedString = formatString(format, args...);
-        log(formattedString,  LogLevel::LOG_ERROR);
+        log(std::move(formattedString),  LogLevel::LOG_ERROR);
+    }
+
+    // 打印错误日志，消息原样输出（不解析 {}），异步时复制一次到池化记录
+    void error(const char* msg) { log(msg, LogLevel::LOG_ERROR); }
+    void error(const std::string& msg) { log(msg.data(), msg.size(), LogLevel::LOG_ERROR); }
+    void error(std::string&& msg) { log(std::move(msg), LogLevel::LOG_ERROR); }
+#ifdef LOGGER_HAS_STRING_VIEW
+    void error(std::string_view msg) { log(msg.data(), msg.size(), LogLevel::LOG_ERROR); }
+#endif
+
+    // 打印结构化错误日志，见 debug
+    template <typename... Fields>
+    void error(const char* message, const LogField& field, const Fields&... fields) {
+        if (!enabled(LogLevel::LOG_ERROR)) return;
+        const LogField list[] = { field, fields... };
+        logFields(LogLevel::LOG_ERROR, message, strlen(message), list, 1 + sizeof...(fields));
+    }
+    template <typename... Fields>
+    void error(const std::string& message, const LogField& field, const Fields&... fields) {
+        if (!enabled(LogLevel::LOG_ERROR)) return;
+        const LogField list[] = { field, fields... };
+        logFields(LogLevel::LOG_ERROR, message.data(), message.size(), list, 1 + sizeof...(fields));
     }
 
     // 打印控制台日志
     template <typename... Args>
     void console(const std::string& format, Args... args) {
         std::string formattedString = formatString(format, args...);
-        std::cout << formattedString << std::endl;
+        if (consoleAsync_.load(std::memory_order_relaxed)) {
+            console_.writeLine(formattedString.data(), formattedString.size());
+        }
+        else {
+            std::cout << formattedString << std::endl;
+        }
     }
 private:
     // 格式化字符串并返回 std::string
@@ -144,27 +673,241 @@ private:
 
     // 同步日志
     void log(const char* message, LogLevel level = LogLevel::LOG_INFO);
+
+    // 同步日志，message 不需要以 '\0' 结尾
+    void log(const char* message, size_t len, LogLevel level);
+
+    // 同步日志，与 const std::string& 版本相同，保留以便右值直接匹配
+    void log(std::string&& message, LogLevel level);
+
+    // 结构化日志：消息和字段编码后提交
+    void logFields(LogLevel level, const char* message, size_t len, const LogField* fields, size_t count);
 private:
 	std::string folderName_;// 日志文件夹名称
-	LogLevel logLevel_;// 日志等级
+	std::atomic<LogLevel> logLevel_;// 日志等级
+	std::atomic<bool> threadInfo_;// 日志前缀是否带线程 ID
 	bool async_;// 是否异步打印
 	bool daily_;// 创建日志周期：true:每天创建一个；false:每小时创建一个
 	std::atomic<bool> exit_;// 程序退出标识符
 	int retentionDays_;// 日志留存时间（天）
 	size_t maxSize_;// 单个文件最大长度
-	std::ofstream logFile_;// 日志输出对象
+	LogFile logFile_;// 日志输出对象
+	std::atomic<LogCacheMode> cacheMode_;// 日志文件的页缓存使用方式（分片文件打开时读取）
 	std::thread logThread_;// 异步日志线程
 	std::thread checkThread_;// 日志检测线程：超长后新建日志并加后缀做区分；删除旧日志
 	std::mutex logMutex_;// 日志输出对象锁
 	std::mutex logQueueMutex_;// 异步日志队列锁
-	std::deque<std::string> logQueue_;// 异步日志队列
+	LogRecordList logQueue_;// 异步日志队列，记录来自 LogRecordPool，生产者只记录原始时钟值，由写日志线程格式化
+	std::vector<std::function<void()> > spaceWaiters_;// 等待队列空位的回调（waitQueueSpace），受 logQueueMutex_ 保护
+	std::mutex priorityQueueMutex_;// 高优先级队列锁，与普通队列分开，普通队列满时不受影响
+	std::condition_variable priorityQueueCond_;// 高优先级日志到达时唤醒写日志线程
+	LogRecordList priorityQueue_;// 高优先级日志队列
+	std::atomic<bool> priorityPending_;// 高优先级队列非空，写普通日志时据此插入
+	std::atomic<int> priorityLevel_;// 进入高优先级队列的最低等级，大于 LOG_ERROR 表示关闭
+	LogHistogram priorityLatencyHistogram_;// 高优先级日志从产生到写入的耗时
     static const size_t maxQueueSize_ = 100000;// 异步日志队列数最大值
 	size_t fileSize_;// 当前文件大小
 	int currentFileIndex_; // 每天或每小时的文件编号
 	std::chrono::seconds logCycle_;// 日志刷新周期，单位s
+	LogClock clock_;// 日志时钟源
+	std::atomic<TimePrecision> timePrecision_;// 日志时间精度，分片模式下各生产线程读取
+	std::string currentDateHour_;// 当前日志文件的日期和小时，由检测线程更新
+	// 秒级时间的格式化缓存，避免每条日志都调用 localtime
+	struct TimeCache {
+		int64_t second;     // 已格式化的秒级时间，-1 表示无
+		char text[32];      // 秒级时间的字符串格式
+		int64_t wallSecond; // second 对应的本地挂钟时间（秒）
+
+		TimeCache() : second(-1), wallSecond(0) {
+			text[0] = '\0';
+		}
+	};
+	TimeCache timeCache_;// 日志时间缓存，受 logMutex_ 保护
+	std::string lineBuffer_;// 单条日志格式化缓冲区，复用以避免分配
+	std::string spillBuffer_;// 超出内联长度的消息拼接缓冲区，仅写日志线程使用
+	size_t queueHighWater_;// 异步队列长度峰值，受 logQueueMutex_ 保护
+	std::atomic<uint64_t> recordCounts_[4];// 各等级日志条数
+	std::atomic<uint64_t> recordsWritten_;// 已写入条数
+	std::atomic<uint64_t> bytesWritten_;// 已写入字节数
+	std::atomic<uint64_t> rotations_;// 文件切换次数
+	std::atomic<uint64_t> cleanRuns_;// 清理次数
+	std::atomic<uint64_t> filesDeleted_;// 已删除文件数
+	mutable std::atomic<uint64_t> cleanFailures_;// 删除失败文件数
+	LogHistogram backpressureHistogram_;// 生产者等待耗时
+	LogHistogram writeBatchHistogram_;// 每批写入耗时
+	LogHistogram writeBatchSizeHistogram_;// 每批写入条数
+	LogHistogram rotationHistogram_;// 文件切换耗时
+	LogHistogram cleanHistogram_;// 清理耗时
+	std::atomic<uint64_t> statsInterval_;// 运行指标输出周期，单位s，0 表示关闭
+	std::atomic<bool> statsSeparateFile_;// 运行指标是否写入单独文件
+	std::ofstream statsFile_;// 运行指标文件，仅检测线程使用
+	std::ofstream indexFile_;// 时间索引输出对象，与 logFile_ 同步打开和关闭
+	size_t indexBytes_;// 索引字节间隔
+	uint64_t indexNanos_;// 索引时间间隔，单位ns
+	uint64_t lastIndexOffset_;// 上一个索引项的文件偏移
+	uint64_t lastIndexNanos_;// 上一个索引项的时间
+	bool indexNext_;// 下一行是否必须记录索引（新文件的第一行）
+	static const size_t lineEndSize_;// 换行符在文件中占用的字节数
+	static const char* const lineEnd_;// 换行符
+	std::atomic<int> durability_[4];// 各等级的持久化程度，按 LogLevel 索引
+	uint64_t writeSeq_;// 累计写入字节数（跨文件），落盘进度以此计，受 logMutex_ 保护
+	std::mutex syncMutex_;// 落盘状态锁
+	std::condition_variable syncCond_;// 落盘完成通知
+	bool syncing_;// 是否有线程正在落盘，受 syncMutex_ 保护
+	uint64_t syncedSeq_;// 已落盘的 writeSeq_，受 syncMutex_ 保护
+	// 切换时关闭、尚未落盘的旧文件
+	struct ClosedFile {
+		int fd;    // 描述符副本
+		bool drop; // 落盘后丢弃页缓存（DIRECT、DONTNEED）
+	};
+	std::vector<ClosedFile> closedFiles_;// 由下一次落盘在锁外落盘后关闭，受 logMutex_ 保护
+	LogHistogram syncHistogram_;// 落盘耗时
+	LogConsole console_;// 控制台输出
+	std::atomic<bool> consoleAsync_;// console() 是否经异步控制台输出
+	std::atomic<int> consoleEchoLevel_;// 回显到控制台的最低等级，大于 LOG_ERROR 表示关闭
+	// 待回显的一行
+	struct EchoLine {
+		LogLevel level;   // 等级
+		std::string line; // 格式化后的日志行（不含换行）
+	};
+	std::vector<EchoLine> echoPending_;// writeLocked 收集、释放 logMutex_ 后回显的行，受 logMutex_ 保护
+	static const int spanRecordLevel_ = -1;// 区间记录在 LogPoolRecord::level 中的标记
+	static const int structuredRecordFlag_ = 0x100;// 结构化记录在 LogPoolRecord::level 中的标记位
+	std::atomic<Layout> layout_;// 日志行格式
+	std::atomic<bool> sanitize_;// 转义消息中的控制字符和非法 UTF-8
+	std::atomic<bool> tracing_;// 是否记录区间
+	LogFile traceFile_;// 区间输出对象（.trace.json），随日志文件切换，受 logMutex_ 保护
+	bool traceFirstEvent_;// traceFile_ 中尚未写入事件
+	uint64_t traceEpoch_;// 分片模式下 traceFile_ 所属的分片组
+	std::string traceBuffer_;// 区间事件格式化缓冲区，受 logMutex_ 保护
+	std::string tracePid_;// 进程 ID 文本
+
+	// 分片：一个生产线程的输出文件及其计数
+	struct Shard {
+		std::mutex mutex;                      // 所属线程写入时持有，检测线程写入内核或关闭时短暂持有，平时无竞争
+		LogFile file;                          // 分片文件
+		std::string line;                      // 格式化缓冲区
+		TimeCache timeCache;                   // 时间缓存
+		uint64_t threadId;                     // 所属线程 ID
+		uint64_t epoch;                        // 文件所属分片组的版本，与 shardEpoch_ 不同时重新打开
+		std::atomic<uint64_t> records[4];      // 各等级条数，仅所属线程修改
+		std::atomic<uint64_t> bytes;           // 已写入字节数，仅所属线程修改
+
+		Shard() : threadId(0), epoch(0), bytes(0) {
+			for (int i = 0; i < 4; ++i) {
+				records[i].store(0, std::memory_order_relaxed);
+			}
+		}
+	};
+	std::atomic<bool> sharded_;// 是否为分片模式
+	std::mutex shardMutex_;// 保护 shards_、shardDateHour_、shardIndex_、shardPrefix_
+	std::vector<std::shared_ptr<Shard> > shards_;// 所有分片
+	std::string shardDateHour_;// 当前分片组的日期和小时
+	int shardIndex_;// 当前分片组编号
+	std::string shardPrefix_;// 当前分片组的文件名前缀（不含线程 ID 和扩展名）
+	std::atomic<uint64_t> shardEpoch_;// 分片组版本，整组切换时加一
+	std::atomic<bool> ringClient_;// 是否为客户端模式（写入共享内存环）
+	std::mutex ringMutex_;// 环的写入锁，环只允许单个写入方
+	LogRing ring_;// 共享内存环，开启后保持映射直到析构
+	LogRingOverflow ringOverflow_;// 环满时的处理方式，受 ringMutex_ 保护
+	LogNetSink netSink_;// 网络输出，受 logMutex_ 保护
+	std::unique_ptr<LogBroadcast> live_;// 实时订阅广播环，首个订阅时创建并保留到析构；写入受 logMutex_ 保护，读取不加锁
+	size_t liveBytes_;// 广播环大小，受 logMutex_ 保护
+	std::atomic<uint64_t> netRecords_;// 交给网络输出的条数
+	std::atomic<uint64_t> netSpilled_;// 网络输出缓冲区满时改写入文件的条数
+
+	// 异步模式的 flush 请求：两个队列分别写到 target 后完成
+	struct FlushRequest {
+		uint64_t normalTarget;           // 请求时普通队列累计入队条数
+		uint64_t priorityTarget;         // 请求时高优先级队列累计入队条数
+		std::promise<void> promise;      // 完成通知
+		std::function<void()> callback;  // 完成回调，可为空
+	};
+	std::mutex flushMutex_;// flush 请求锁
+	std::vector<FlushRequest> flushRequests_;// 等待中的 flush 请求
+	std::atomic<bool> flushPending_;// 有等待中的 flush 请求，写日志线程据此立即写入
+	uint64_t normalEnqueued_;// 普通队列累计入队条数，受 logQueueMutex_ 保护
+	uint64_t priorityEnqueued_;// 高优先级队列累计入队条数，受 priorityQueueMutex_ 保护
+	uint64_t normalWritten_;// 普通队列累计写入条数，仅写日志线程使用
+	uint64_t priorityWritten_;// 高优先级队列累计写入条数，仅写日志线程使用
+	std::mutex categoryMutex_;// 分类及其等级设置锁
+	std::map<std::string, Category*> categories_;// 已创建的分类
+	const uint64_t instanceId_;// 进程内唯一的日志器编号，用于线程本地缓存
+	std::mutex latencyMutex_;// 延迟指标锁
+	std::map<std::string, LatencyMetric*> latencies_;// 已创建的延迟指标
+	std::atomic<uint64_t> latencyInterval_;// 延迟汇总输出周期，单位s，0 表示关闭
+	std::map<std::string, LogLevel> categoryLevels_;// 单独设置的分类等级
+	std::string levelConfigPath_;// 自动重新读取的等级配置文件，受 categoryMutex_ 保护
+	std::atomic<bool> levelConfigChanged_;// levelConfigPath_ 已修改，检测线程需重新监视
+
+	// 提交一条日志：异步时复制到池化记录后入队，同步时直接写文件
+	// structured 为 true 时 message 为 LogFieldCodec 编码的消息和字段；wait 为 false 时异步队列满也不等待
+	void submit(uint64_t tick, LogLevel level, const char* message, size_t len, bool structured = false, bool wait = true);
+
+	// 同上，context 为已确定的前缀
+	void submit(uint64_t tick, LogLevel level, const char* context, size_t contextLen, const char* message, size_t len,
+		bool structured = false, bool wait = true);
+
+	// 提交一批池化记录（消息前 contextLength 字节为线程上下文前缀，结构化记录带 structuredRecordFlag_），records 变为空
+	void submitBatch(uint64_t tick, LogRecordList& records);
+
+	// 统计进入日志路径的条数；分片模式由各分片自己计数，避免多线程竞争同一计数器
+	void countRecord(LogLevel level) {
+		if (!sharded_.load(std::memory_order_relaxed)) {
+			recordCounts_[static_cast<int>(level)].fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	// 当前线程在本日志器中的分片，不存在时创建
+	Shard& localShard();
+
+	// 分片模式下写入一条日志，SYNC 等级时落盘该分片
+	void writeToShard(uint64_t tick, LogLevel level, const char* context, size_t contextLen, const char* message, size_t len,
+		bool structured);
+
+	// 整组切换分片：epoch 为调用方看到的版本，已被其他线程切换时不做任何事
+	void rotateShards(uint64_t epoch);
+
+	// 所有分片写入内核（sync 为 true 时落盘），关闭已切换的分片组中的文件；closeAll 为 true 时关闭全部
+	void flushShards(bool sync, bool closeAll = false);
+
+	// 提交一条区间记录：异步时以二进制形式入普通队列，同步时直接写入追踪文件
+	void submitSpan(uint64_t beginTick, uint64_t endTick, const char* name, size_t len);
+
+	// 写入一个区间事件，调用方持有 logMutex_
+	void writeSpan(uint64_t beginTick, uint64_t endTick, uint64_t threadId, const char* name, size_t len);
+
+	// 追踪文件补全 JSON 数组后关闭，调用方持有 logMutex_（析构时除外）
+	void closeTraceFile();
+
+	// 分类的有效等级，调用方持有 categoryMutex_
+	LogLevel effectiveLevel(const std::string& name) const;
+
+	// 重新计算所有分类的有效等级，调用方持有 categoryMutex_
+	void updateCategoryLevels();
 
-	// 获取当前时间的字符串格式
-	std::string getCurrentTime() const;
+	// 输出一次运行指标
+	void writeStats(Stats& last, uint64_t elapsedMillis);
+
+	// 输出上次以来有样本的延迟指标汇总
+	void writeLatencies();
+
+	// 将纳秒时间戳追加为字符串格式：YYYY-MM-DD HH:MM:SS.mmm，返回输出的本地挂钟时间（纳秒，截断到输出精度）
+	uint64_t appendTime(std::string& out, uint64_t nanos, TimeCache& cache);
+
+	// 格式化一条日志（不含换行），context 为已生成的线程上下文前缀，返回日志的本地挂钟时间（纳秒）
+	uint64_t formatRecord(uint64_t tick, LogLevel level, const char* context, size_t contextLen,
+		const char* message, size_t len, std::string& out, bool structured = false);
+
+	// 同上，时间为纳秒时间戳，使用给定的时间缓存；按 layout_ 输出文本或 JSON
+	uint64_t formatLine(uint64_t nanos, TimeCache& cache, LogLevel level, const char* context, size_t contextLen,
+		const char* message, size_t len, bool structured, std::string& out);
+
+	// 不低于回显等级的日志行输出到控制台（line 不含换行），文本格式时给等级着色
+	void echoConsole(LogLevel level, const std::string& line);
+
+	// 回显 writeLocked 收集的行并清空；控制台可能阻塞（LogConsoleOverflow::BLOCK），须在释放 logMutex_ 后调用
+	void echoLines(std::vector<EchoLine>& lines);
 
 	// 获取当前日期和小时
 	std::string getCurrentDateHour() const;
@@ -172,11 +915,54 @@ private:
 	// 获取日志文件名，基于当前时间和文件编号
 	std::string getLogFileName() const;
 
-	// 将日志消息写入文件
-	void writeToFile(const std::string& message);
+	// 获取日志文件名（不含扩展名）
+	std::string getLogFilePrefix() const;
+
+	// 打开当前日志文件及其索引文件，调用方持有 logMutex_
+	void openLogFile();
+
+	// 关闭当前日志文件及其索引文件，调用方持有 logMutex_
+	void closeLogFile();
+
+	// 记录一个索引项，调用方持有 logMutex_
+	void writeIndexEntry(uint64_t wallNanos);
+
+	// 是否为日志器生成的文件（日志、索引）
+	static bool isLogFile(const std::string& fileName);
 
-	// 清理过期的日志文件
-	void cleanOldLogs() const;
+	// 将日志消息写入文件，该等级要求落盘时返回需要落盘到的 writeSeq_，否则返回 0
+	uint64_t writeToFile(uint64_t tick, LogLevel level, const char* context, size_t contextLen, const char* message, size_t len,
+		bool structured = false);
+
+	// 同上，调用方持有 logMutex_；只追加到文件缓冲区，由调用方决定何时写入内核
+	uint64_t writeLocked(uint64_t tick, LogLevel level, Durability durability, const char* context, size_t contextLen,
+		const char* message, size_t len, bool structured);
+
+	// 写入一条池化记录，消息有续块时先拼接到 spillBuffer_；仅写日志线程调用
+	uint64_t writeToFile(const LogPoolRecord& record);
+
+	// 落盘直到 syncedSeq_ >= target；已有线程在落盘时等待其完成，一次落盘覆盖所有等待者（组提交），
+	// 切换时关闭的旧文件一并落盘
+	void syncTo(uint64_t target);
+
+	// 写日志线程每批写完后调用：写入内核，需要时落盘，完成已满足的 flush 请求
+	void completeBatch(uint64_t syncTarget);
+
+	// flush 的共同实现：分片落盘一次；同步模式在调用线程写入内核并落盘后完成 request，
+	// 异步模式登记 request，由写日志线程写到请求时的位置后完成
+	void flushBarrier(FlushRequest& request);
+
+	// 实时订阅广播环，不存在时创建
+	LogBroadcast& liveRing();
+
+	// 把文件缓冲区写入内核并发送网络输出缓冲区，调用方持有 logMutex_
+	void flushLocked();
+
+	// 网络输出中未发出的记录写入日志文件，调用方持有 logMutex_
+	void spillNetLocked();
+
+	// 清理过期的日志文件，返回删除的文件数
+	int cleanOldLogs() const;
 
     // 获取当前最大序号
 	int getMaxLogSequence();
@@ -187,6 +973,9 @@ private:
 	// 异步线程工作函数
 	void logThreadFunction();
 
+	// 写入高优先级队列中的全部日志
+	void writePriorityLogs();
+
 	//确保在关机前写入所有剩余日志
 	void flushRemainingLogs();
 
@@ -194,7 +983,7 @@ private:
 	void checkThreadFunction();
 
 	// 将日志级别转换为字符串
-	std::string logLevelToString(LogLevel level) const;
+	static const char* logLevelToString(LogLevel level);
 
 	// 返回 Unix 纪元时间，精确到毫秒
 	static uint64_t getCurrentTimeMillis();
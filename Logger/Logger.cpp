@@ -4,6 +4,7 @@
 #include <sstream>
 #include <functional>
 #include <cstdarg>
+#include <cstring>
 #include <regex>
 #include <io.h>
 #include <sys/stat.h>
@@ -37,7 +38,7 @@ void Logger::setLogLevel(LogLevel level) {
 }
 
 void Logger::debug(const char* format, ...) {
-	if (format == nullptr) {
+	if (format == nullptr || LOG_DEBUG < logLevel_) {
 		return;
 	}
 	va_list args;
@@ -49,11 +50,11 @@ void Logger::debug(const char* format, ...) {
 }
 
 void Logger::debug(const std::string& msg) {
-	debug(msg.c_str());
+	log(msg, LOG_DEBUG);// 原样输出，不作为格式串解析
 }
 
 void Logger::info(const char* format, ...) {
-	if (format == nullptr) {
+	if (format == nullptr || LOG_INFO < logLevel_) {
 		return;
 	}
 	va_list args;
@@ -65,11 +66,11 @@ void Logger::info(const char* format, ...) {
 }
 
 void Logger::info(const std::string& msg) {
-	info(msg.c_str());
+	log(msg, LOG_INFO);// 原样输出，不作为格式串解析
 }
 
 void Logger::warn(const char* format, ...) {
-	if (format == nullptr) {
+	if (format == nullptr || LOG_WARNING < logLevel_) {
 		return;
 	}
 	va_list args;
@@ -81,11 +82,11 @@ void Logger::warn(const char* format, ...) {
 }
 
 void Logger::warn(const std::string& msg) {
-	warn(msg.c_str());
+	log(msg, LOG_WARNING);// 原样输出，不作为格式串解析
 }
 
 void Logger::error(const char* format, ...) {
-	if (format == nullptr) {
+	if (format == nullptr || LOG_ERROR < logLevel_) {
 		return;
 	}
 	va_list args;
@@ -97,7 +98,7 @@ void Logger::error(const char* format, ...) {
 }
 
 void Logger::error(const std::string& msg) {
-	error(msg.c_str());
+	log(msg, LOG_ERROR);// 原样输出，不作为格式串解析
 }
 
 void Logger::console(const char* format, ...) {
@@ -114,7 +115,7 @@ void Logger::console(const char* format, ...) {
 }
 
 void Logger::console(const std::string& msg) {
-	console(msg.c_str());
+	std::cerr << "[" << getCurrentDateTime() << "] " << msg << std::endl;
 }
 
 void Logger::output(const char* format, ...) {
@@ -131,7 +132,8 @@ void Logger::output(const char* format, ...) {
 }
 
 void Logger::output(const std::string& msg) {
-	output(msg.c_str());
+	std::string line = "[" + getCurrentDateTime() + "] " + msg + "\n";
+	OutputDebugStringA(line.c_str());
 }
 
 void Logger::log(const std::string& message, LogLevel level) {
@@ -141,20 +143,25 @@ void Logger::log(const std::string& message, LogLevel level) {
 void Logger::log(const char* message, LogLevel level) {
 	if (level < logLevel_ || message == nullptr) return;
 
-	std::stringstream logStream;
-	logStream << "[" << getCurrentDateTime() << "] [" << logLevelToString(level) << "] " << message;
+	// 直接拼接，只复制一次消息
+	std::string dateTime = getCurrentDateTime();
+	std::string levelName = logLevelToString(level);
+	size_t messageLength = strlen(message);
+	std::string line;
+	line.reserve(dateTime.size() + levelName.size() + messageLength + 6);
+	line.append("[", 1).append(dateTime).append("] [", 3).append(levelName).append("] ", 2).append(message, messageLength);
 
 	if (async_) {
 		{
 			LoggerLockGuard lock(logQueueMutex_);
-			logQueue_.push_back(logStream.str());
+			logQueue_.push_back(std::move(line));
 			if (logQueue_.size() >= maxQueueSize_) {
 				Sleep(10);// 等待日志打印，防止累积
 			}
 		}
 	}
 	else {
-		writeToFile(logStream.str());
+		writeToFile(line);
 	}
 }
 
@@ -0,0 +1,78 @@
+/******************************************************************************/
+/* File Name:    LogMergeTool.cpp                                            */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Merges log folders and segment files into one time-ordered */
+/*               stream (see LogMerge.h).                                    */
+/*----------------------------------------------------------------------------*/
+/* Usage:                                                                    */
+/*   logger_merge [--output FILE] PATH...                                    */
+/*     PATH: a log folder (its segments form one source, the files of each  */
+/*           thread in sharded mode one more) or a log file (a source of   */
+/*           its own)                                                        */
+/******************************************************************************/
+
+#include "LogMerge.h"
+#include "LogReader.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#define stat _stat
+#endif
+
+static bool isDirectory(const std::string& path) {
+	struct stat fileStat;
+	return stat(path.c_str(), &fileStat) == 0 && (fileStat.st_mode & S_IFDIR) != 0;
+}
+
+int main(int argc, char* argv[]) {
+	std::string output;
+	LogMerger merger;
+	int sources = 0;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--output" && i + 1 < argc) {
+			output = argv[++i];
+		}
+		else if (!arg.empty() && arg[0] != '-') {
+			if (isDirectory(arg)) {
+				// 分片模式下每个线程的文件各为一路
+				std::vector<std::vector<std::string> > folderSources = listLogSources(arg);
+				for (size_t s = 0; s < folderSources.size(); ++s) {
+					merger.addSource(folderSources[s]);
+				}
+			}
+			else {
+				merger.addSource(std::vector<std::string>(1, arg));
+			}
+			++sources;
+		}
+		else {
+			sources = 0;
+			break;
+		}
+	}
+	if (sources == 0) {
+		fprintf(stderr, "Usage: logger_merge [--output FILE] PATH...\n"
+			"  PATH: a log folder (its segments form one source) or a log file\n");
+		return 1;
+	}
+
+	FILE* out = stdout;
+	if (!output.empty()) {
+		out = fopen(output.c_str(), "wb");
+		if (out == nullptr) {
+			fprintf(stderr, "Failed to open output file: %s\n", output.c_str());
+			return 1;
+		}
+	}
+	uint64_t count = merger.mergeTo(out);
+	if (out != stdout) {
+		fclose(out);
+	}
+	fprintf(stderr, "Merged %llu records from %d sources\n", static_cast<unsigned long long>(count), sources);
+	return 0;
+}
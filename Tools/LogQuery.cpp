@@ -0,0 +1,268 @@
+/******************************************************************************/
+/* File Name:    LogQuery.cpp                                                */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Time-range query, tail and follow over log segments using  */
+/*               the sparse .idx sidecar written by the C11 Logger.         */
+/*----------------------------------------------------------------------------*/
+/* Usage:                                                                    */
+/*   logger_query [--from TIME] [--to TIME] [--level LEVEL] PATH...          */
+/*   logger_query --tail N [--follow] [--level LEVEL] PATH                   */
+/*     PATH: a log folder or YYYYMMDDHH_N.log files                          */
+/*     TIME: "YYYY-MM-DD HH:MM[:SS[.fff]]" or "YYYY-MM-DD"                   */
+/*----------------------------------------------------------------------------*/
+/* Note:                                                                     */
+/*   - Only the index blocks around the requested range are read; segments */
+/*     without an index are scanned completely.                             */
+/******************************************************************************/
+
+#include "LogReader.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <sys/stat.h>
+#define stat _stat
+#else
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+// 命令行参数
+struct QueryOptions {
+	uint64_t from = 0;
+	uint64_t to = UINT64_MAX;
+	int minLevel = 0;
+	size_t tail = 0;
+	bool tailMode = false;
+	bool follow = false;
+	std::vector<std::string> paths;
+	std::string folder;// 指定文件夹时用于跟随切换后的新文件
+};
+
+bool isDirectory(const std::string& path) {
+	struct stat fileStat;
+	return stat(path.c_str(), &fileStat) == 0 && (fileStat.st_mode & S_IFDIR) != 0;
+}
+
+// 解析命令行中的时间，允许省略秒或时分秒
+bool parseQueryTime(const std::string& text, uint64_t& wallNanos) {
+	std::string value = text;
+	if (value.size() == 10) {
+		value += " 00:00:00";
+	}
+	else if (value.size() == 16) {
+		value += ":00";
+	}
+	const char* end = value.c_str() + value.size();
+	const char* p = parseLogTime(value.c_str(), end, wallNanos);
+	return p == end;
+}
+
+// 按等级和时间过滤并输出，无前缀的续行跟随上一条日志
+class LineFilter {
+public:
+	LineFilter(const QueryOptions& options) : options_(options), matched_(false) {}
+
+	void operator()(const char* begin, const char* end) {
+		LogLineInfo info;
+		if (parseLogLine(begin, end, info)) {
+			matched_ = info.level >= options_.minLevel && info.wallNanos >= options_.from && info.wallNanos <= options_.to;
+		}
+		if (matched_) {
+			fwrite(begin, 1, end - begin, stdout);
+			fputc('\n', stdout);
+		}
+	}
+
+private:
+	const QueryOptions& options_;
+	bool matched_;
+};
+
+void queryRange(const QueryOptions& options) {
+	LineFilter filter(options);
+	for (size_t i = 0; i < options.paths.size(); ++i) {
+		LogSegment segment;
+		if (!segment.open(options.paths[i])) {
+			fprintf(stderr, "Failed to open file: %s\n", options.paths[i].c_str());
+			continue;
+		}
+		// 段的第一条日志已晚于查询范围
+		if (!segment.index().empty() && segment.index().front().offset == 0 && segment.index().front().wallNanos > options.to) {
+			continue;
+		}
+		if (segment.size() == 0) {
+			continue;
+		}
+		size_t begin = 0, end = 0;
+		segment.rangeOffsets(options.from, options.to, begin, end);
+		forEachLogLine(segment.data() + begin, segment.data() + end, filter);
+	}
+	fflush(stdout);
+}
+
+// 输出新增内容中的完整行，不完整的行留到下次
+void emitAppended(const std::string& path, uint64_t& offset, std::string& pending, LineFilter& filter) {
+	FILE* file = fopen(path.c_str(), "rb");
+	if (file == nullptr) {
+		return;
+	}
+	fseek(file, static_cast<long>(offset), SEEK_SET);
+	char buffer[64 * 1024];
+	size_t count;
+	while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+		offset += count;
+		pending.append(buffer, count);
+		size_t lastNewline = pending.rfind('\n');
+		if (lastNewline != std::string::npos) {
+			forEachLogLine(pending.data(), pending.data() + lastNewline, filter);
+			pending.erase(0, lastNewline + 1);
+		}
+	}
+	fclose(file);
+	fflush(stdout);
+}
+
+int tailSegments(const QueryOptions& options) {
+	// 从最后一个文件向前查找，切换或等级过滤后最后一个文件中不足 N 条时继续向前
+	size_t first = options.paths.size() - 1;
+	size_t firstBegin = 0;
+	size_t remaining = options.tail;
+	for (size_t i = options.paths.size(); i > 0 && remaining > 0; --i) {
+		LogSegment segment;
+		if (!segment.open(options.paths[i - 1])) {
+			fprintf(stderr, "Failed to open file: %s\n", options.paths[i - 1].c_str());
+			return 1;
+		}
+		size_t found = 0;
+		first = i - 1;
+		firstBegin = segment.tailOffset(remaining, options.minLevel, found);
+		remaining -= found;
+	}
+	if (remaining == options.tail) {
+		// N 为 0 或没有满足等级的日志：不输出已有内容
+		first = options.paths.size() - 1;
+		firstBegin = static_cast<size_t>(-1);
+	}
+
+	std::string path = options.paths.back();
+	LineFilter filter(options);
+	uint64_t offset = 0;
+	for (size_t i = first; i < options.paths.size(); ++i) {
+		LogSegment segment;
+		if (!segment.open(options.paths[i])) {
+			fprintf(stderr, "Failed to open file: %s\n", options.paths[i].c_str());
+			return 1;
+		}
+		size_t begin = i == first ? std::min(firstBegin, segment.size()) : 0;
+		forEachLogLine(segment.data() + begin, segment.data() + segment.size(), filter);
+		offset = segment.size();
+	}
+	fflush(stdout);
+	if (!options.follow) {
+		return 0;
+	}
+
+	// 跟随：只检查文件长度，新增部分直接读取；指定文件夹时跟随切换后的新文件
+	std::string pending;
+	while (true) {
+		struct stat fileStat;
+		if (stat(path.c_str(), &fileStat) == 0 && static_cast<uint64_t>(fileStat.st_size) > offset) {
+			emitAppended(path, offset, pending, filter);
+			continue;
+		}
+		if (!options.folder.empty()) {
+			std::vector<std::string> segments = listLogSegments(options.folder);
+			if (!segments.empty() && segments.back() != path) {
+				emitAppended(path, offset, pending, filter);
+				path = segments.back();
+				offset = 0;
+				pending.clear();
+				continue;
+			}
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(200));
+	}
+}
+
+void printUsage() {
+	fprintf(stderr, "Usage: logger_query [--from TIME] [--to TIME] [--level LEVEL] PATH...\n"
+		"       logger_query --tail N [--follow] [--level LEVEL] PATH\n"
+		"  PATH: a log folder or YYYYMMDDHH_N.log files\n"
+		"  TIME: \"YYYY-MM-DD HH:MM[:SS[.fff]]\" or \"YYYY-MM-DD\"\n");
+}
+
+bool parseOptions(int argc, char* argv[], QueryOptions& options) {
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--from" && hasValue) {
+			if (!parseQueryTime(argv[++i], options.from)) {
+				return false;
+			}
+		}
+		else if (arg == "--to" && hasValue) {
+			if (!parseQueryTime(argv[++i], options.to)) {
+				return false;
+			}
+		}
+		else if (arg == "--level" && hasValue) {
+			std::string level = argv[++i];
+			options.minLevel = parseLogLevel(level.c_str(), level.size());
+			if (options.minLevel < 0) {
+				return false;
+			}
+		}
+		else if (arg == "--tail" && hasValue) {
+			options.tail = static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10));
+			options.tailMode = true;
+		}
+		else if (arg == "--follow") {
+			options.follow = true;
+			options.tailMode = true;
+			if (options.tail == 0) {
+				options.tail = 10;
+			}
+		}
+		else if (!arg.empty() && arg[0] != '-') {
+			if (isDirectory(arg)) {
+				std::vector<std::string> segments = listLogSegments(arg);
+				options.paths.insert(options.paths.end(), segments.begin(), segments.end());
+				options.folder = arg;
+			}
+			else {
+				options.paths.push_back(arg);
+			}
+		}
+		else {
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	QueryOptions options;
+	if (!parseOptions(argc, argv, options)) {
+		printUsage();
+		return 1;
+	}
+	if (options.paths.empty()) {
+		fprintf(stderr, "No log files found\n");
+		return 1;
+	}
+	if (options.tailMode) {
+		return tailSegments(options);
+	}
+	queryRange(options);
+	return 0;
+}
@@ -0,0 +1,211 @@
+/******************************************************************************/
+/* File Name:    LogRingDaemon.cpp                                           */
+/* Date:         2026-10-19                                                  */
+/* Version:      1.0                                                         */
+/* Description:  Writer daemon for loggers in client mode                   */
+/*               (Logger::setSharedRing): drains the shared-memory rings of */
+/*               all client processes of a log folder into one set of      */
+/*               rotated YYYYMMDDHH_N.log files.                             */
+/*----------------------------------------------------------------------------*/
+/* Usage:                                                                    */
+/*   logger_ringd [--async] [--daily] [--max-size MB] [--retention DAYS]     */
+/*                [--window MS] [--no-pid] FOLDER                            */
+/*----------------------------------------------------------------------------*/
+/* Note:                                                                     */
+/*   - Every line is prefixed with "[pid] " of the client unless --no-pid. */
+/*   - The rings are merged by record time: each step writes the earliest */
+/*     head of all rings. Records younger than --window (default 20 ms)   */
+/*     wait for the next round so that a client that was a little late   */
+/*     still falls into place. A record that reaches its ring later than  */
+/*     that is written when it arrives, so the file is ordered only up to */
+/*     the window.                                                          */
+/*   - A ring whose record sizes do not fit its mapping is skipped up to  */
+/*     its head, with a warning line in the log.                           */
+/*   - Rings of exited clients (also crashed ones) are drained and then    */
+/*     removed; rings left from before the daemon started are drained too. */
+/*   - Stops on SIGINT/SIGTERM after draining what is in the rings.        */
+/******************************************************************************/
+
+#include "Logger.h"
+#include "LogRing.h"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void onSignal(int) {
+	stopRequested = 1;
+}
+
+// 一个客户端环及其转写状态
+struct ClientRing {
+	LogRing ring;
+	std::string prefix;        // 行前缀 "[pid] "
+	uint64_t droppedReported;  // 已报告过的丢弃条数
+	uint64_t corruptReported;  // 已报告过的损坏次数
+};
+
+void printUsage() {
+	fprintf(stderr, "Usage: logger_ringd [--async] [--daily] [--max-size MB] [--retention DAYS] [--window MS] [--no-pid] FOLDER\n");
+}
+
+}
+
+int main(int argc, char* argv[]) {
+	bool async = false;
+	bool daily = false;
+	bool pidPrefix = true;
+	size_t maxSize = 50 * 1024 * 1024;
+	int retentionDays = 30;
+	uint64_t windowNanos = 20 * 1000000ull;
+	std::string folder;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--async") {
+			async = true;
+		}
+		else if (arg == "--daily") {
+			daily = true;
+		}
+		else if (arg == "--no-pid") {
+			pidPrefix = false;
+		}
+		else if (arg == "--max-size" && hasValue) {
+			maxSize = static_cast<size_t>(std::atoll(argv[++i])) * 1024 * 1024;
+		}
+		else if (arg == "--retention" && hasValue) {
+			retentionDays = std::atoi(argv[++i]);
+		}
+		else if (arg == "--window" && hasValue) {
+			windowNanos = static_cast<uint64_t>(std::atoll(argv[++i])) * 1000000ull;
+		}
+		else if (!arg.empty() && arg[0] != '-' && folder.empty()) {
+			folder = arg;
+		}
+		else {
+			printUsage();
+			return 1;
+		}
+	}
+	if (folder.empty() || maxSize == 0) {
+		printUsage();
+		return 1;
+	}
+
+	LogRing::makeDirectory(folder);
+	std::string directory = LogRing::directory(folder);
+	LogRing::makeDirectory(directory);
+	std::signal(SIGINT, onSignal);
+	std::signal(SIGTERM, onSignal);
+
+	// 等级过滤由各客户端完成，这里全部写出
+	Logger logger(folder, Logger::LogLevel::LOG_DEBUG, daily, async, 1, retentionDays, maxSize);
+	fprintf(stderr, "logger_ringd: %s <- %s\n", folder.c_str(), directory.c_str());
+
+	std::map<std::string, std::unique_ptr<ClientRing> > clients;
+	auto note = [&](ClientRing& client, const std::string& text) {
+		logger.writeRecord(LogClock::systemNanos(), Logger::LogLevel::LOG_WARNING, client.prefix.data(), client.prefix.size(),
+			text.data(), text.size());
+	};
+	auto lastScan = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+	int idleRounds = 0;
+	while (true) {
+		bool stopping = stopRequested != 0;
+		// 每 100ms 查找新的环
+		auto now = std::chrono::steady_clock::now();
+		if (now - lastScan >= std::chrono::milliseconds(100)) {
+			lastScan = now;
+			std::vector<std::string> paths = LogRing::list(directory);
+			for (size_t i = 0; i < paths.size(); ++i) {
+				if (clients.count(paths[i]) != 0) {
+					continue;
+				}
+				std::unique_ptr<ClientRing> client(new ClientRing());
+				if (client->ring.attach(paths[i])) {
+					client->prefix = pidPrefix ? "[" + std::to_string(client->ring.pid()) + "] " : std::string();
+					client->droppedReported = 0;
+					client->corruptReported = 0;
+					clients[paths[i]] = std::move(client);
+				}
+			}
+		}
+
+		// 先判断是否结束再取记录，结束前写入的记录都会被取出
+		std::vector<bool> finished;
+		for (auto it = clients.begin(); it != clients.end(); ++it) {
+			finished.push_back(it->second->ring.finished());
+		}
+
+		// 按时间归并：每次写出各环队首中最早的一条，晚于 horizon 的留到下一轮等待较慢的客户端；
+		// 每轮最多 65536 条，以便及时发现新的环
+		uint64_t horizon = stopping ? UINT64_MAX : LogClock::systemNanos() - windowNanos;
+		size_t drained = 0;
+		while (drained < 65536) {
+			ClientRing* earliest = nullptr;
+			LogRingEntry first = LogRingEntry();
+			for (auto it = clients.begin(); it != clients.end(); ++it) {
+				LogRingEntry entry;
+				if (it->second->ring.peek(entry) && (earliest == nullptr || entry.nanos < first.nanos)) {
+					earliest = it->second.get();
+					first = entry;
+				}
+			}
+			if (earliest == nullptr || first.nanos > horizon) {
+				break;
+			}
+			if (first.level >= 0 && first.level <= 3) {
+				logger.writeRecord(first.nanos, static_cast<Logger::LogLevel>(first.level), earliest->prefix.data(),
+					earliest->prefix.size(), first.message, first.length);
+			}
+			earliest->ring.pop();
+			++drained;
+		}
+
+		size_t index = 0;
+		for (auto it = clients.begin(); it != clients.end(); ++index) {
+			ClientRing& client = *it->second;
+			uint64_t dropped = client.ring.dropped();
+			if (dropped != client.droppedReported) {
+				note(client, "ring full, dropped " + std::to_string(dropped - client.droppedReported) + " records");
+				client.droppedReported = dropped;
+			}
+			uint64_t corrupted = client.ring.corrupted();
+			if (corrupted != client.corruptReported) {
+				note(client, "ring corrupted, skipped its unread records");
+				client.corruptReported = corrupted;
+			}
+			if (finished[index] && client.ring.empty()) {
+				client.ring.close(true);
+				it = clients.erase(it);
+			}
+			else {
+				++it;
+			}
+		}
+
+		if (stopping && drained == 0) {
+			break;
+		}
+		// 空闲时逐步延长等待，最长 10ms
+		if (drained == 0) {
+			idleRounds = idleRounds < 10 ? idleRounds + 1 : 10;
+			std::this_thread::sleep_for(std::chrono::milliseconds(idleRounds));
+		}
+		else {
+			idleRounds = 0;
+		}
+	}
+	logger.flush();
+	return 0;
+}